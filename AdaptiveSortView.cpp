@@ -0,0 +1,235 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "AdaptiveSortView.h"
+#include "Constants.hpp"
+#include "SortAlgorithms.h"
+#include <algorithm>
+#include <array>
+#include <fmt/core.h>
+#include <functional>
+#include <string>
+
+namespace {
+    /**
+     * @brief Roughly how many frames one run should take, guessing a few operations per element and level.
+     */
+    constexpr std::size_t REPLAY_FRAMES = 600;
+    constexpr std::size_t BUFFER_CAPACITY = std::size_t{1} << 16;
+    constexpr int LABEL_FONT_SIZE = 14;
+
+    const std::vector<SDL_Color> RUN_PALETTE = {
+            SDL_Color{100, 149, 237, 255},  // Runs alternate through these four
+            SDL_Color{186, 85, 211, 255},
+            SDL_Color{72, 209, 204, 255},
+            SDL_Color{244, 164, 96, 255},
+            SDL_Color{220, 20, 60, 255},    // Heapsort fallback
+    };
+    constexpr std::uint8_t RUN_COLORS = 4;
+    constexpr std::uint8_t FALLBACK_OWNER = 4;
+
+    const char* algorithmName(AdaptiveSortView::Algorithm algorithm) {
+        switch (algorithm) {
+            case AdaptiveSortView::Algorithm::TimSort: return "timsort";
+            case AdaptiveSortView::Algorithm::PdqSort: return "pdqsort";
+            case AdaptiveSortView::Algorithm::PdqSortAdversary: return "pdqsort on its adversary";
+            case AdaptiveSortView::Algorithm::InPlaceMergeSort: return "in-place merge sort";
+            default: return "";
+        }
+    }
+
+    void runTraced(AdaptiveSortView::Algorithm algorithm, const std::vector<int>& input, SortOpBuffer& buffer) {
+        std::vector<counted<int>> values(input.begin(), input.end());
+        const std::size_t size = values.size();
+        try {
+            SortTracer tracer(values.data(), size, sizeof(counted<int>), buffer);
+            switch (algorithm) {
+                case AdaptiveSortView::Algorithm::TimSort:
+                    timSort(values.begin(), values.end(), std::less<>{}, tracer);
+                    break;
+                case AdaptiveSortView::Algorithm::InPlaceMergeSort:
+                    inPlaceMergeSort(values.begin(), values.end(), std::less<>{}, tracer);
+                    break;
+                case AdaptiveSortView::Algorithm::PdqSort:
+                case AdaptiveSortView::Algorithm::PdqSortAdversary:
+                default:
+                    pdqSort(values.begin(), values.end(), std::less<>{}, tracer);
+                    break;
+            }
+            tracer.sorted(0, size);
+        } catch (const SortTraceCancelled&) {
+            // The view restarted or closed; the half-sorted values are simply dropped.
+        }
+        buffer.finish();
+    }
+
+    /**
+     * @brief McIlroy's adversary for pdqSort: a permutation of 1 to size.
+     */
+    std::vector<int> pdqSortAdversary(std::size_t size) {
+        return quicksortAdversary(size, [](auto first, auto last, auto compare) { pdqSort(first, last, compare); });
+    }
+}
+
+AdaptiveSortView::AdaptiveSortView(const DataSpec& spec) :
+    algorithm(Algorithm::TimSort),
+    data(),
+    owners(),
+    runCount(0),
+    fallbackCount(0),
+    buffer(),
+    worker(),
+    frameOps(),
+    opsPerFrame(1),
+    bars(),
+    dataSpec(spec),
+    font(TTF_OpenFont(Constants::FONT_PATH, LABEL_FONT_SIZE)),
+    screenWidth(0) {
+    bars.setColors(SDL_Color{128, 128, 128, 255},  // Gray for elements outside any reported run
+                   SDL_Color{0, 255, 0, 255},      // Green once the sort has finished
+                   SDL_Color{255, 255, 255, 255}); // White for elements compared or moved this frame
+    bars.setOwners(&owners, RUN_PALETTE);
+    start(algorithm);
+}
+
+AdaptiveSortView::~AdaptiveSortView() {
+    stop();
+    bars.setOwners(nullptr, {});
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+void AdaptiveSortView::stop() {
+    if (buffer) {
+        buffer->cancel();
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void AdaptiveSortView::start(Algorithm newAlgorithm) {
+    stop();
+    algorithm = newAlgorithm;
+    const bool adversary = algorithm == Algorithm::PdqSortAdversary;
+    data = adversary ? pdqSortAdversary(dataSpec.size) : generateData(dataSpec);
+    bars.setMaxValue(adversary ? static_cast<int>(data.size()) : dataSpec.maxValue);
+    owners.assign(data.size(), BarRenderer::NO_OWNER);
+    runCount = 0;
+    fallbackCount = 0;
+    std::size_t levels = 1;
+    while (std::size_t{1} << levels < data.size()) ++levels;
+    opsPerFrame = std::max<std::size_t>(1, 2 * data.size() * levels / REPLAY_FRAMES);
+    buffer = std::make_unique<SortOpBuffer>(BUFFER_CAPACITY);
+    worker = std::jthread(runTraced, algorithm, data, std::ref(*buffer));
+    bars.setSortedRange(0, 0);
+    bars.invalidate();
+}
+
+void AdaptiveSortView::mark(std::size_t begin, std::size_t end, std::uint8_t owner) {
+    std::fill(owners.begin() + static_cast<std::ptrdiff_t>(begin), owners.begin() + static_cast<std::ptrdiff_t>(end),
+              owner);
+    bars.invalidate(begin, end);
+}
+
+void AdaptiveSortView::update() {
+    frameOps.resize(opsPerFrame);
+    const std::size_t count = buffer->pop(frameOps.data(), frameOps.size());
+    for (std::size_t k = 0; k < count; ++k) {
+        const SortOp& op = frameOps[k];
+        switch (op.kind) {
+            case SortOp::Kind::Compare:
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Swap:
+                std::swap(data[op.i], data[op.j]);
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Write:
+                data[op.i] = op.value;
+                bars.touch(op.i);
+                break;
+            case SortOp::Kind::Sorted:
+                // The run colors give way to the sorted color once the whole array is done.
+                mark(op.i, op.j, BarRenderer::NO_OWNER);
+                bars.setSortedRange(op.i, op.j);
+                break;
+            case SortOp::Kind::Run:
+                mark(op.i, op.j, static_cast<std::uint8_t>(runCount++ % RUN_COLORS));
+                break;
+            case SortOp::Kind::Fallback:
+                ++fallbackCount;
+                mark(op.i, op.j, FALLBACK_OWNER);
+                break;
+            case SortOp::Kind::Window:
+            default:
+                break;
+        }
+    }
+}
+
+void AdaptiveSortView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    drawLabel(renderer);
+    SDL_RenderPresent(renderer);
+}
+
+void AdaptiveSortView::drawLabel(SDL_Renderer* renderer) const {
+    if (!font) return;
+    const std::string text = fmt::format("{}  {}  runs {}  heapsort fallbacks {}", algorithmName(algorithm),
+                                         distributionName(dataSpec.distribution), runCount, fallbackCount);
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), SDL_Color{255, 255, 255, 255});
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    // Right-aligned, clear of the FPS counter and perf overlay in the top left.
+    const SDL_Rect rect = {screenWidth - surface->w - 6, 6, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
+}
+
+void AdaptiveSortView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_t:
+            start(Algorithm::TimSort);
+            break;
+        case SDLK_p:
+            start(Algorithm::PdqSort);
+            break;
+        case SDLK_k:
+            start(Algorithm::PdqSortAdversary);
+            break;
+        case SDLK_m:
+            start(Algorithm::InPlaceMergeSort);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(algorithm);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(algorithm);
+            break;
+        }
+        case SDLK_UP:
+            opsPerFrame = std::min<std::size_t>(opsPerFrame * 2, BUFFER_CAPACITY);
+            break;
+        case SDLK_DOWN:
+            opsPerFrame = std::max<std::size_t>(opsPerFrame / 2, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void AdaptiveSortView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    bars.setScreenDimensions(width, height);
+}
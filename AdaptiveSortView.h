@@ -0,0 +1,74 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_ADAPTIVESORTVIEW_H
+#define ALGOVISUALIZER_ADAPTIVESORTVIEW_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "SortInstrumentation.h"
+#include <SDL2/SDL_ttf.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Plays back TimSort, pdqsort or the in-place merge sort, traced on a worker thread like StdAlgorithmView, with
+ * the structure they find drawn into the bars.
+ *
+ * Every run the sort reports gets the next of a few alternating colors, so TimSort's natural runs show up as
+ * colored stretches that merge into ever longer ones, and pdqsort's partitions that turn out already sorted light up
+ * as they are found. A range pdqsort gives up on and heapsorts turns red. Keys: t TimSort, p pdqsort, k pdqsort on
+ * McIlroy's adversarial input for it, which forces the heapsort fallback, m the in-place merge sort, whose rotations
+ * show as blocks of bars swapping places; r restarts on new data, d switches to the next input distribution and
+ * up/down double or halve the speed.
+ */
+class AdaptiveSortView : public IRenderable {
+public:
+    enum class Algorithm { TimSort, PdqSort, PdqSortAdversary, InPlaceMergeSort };
+
+    explicit AdaptiveSortView(const DataSpec& spec);
+    AdaptiveSortView(const AdaptiveSortView&) = delete;
+    AdaptiveSortView& operator=(const AdaptiveSortView&) = delete;
+    ~AdaptiveSortView() override;
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Cancels the running sort, generates its input and starts algorithm on it.
+     */
+    void start(Algorithm algorithm);
+
+private:
+    void stop();
+    /**
+     * @brief Colors [begin, end) as owner and queues its columns for redrawing.
+     */
+    void mark(std::size_t begin, std::size_t end, std::uint8_t owner);
+    void drawLabel(SDL_Renderer* renderer) const;
+
+    Algorithm algorithm;
+    std::vector<int> data;
+    /**
+     * @brief Run color of every element, a fallback marker, or BarRenderer::NO_OWNER outside any reported range.
+     */
+    std::vector<std::uint8_t> owners;
+    std::size_t runCount;
+    std::size_t fallbackCount;
+    std::unique_ptr<SortOpBuffer> buffer;
+    /**
+     * @brief Declared after buffer so it is joined before the buffer it pushes into is freed.
+     */
+    std::jthread worker;
+    std::vector<SortOp> frameOps;
+    std::size_t opsPerFrame;
+    BarRenderer bars;
+    DataSpec dataSpec;
+    TTF_Font* font;
+    int screenWidth;
+};
+
+
+#endif //ALGOVISUALIZER_ADAPTIVESORTVIEW_H
@@ -0,0 +1,273 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "BarRenderer.h"
+#include <algorithm>
+
+namespace {
+    constexpr std::uint8_t DIRTY = 1;
+    constexpr std::uint8_t TOUCHED = 2;
+    constexpr std::uint32_t BLACK = 0xFF000000u;
+
+    std::uint32_t packColor(SDL_Color color) {
+        return BLACK | std::uint32_t{color.r} << 16 | std::uint32_t{color.g} << 8 | std::uint32_t{color.b};
+    }
+
+    std::uint32_t dim(std::uint32_t color) {
+        return BLACK | ((color >> 1) & 0x007F7F7Fu);
+    }
+}
+
+BarRenderer::BarRenderer() :
+    x_(0),
+    y_(0),
+    width_(0),
+    height_(0),
+    maxValue_(100),
+    normal_(packColor({255, 255, 255, 255})),
+    sorted_(packColor({0, 255, 0, 255})),
+    active_(packColor({255, 0, 0, 255})),
+    owners_(nullptr),
+    ownerColors_(),
+    elementCount_(0),
+    sortedBegin_(0),
+    sortedEnd_(0),
+    columnStart_(),
+    elementColumn_(),
+    columnScale_(0),
+    columns_(),
+    flags_(),
+    dirtyList_(),
+    activeList_(),
+    pixels_(),
+    textureOwner_(nullptr),
+    texture_(nullptr) {
+}
+
+BarRenderer::~BarRenderer() {
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+    }
+}
+
+void BarRenderer::setScreenDimensions(int width, int height) {
+    if (width == width_ && height == height_) return;
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    // Forces layout() and a new texture on the next frame.
+    textureOwner_ = nullptr;
+    columnStart_.clear();
+}
+
+void BarRenderer::setPosition(int x, int y) {
+    x_ = x;
+    y_ = y;
+}
+
+void BarRenderer::setMaxValue(int maxValue) {
+    maxValue_ = std::max(maxValue, 1);
+    invalidate();
+}
+
+void BarRenderer::setColors(SDL_Color normal, SDL_Color sorted, SDL_Color active) {
+    normal_ = packColor(normal);
+    sorted_ = packColor(sorted);
+    active_ = packColor(active);
+    invalidate();
+}
+
+void BarRenderer::setOwners(const std::vector<std::uint8_t>* owners, const std::vector<SDL_Color>& palette) {
+    owners_ = owners;
+    ownerColors_.clear();
+    for (const auto& color : palette) {
+        ownerColors_.push_back(packColor(color));
+    }
+    invalidate();
+}
+
+void BarRenderer::touch(std::size_t index) {
+    markElements(index, index + 1, DIRTY | TOUCHED);
+}
+
+void BarRenderer::touch(const std::vector<std::uint32_t>& indices) {
+    if (columnStart_.empty()) return;
+    if (elementCount_ < static_cast<std::size_t>(width_)) {
+        for (const auto index : indices) {
+            // Each element spans several columns here, so skip elements whose columns are already marked.
+            if (index < elementCount_ && !(flags_[elementColumn_[index]] & TOUCHED)) {
+                touch(index);
+            }
+        }
+        return;
+    }
+    // Hot path while a sort runs flat out: one multiply per index instead of a division.
+    for (const auto index : indices) {
+        if (index >= elementCount_) continue;
+        const auto column = (index * columnScale_) >> 32;
+        if (!(flags_[column] & DIRTY)) {
+            dirtyList_.push_back(static_cast<std::uint32_t>(column));
+        }
+        flags_[column] = DIRTY | TOUCHED;
+    }
+}
+
+void BarRenderer::setSortedRange(std::size_t begin, std::size_t end) {
+    if (begin == sortedBegin_ && end == sortedEnd_) return;
+    // Only elements whose membership changes need their columns redrawn.
+    markElements(std::min(begin, sortedBegin_), std::max(begin, sortedBegin_), DIRTY);
+    markElements(std::min(end, sortedEnd_), std::max(end, sortedEnd_), DIRTY);
+    sortedBegin_ = begin;
+    sortedEnd_ = end;
+}
+
+void BarRenderer::invalidate() {
+    markElements(0, elementCount_, DIRTY);
+}
+
+void BarRenderer::invalidate(std::size_t begin, std::size_t end) {
+    markElements(begin, end, DIRTY);
+}
+
+void BarRenderer::layout(std::size_t elementCount) {
+    const auto width = static_cast<std::size_t>(width_);
+    elementCount_ = elementCount;
+    columnStart_.assign(width + 1, elementCount);
+    elementColumn_.clear();
+    columnScale_ = 0;
+    if (elementCount < width) {
+        elementColumn_.resize(elementCount + 1);
+        for (std::size_t i = 0; i <= elementCount; ++i) {
+            elementColumn_[i] = (i * width + elementCount - 1) / elementCount;
+        }
+        for (std::size_t c = 0; c < width; ++c) {
+            columnStart_[c] = c * elementCount / width;
+        }
+    } else {
+        columnScale_ = (std::uint64_t{width} << 32) / elementCount;
+        for (std::size_t i = elementCount; i-- > 0;) {
+            columnStart_[(i * columnScale_) >> 32] = i;
+        }
+    }
+    columns_.assign(width, Column{height_, height_, BLACK});
+    flags_.assign(width, 0);
+    dirtyList_.clear();
+    activeList_.clear();
+    pixels_.assign(width * static_cast<std::size_t>(height_), BLACK);
+    invalidate();
+}
+
+void BarRenderer::markElements(std::size_t begin, std::size_t end, std::uint8_t flags) {
+    end = std::min(end, elementCount_);
+    if (begin >= end || columnStart_.empty()) return;
+    std::size_t first;
+    std::size_t last;
+    if (elementColumn_.empty()) {
+        first = (begin * columnScale_) >> 32;
+        last = ((end - 1) * columnScale_ >> 32) + 1;
+    } else {
+        first = elementColumn_[begin];
+        last = elementColumn_[end];
+    }
+    for (std::size_t c = first; c < last; ++c) {
+        if (!(flags_[c] & DIRTY)) {
+            dirtyList_.push_back(static_cast<std::uint32_t>(c));
+        }
+        flags_[c] = static_cast<std::uint8_t>(flags_[c] | flags);
+    }
+}
+
+int BarRenderer::barHeight(int value) const {
+    return static_cast<int>(std::int64_t{std::clamp(value, 0, maxValue_)} * height_ / maxValue_);
+}
+
+void BarRenderer::updateColumn(std::size_t column, const std::vector<int>& values) {
+    const auto width = static_cast<std::size_t>(width_);
+    const std::size_t begin = columnStart_[column];
+    const std::size_t end = std::min(std::max(begin + 1, columnStart_[column + 1]), elementCount_);
+    // Elements wider than four pixels keep a one-pixel gap on their right, like the old per-element bars.
+    const bool gap = width >= 4 * elementCount_ && (column + 1 == width || columnStart_[column + 1] != begin);
+    if (gap || begin >= end) {
+        columns_[column] = Column{height_, height_, BLACK};
+        return;
+    }
+
+    // Plain min/max rather than std::minmax_element: branch-free, so it vectorizes over wide columns.
+    int low = values[begin];
+    int high = values[begin];
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+    std::uint32_t color = normal_;
+    if (flags_[column] & TOUCHED) {
+        color = active_;
+        activeList_.push_back(static_cast<std::uint32_t>(column));
+    } else if (owners_ && !ownerColors_.empty() && begin < owners_->size() && (*owners_)[begin] != NO_OWNER) {
+        color = ownerColors_[(*owners_)[begin] % ownerColors_.size()];
+    } else if (begin >= sortedBegin_ && end <= sortedEnd_) {
+        color = sorted_;
+    }
+    columns_[column] = Column{height_ - barHeight(low), height_ - barHeight(high), color};
+}
+
+void BarRenderer::render(SDL_Renderer* renderer, const std::vector<int>& values) {
+    if (width_ == 0 || height_ == 0 || values.empty()) return;
+    if (values.size() != elementCount_ || columnStart_.empty()) {
+        layout(values.size());
+    }
+    if (textureOwner_ != renderer) {
+        // The previous renderer is still alive, as render() requires, so its texture is ours to destroy.
+        if (texture_) {
+            SDL_DestroyTexture(texture_);
+        }
+        texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width_, height_);
+        textureOwner_ = renderer;
+        invalidate();
+    }
+
+    // Last frame's highlights fade back to their normal color.
+    for (const auto column : activeList_) {
+        if (!(flags_[column] & DIRTY)) {
+            flags_[column] |= DIRTY;
+            dirtyList_.push_back(column);
+        }
+    }
+    activeList_.clear();
+    // The bars keep their own size, so a view can draw other things beside them.
+    const SDL_Rect target = {x_, y_, width_, height_};
+    if (dirtyList_.empty()) {
+        SDL_RenderCopy(renderer, texture_, nullptr, &target);
+        return;
+    }
+
+    std::size_t firstColumn = static_cast<std::size_t>(width_);
+    std::size_t lastColumn = 0;
+    for (const auto column : dirtyList_) {
+        updateColumn(column, values);
+        flags_[column] = 0;
+        firstColumn = std::min<std::size_t>(firstColumn, column);
+        lastColumn = std::max<std::size_t>(lastColumn, column);
+    }
+    dirtyList_.clear();
+
+    // Rasterize the dirty span row by row so writes stay sequential; clean columns inside it are simply redrawn
+    // from their stored descriptors.
+    const auto width = static_cast<std::size_t>(width_);
+    for (int y = 0; y < height_; ++y) {
+        std::uint32_t* row = pixels_.data() + static_cast<std::size_t>(y) * width;
+        for (std::size_t c = firstColumn; c <= lastColumn; ++c) {
+            const Column& column = columns_[c];
+            row[c] = y >= column.solidTop ? column.color : y >= column.spreadTop ? dim(column.color) : BLACK;
+        }
+    }
+
+    if (texture_) {
+        const SDL_Rect rect = {static_cast<int>(firstColumn), 0, static_cast<int>(lastColumn - firstColumn + 1), height_};
+        SDL_UpdateTexture(texture_, &rect, pixels_.data() + firstColumn, width_ * static_cast<int>(sizeof(std::uint32_t)));
+    }
+    SDL_RenderCopy(renderer, texture_, nullptr, &target);
+}
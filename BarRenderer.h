@@ -0,0 +1,133 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_BARRENDERER_H
+#define ALGOVISUALIZER_BARRENDERER_H
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Draws an array as bars by folding its elements into one column per pixel.
+ *
+ * Every pixel column covers a contiguous range of elements and is drawn from the range's minimum and maximum: solid
+ * up to the minimum, dimmed up to the maximum. Columns are rasterized into a CPU-side buffer and uploaded to a
+ * streaming texture, and only columns touched since the last frame are recomputed, so the cost of a frame follows the
+ * number of changed elements rather than the array size. When the array is smaller than the window each element
+ * gets several columns and, if wide enough, a gap to its neighbour.
+ */
+class BarRenderer {
+public:
+    BarRenderer();
+    ~BarRenderer();
+    BarRenderer(const BarRenderer&) = delete;
+    BarRenderer& operator=(const BarRenderer&) = delete;
+
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Top-left corner the bars are drawn at, so several renderers can share one window.
+     */
+    void setPosition(int x, int y);
+    /**
+     * @brief Value drawn at full height; larger values are clipped.
+     */
+    void setMaxValue(int maxValue);
+    /**
+     * @brief Colors for unsorted bars, bars inside the sorted range and bars touched in the last frame.
+     */
+    void setColors(SDL_Color normal, SDL_Color sorted, SDL_Color active);
+    /**
+     * @brief Marks an element as changed or inspected; its column is redrawn highlighted on the next frame.
+     */
+    void touch(std::size_t index);
+    void touch(const std::vector<std::uint32_t>& indices);
+    /**
+     * @brief Sets the range drawn in the sorted color; only columns entering or leaving it are redrawn.
+     */
+    void setSortedRange(std::size_t begin, std::size_t end);
+    /**
+     * @brief Colors every element by owner: element i is drawn in palette[owners[i] % palette.size()], unless its
+     * owner is NO_OWNER. owners must outlive the renderer or be reset with nullptr.
+     */
+    void setOwners(const std::vector<std::uint8_t>* owners, const std::vector<SDL_Color>& palette);
+    /**
+     * @brief Forces every column to be recomputed, e.g. after the array was replaced wholesale.
+     */
+    void invalidate();
+    /**
+     * @brief Redraws the columns covering elements [begin, end) without highlighting them.
+     */
+    void invalidate(std::size_t begin, std::size_t end);
+
+    static constexpr std::uint8_t NO_OWNER = 0xFF;
+    /**
+     * @brief Recomputes dirty columns from values, uploads them and copies the texture to the renderer.
+     *
+     * The texture is created on renderer and destroyed with these bars or when they are drawn to another renderer,
+     * so every renderer they were drawn to must outlive them.
+     */
+    void render(SDL_Renderer* renderer, const std::vector<int>& values);
+
+private:
+    /**
+     * @brief What one pixel column shows: rows from solidTop down are drawn in color, rows from spreadTop in its
+     * dimmed form.
+     */
+    struct Column {
+        int solidTop;
+        int spreadTop;
+        std::uint32_t color;
+    };
+
+    void layout(std::size_t elementCount);
+    /**
+     * @brief Queues the columns covering elements [begin, end) for redrawing, optionally as touched.
+     */
+    void markElements(std::size_t begin, std::size_t end, std::uint8_t flags);
+    void updateColumn(std::size_t column, const std::vector<int>& values);
+    /**
+     * @brief Height in pixels of a bar for value, computed in 64 bits so values up to INT_MAX do not overflow.
+     */
+    [[nodiscard]] int barHeight(int value) const;
+
+    int x_;
+    int y_;
+    int width_;
+    int height_;
+    int maxValue_;
+    std::uint32_t normal_;
+    std::uint32_t sorted_;
+    std::uint32_t active_;
+    const std::vector<std::uint8_t>* owners_;
+    std::vector<std::uint32_t> ownerColors_;
+    std::size_t elementCount_;
+    std::size_t sortedBegin_;
+    std::size_t sortedEnd_;
+    /**
+     * @brief First element of each column plus a final entry equal to the element count.
+     */
+    std::vector<std::size_t> columnStart_;
+    /**
+     * @brief With fewer elements than columns: first column of each element plus a final entry equal to the width.
+     */
+    std::vector<std::size_t> elementColumn_;
+    /**
+     * @brief With at least as many elements as columns: column of element i is (i * columnScale_) >> 32.
+     */
+    std::uint64_t columnScale_;
+    std::vector<Column> columns_;
+    std::vector<std::uint8_t> flags_;
+    std::vector<std::uint32_t> dirtyList_;
+    /**
+     * @brief Columns drawn highlighted last frame; they are redrawn once more to drop the highlight.
+     */
+    std::vector<std::uint32_t> activeList_;
+    std::vector<std::uint32_t> pixels_;
+    SDL_Renderer* textureOwner_;
+    SDL_Texture* texture_;
+};
+
+
+#endif //ALGOVISUALIZER_BARRENDERER_H
@@ -0,0 +1,105 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_BOUNDEDQUEUE_H
+#define ALGOVISUALIZER_BOUNDEDQUEUE_H
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue.
+ *
+ * A ring of slots, each carrying a sequence number that tells producers and consumers whose turn it is
+ * (Vyukov's bounded MPMC queue). tryPush and tryPop never block; callers decide whether to spin, yield or
+ * do other work when the queue is full or empty. The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) :
+            capacity_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+            slots_(std::make_unique<Slot[]>(capacity_)),
+            enqueuePos_(0),
+            dequeuePos_(0) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Moves value into the queue.
+     * @return false if the queue is full, in which case value is left untouched.
+     */
+    bool tryPush(T& value) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & (capacity_ - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < pos) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    /**
+     * @brief Moves the oldest element out of the queue.
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & (capacity_ - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == pos + 1) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < pos + 1) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    /**
+     * @brief Number of queued elements; only a snapshot while other threads are pushing or popping.
+     */
+    [[nodiscard]] std::size_t size() const {
+        const std::size_t dequeued = dequeuePos_.load(std::memory_order_relaxed);
+        const std::size_t enqueued = enqueuePos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    std::size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    /**
+     * @brief Producer and consumer positions live on separate cache lines so they do not false-share.
+     */
+    alignas(64) std::atomic<std::size_t> enqueuePos_;
+    alignas(64) std::atomic<std::size_t> dequeuePos_;
+};
+
+
+#endif //ALGOVISUALIZER_BOUNDEDQUEUE_H
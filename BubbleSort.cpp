@@ -3,22 +3,22 @@
     //
     #include "BubbleSort.h"
     #include "Constants.hpp"
+    #include "SortRoutines.h"
     #include <algorithm>
-    #include <cstdlib>
-    #include <ctime>
     #include <iostream>
+    #include <limits>
 
-    BubbleSort::BubbleSort(int dataSize) :
-        data(),
-        currentIdx(0),
+    BubbleSort::BubbleSort(const DataSpec& spec) :
+        data(generateData(spec)),
+        engine(),
+        bars(),
+        opsPerFrame(std::numeric_limits<std::size_t>::max()),
+        frameBudget(std::chrono::milliseconds(4)),
         sorting(false),
-        dataSize_(dataSize),
+        dataSize_(static_cast<int>(spec.size)),
         screenWidth(0),
         screenHeight(0),
-        comparisonIdx(-1),
-        swappedInLastPass(false),
         sortedCount(0),
-        lastSwapIndex(dataSize-1),
         swapCount(0),
         comparisonCount(0),
         greenIterationStarted(false),
@@ -26,18 +26,14 @@
         iterationCount(0),
         isComplete(false)
         {
-        srand(static_cast<unsigned>(time(nullptr)));
 //        std::cout << "Constructor: dataSize_ = " << dataSize_ << ", screenWidth = " << screenWidth << ", screenHeight = " << screenHeight << std::endl;
-        for(int i = 0; i < dataSize; i++){
-            int val = (rand() % 99) + 1;
-            data.push_back(val);
-//            std::cout << "Data[" << i << "] = " << val << std::endl;
-        }
+        bars.setMaxValue(spec.maxValue);
     }
     void BubbleSort::update() {
         if(isComplete) return;
         if (!sorting && !greenIterationStarted && !whiteIterationStarted) {
             greenIterationStarted = true;
+            bars.setSortedRange(0, data.size());
         }
         if (greenIterationStarted) {
             iterationCount++;
@@ -45,6 +41,7 @@
                 greenIterationStarted = false;
                 whiteIterationStarted = true;
                 iterationCount = 0;
+                bars.setSortedRange(0, 0);
                 return;
             }
         }
@@ -54,68 +51,42 @@
                 whiteIterationStarted = false;
                 iterationCount = 0;
                 isComplete = true;
+                bars.setSortedRange(0, 0);
                 return;
             }
         }
         if (sorting) {
-            if (currentIdx < dataSize_ - sortedCount - 1) {
-                comparisonIdx = currentIdx;
-                comparisonCount++;
-                if (data[static_cast<size_t>(currentIdx + 1)] < data[static_cast<size_t>(currentIdx)]) {
-                    std::swap(data[static_cast<size_t>(currentIdx + 1)], data[static_cast<size_t>(currentIdx)]);
-                    swappedInLastPass = true;
-                    lastSwapIndex = currentIdx;
-                    swapCount++;
-                }
-                currentIdx++;
-            } else {
-                if (swappedInLastPass) {
-                    swappedInLastPass = false;
-                    currentIdx = 0;
-                    sortedCount++;
-                } else {
-                    sorting = false;
-                    comparisonIdx = -1;
-                }
+            engine.run(opsPerFrame, frameBudget);
+            bars.touch(engine.touched());
+            bars.setSortedRange(engine.sortedBegin(), engine.sortedEnd());
+            sortedCount = static_cast<int>(engine.sortedEnd() - engine.sortedBegin());
+            swapCount = engine.swaps();
+            comparisonCount = engine.comparisons();
+            if (!engine.running()) {
+                sorting = false;
             }
         }
     }
     void BubbleSort::render(SDL_Renderer* renderer) {
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
-        int barWidth = (screenWidth * 2) / (dataSize_ * 2) - 2;
-        for (int i = 0; i < dataSize_; ++i) {
-            int barHeight = data[static_cast<unsigned long>(i)] * (screenHeight / 100);
-            int barTop = screenHeight - barHeight;
-
-            if(isComplete){
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            }
-            else if (greenIterationStarted && !whiteIterationStarted) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-            } else if (whiteIterationStarted && !greenIterationStarted) {
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            } else {
-                if (i == comparisonIdx || i == comparisonIdx + 1) {
-                    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                } else if (i >= dataSize_ - sortedCount) {
-                    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                } else {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                }
-            }
-            SDL_Rect rect = {i * (barWidth + 2), barTop, barWidth, barHeight};
-            SDL_RenderFillRect(renderer, &rect);
-        }
+        bars.render(renderer, data);
         SDL_RenderPresent(renderer);
     }
     void BubbleSort::startSort() {
         sorting = true;
-        currentIdx = 0;
+        engine.start(bubbleSortRoutine(data));
 //        std::cout << "Started sorting." << std::endl;
     }
     void BubbleSort::setScreenDimensions(int width, int height){
         screenWidth = width;
         screenHeight = height;
+        bars.setScreenDimensions(width, height);
 //        std::cout << "Set Screen Dimensions: screenWidth = " << screenWidth << ", screenHeight = " << screenHeight << std::endl;
+    }
+    void BubbleSort::setOpsPerFrame(std::size_t ops) {
+        opsPerFrame = ops;
+    }
+    void BubbleSort::setFrameBudget(std::chrono::microseconds budget) {
+        frameBudget = budget;
     }
\ No newline at end of file
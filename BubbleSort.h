@@ -4,27 +4,36 @@
 
 #ifndef ALGOVISUALIZER_BUBBLESORT_H
 #define ALGOVISUALIZER_BUBBLESORT_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
 #include "IRenderable.hpp"
+#include "SortEngine.h"
+#include <chrono>
 #include <vector>
 class BubbleSort : public IRenderable{
 public:
-    BubbleSort(int dataSize);
+    explicit BubbleSort(const DataSpec& spec);
     void update() override;
     void render(SDL_Renderer* renderer) override;
     void startSort();
     void setScreenDimensions(int width, int height);
+    /**
+     * @brief Upper bound on sort steps per frame, unbounded by default; fewer are run once the frame budget runs out.
+     */
+    void setOpsPerFrame(std::size_t ops);
+    void setFrameBudget(std::chrono::microseconds budget);
 
 private:
     std::vector<int> data;
-    int currentIdx;
+    SortEngine engine;
+    BarRenderer bars;
+    std::size_t opsPerFrame;
+    std::chrono::microseconds frameBudget;
     bool sorting;
     int dataSize_;
     int screenWidth;
     int screenHeight;
-    int comparisonIdx;
-    bool swappedInLastPass;
     int sortedCount;
-    int lastSwapIndex;
     unsigned long long swapCount;
     unsigned long long comparisonCount;
 
@@ -0,0 +1,88 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "CacheSimulator.h"
+#include <algorithm>
+#include <bit>
+#include <fmt/core.h>
+#include <stdexcept>
+
+CacheSimulator::CacheSimulator(std::vector<CacheLevelConfig> levels) :
+    levels_() {
+    if (levels.empty()) {
+        throw std::invalid_argument("A cache hierarchy needs at least one level");
+    }
+    levels_.reserve(levels.size());
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const CacheLevelConfig& config = levels[i];
+        const std::size_t setBytes = config.lineBytes * config.ways;
+        const bool valid = std::has_single_bit(config.lineBytes) && config.ways > 0 && config.sizeBytes % setBytes == 0 &&
+                           std::has_single_bit(config.sizeBytes / setBytes);
+        if (!valid) {
+            throw std::invalid_argument(fmt::format(
+                    "Cache level L{} of {} bytes with {}-byte lines and {} ways does not have a power of two sets",
+                    i + 1, config.sizeBytes, config.lineBytes, config.ways));
+        }
+        const std::size_t sets = config.sizeBytes / setBytes;
+        levels_.push_back(Level{config, static_cast<unsigned>(std::countr_zero(config.lineBytes)), sets - 1,
+                                config.ways, std::vector<std::uint64_t>(sets * config.ways, EMPTY), 0, 0});
+    }
+}
+
+bool CacheSimulator::lookup(Level& level, std::uint64_t address) {
+    ++level.lookups;
+    const std::uint64_t line = address >> level.lineShift;
+    std::uint64_t* set = level.tags.data() + (line & level.setMask) * level.ways;
+    if (set[0] == line) {
+        ++level.hits;
+        return true;
+    }
+    // On a hit the line moves to the front; on a miss the least recently used line falls off the end.
+    std::size_t way = level.ways - 1;
+    bool hit = false;
+    for (std::size_t k = 1; k < level.ways; ++k) {
+        const bool match = set[k] == line;
+        way = match ? k : way;
+        hit |= match;
+    }
+    std::copy_backward(set, set + way, set + way + 1);
+    set[0] = line;
+    level.hits += hit;
+    return hit;
+}
+
+unsigned CacheSimulator::access(std::uint64_t address) {
+    unsigned level = 0;
+    while (level < levels_.size() && !lookup(levels_[level], address)) {
+        ++level;
+    }
+    return level;
+}
+
+void CacheSimulator::access(std::span<const std::uint64_t> addresses, std::span<std::uint8_t> outcomes) {
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        outcomes[i] = static_cast<std::uint8_t>(access(addresses[i]));
+    }
+}
+
+void CacheSimulator::reset() {
+    for (Level& level : levels_) {
+        std::fill(level.tags.begin(), level.tags.end(), EMPTY);
+        level.lookups = 0;
+        level.hits = 0;
+    }
+}
+
+double CacheSimulator::hitRate(unsigned level) const {
+    const Level& l = levels_[level];
+    return l.lookups == 0 ? 0.0 : static_cast<double>(l.hits) / static_cast<double>(l.lookups);
+}
+
+std::string CacheSimulator::describe(unsigned level) const {
+    const CacheLevelConfig& config = levels_[level].config;
+    const std::string size = config.sizeBytes >= 1024 * 1024 && config.sizeBytes % (1024 * 1024) == 0
+                                     ? fmt::format("{} MiB", config.sizeBytes / (1024 * 1024))
+                             : config.sizeBytes >= 1024 ? fmt::format("{} KiB", config.sizeBytes / 1024)
+                                                        : fmt::format("{} B", config.sizeBytes);
+    return fmt::format("L{} {} {}-way", level + 1, size, config.ways);
+}
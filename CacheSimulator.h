@@ -0,0 +1,95 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_CACHESIMULATOR_H
+#define ALGOVISUALIZER_CACHESIMULATOR_H
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Geometry of one cache level. Line size and the resulting number of sets must be powers of two.
+ */
+struct CacheLevelConfig {
+    std::size_t sizeBytes = 32 * 1024;
+    std::size_t lineBytes = 64;
+    std::size_t ways = 8;
+};
+
+/**
+ * @brief Set-associative cache hierarchy with LRU replacement, driven by a stream of byte addresses.
+ *
+ * An access looks up the levels in order and stops at the first that holds the line; every level it missed in
+ * then takes the line in. Evictions are not written back to the next level, so the levels are neither strictly
+ * inclusive nor exclusive, which is close enough to show locality. Each set keeps its tags ordered from most to
+ * least recently used in one contiguous row, so a hit on the most recent line is one compare, and a lookup never
+ * allocates: the simulator handles tens of millions of accesses per second.
+ */
+class CacheSimulator {
+public:
+    /**
+     * @throws std::invalid_argument if there are no levels or a level's geometry is not a power of two.
+     */
+    explicit CacheSimulator(std::vector<CacheLevelConfig> levels);
+
+    /**
+     * @brief Simulates one access.
+     * @return Index of the level that hit, or levels() if the access went to memory.
+     */
+    unsigned access(std::uint64_t address);
+    /**
+     * @brief Simulates every address in order and stores the outcome of each, as access() returns it.
+     */
+    void access(std::span<const std::uint64_t> addresses, std::span<std::uint8_t> outcomes);
+    /**
+     * @brief Empties every level and zeroes the statistics.
+     */
+    void reset();
+
+    [[nodiscard]] unsigned levels() const { return static_cast<unsigned>(levels_.size()); }
+    [[nodiscard]] const CacheLevelConfig& config(unsigned level) const { return levels_[level].config; }
+    /**
+     * @brief Accesses that reached level, i.e. missed in every level before it.
+     */
+    [[nodiscard]] std::uint64_t lookups(unsigned level) const { return levels_[level].lookups; }
+    [[nodiscard]] std::uint64_t hits(unsigned level) const { return levels_[level].hits; }
+    /**
+     * @brief Hits over lookups of level, or 0 before the first lookup.
+     */
+    [[nodiscard]] double hitRate(unsigned level) const;
+    /**
+     * @brief Such as "L1 32 KiB 8-way".
+     */
+    [[nodiscard]] std::string describe(unsigned level) const;
+
+private:
+    struct Level {
+        CacheLevelConfig config;
+        unsigned lineShift;
+        std::uint64_t setMask;
+        std::size_t ways;
+        /**
+         * @brief Line addresses, ways per set, most recently used first; EMPTY where nothing is cached.
+         */
+        std::vector<std::uint64_t> tags;
+        std::uint64_t lookups;
+        std::uint64_t hits;
+    };
+
+    static constexpr std::uint64_t EMPTY = ~std::uint64_t{0};
+
+    /**
+     * @brief Looks the line of address up in level and makes it the most recently used of its set, inserting it
+     * on a miss.
+     * @return Whether it was there.
+     */
+    static bool lookup(Level& level, std::uint64_t address);
+
+    std::vector<Level> levels_;
+};
+
+
+#endif //ALGOVISUALIZER_CACHESIMULATOR_H
@@ -0,0 +1,260 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "CacheView.h"
+#include "Constants.hpp"
+#include "SortRoutines.h"
+#include <algorithm>
+#include <array>
+#include <fmt/core.h>
+#include <span>
+#include <string>
+
+namespace {
+    constexpr int MAZE_ROWS = 128;
+    constexpr int MAZE_COLS = 128;
+    constexpr std::size_t SORT_OPS_PER_FRAME = 2048;
+    constexpr std::size_t SEARCH_CELLS_PER_FRAME = 16;
+    constexpr int STATS_FONT_SIZE = 14;
+    constexpr int STATS_MARGIN = 6;
+
+    constexpr std::array<SDL_Color, 3> LEVEL_COLORS = {
+            SDL_Color{0, 200, 0, 255},    // L1
+            SDL_Color{230, 220, 0, 255},  // L2
+            SDL_Color{255, 140, 0, 255},  // Any further level
+    };
+    constexpr SDL_Color MEMORY_COLOR = {220, 30, 30, 255};
+    constexpr SDL_Color UNVISITED_COLOR = {45, 45, 45, 255};
+
+    const char* modeName(CacheView::Mode mode) {
+        switch (mode) {
+            case CacheView::Mode::Bubble: return "bubble sort";
+            case CacheView::Mode::Insertion: return "insertion sort";
+            case CacheView::Mode::Bitonic: return "bitonic sort";
+            case CacheView::Mode::MazeSearch: return "maze BFS";
+            default: return "";
+        }
+    }
+}
+
+CacheView::CacheView(const DataSpec& spec, std::vector<CacheLevelConfig> levels) :
+    dataSpec(spec),
+    mode(Mode::Bubble),
+    cache(std::move(levels)),
+    data(),
+    engine(),
+    bars(),
+    maze(),
+    outcomes(),
+    palette(),
+    addresses(),
+    results(),
+    frontier(),
+    frontierHead(0),
+    discovered(),
+    speed(1.0),
+    font(TTF_OpenFont(Constants::FONT_PATH, STATS_FONT_SIZE)),
+    screenWidth(0),
+    screenHeight(0) {
+    for (unsigned level = 0; level < cache.levels(); ++level) {
+        palette.push_back(LEVEL_COLORS[std::min<std::size_t>(level, LEVEL_COLORS.size() - 1)]);
+    }
+    palette.push_back(MEMORY_COLOR);
+    bars.setMaxValue(spec.maxValue);
+    bars.setOwners(&outcomes, palette);
+    start(mode);
+}
+
+CacheView::~CacheView() {
+    bars.setOwners(nullptr, {});
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+void CacheView::start(Mode newMode) {
+    mode = newMode;
+    cache.reset();
+    if (mode == Mode::MazeSearch) {
+        maze = std::make_unique<Maze>(MAZE_ROWS, MAZE_COLS, dataSpec.seed);
+        const std::size_t cells = maze->getCells().size();
+        outcomes.assign(cells, BarRenderer::NO_OWNER);
+        discovered.assign(cells, 0);
+        frontier.clear();
+        frontier.reserve(cells);
+        frontier.push_back(0);
+        discovered[0] = 1;
+        frontierHead = 0;
+        return;
+    }
+    data = generateData(dataSpec);
+    outcomes.assign(data.size(), BarRenderer::NO_OWNER);
+    switch (mode) {
+        case Mode::Bubble:
+            engine.start(bubbleSortRoutine(data));
+            break;
+        case Mode::Insertion:
+            engine.start(insertionSortRoutine(data));
+            break;
+        case Mode::Bitonic:
+            engine.start(bitonicSortRoutine(data));
+            break;
+        case Mode::MazeSearch:
+        default:
+            break;
+    }
+    bars.invalidate();
+}
+
+void CacheView::update() {
+    if (mode == Mode::MazeSearch) {
+        stepSearch();
+    } else {
+        stepSort();
+    }
+}
+
+void CacheView::stepSort() {
+    if (!engine.running()) return;
+    const auto ops = std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(SORT_OPS_PER_FRAME) * speed));
+    engine.run(ops, std::chrono::milliseconds(4));
+    const std::vector<std::uint32_t>& touched = engine.touched();
+    addresses.resize(touched.size());
+    results.resize(touched.size());
+    std::transform(touched.begin(), touched.end(), addresses.begin(),
+                   [](std::uint32_t index) { return std::uint64_t{index} * sizeof(int); });
+    cache.access(addresses, results);
+    for (std::size_t i = 0; i < touched.size(); ++i) {
+        outcomes[touched[i]] = results[i];
+        bars.invalidate(touched[i], touched[i] + std::size_t{1});
+    }
+}
+
+void CacheView::stepSearch() {
+    const std::vector<std::uint8_t>& cells = maze->getCells();
+    const auto cols = static_cast<std::size_t>(maze->getCols());
+    // The visited bytes follow the wall bytes in memory.
+    const std::uint64_t visitedBase = cells.size();
+    const auto budget = std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(SEARCH_CELLS_PER_FRAME) * speed));
+    for (std::size_t step = 0; step < budget && frontierHead < frontier.size(); ++step) {
+        const std::uint32_t cell = frontier[frontierHead++];
+        outcomes[cell] = static_cast<std::uint8_t>(cache.access(cell));
+        const std::uint8_t walls = cells[cell];
+        const std::array<std::pair<std::uint8_t, std::uint32_t>, 4> neighbours = {{
+                {Maze::TOP_WALL, static_cast<std::uint32_t>(cell - cols)},
+                {Maze::RIGHT_WALL, cell + 1},
+                {Maze::BOTTOM_WALL, static_cast<std::uint32_t>(cell + cols)},
+                {Maze::LEFT_WALL, cell - 1},
+        }};
+        // Border cells keep their outer walls, so an open side always leads to a cell inside the maze.
+        for (const auto& [wall, next] : neighbours) {
+            if (walls & wall) continue;
+            cache.access(visitedBase + next);
+            if (!discovered[next]) {
+                discovered[next] = 1;
+                frontier.push_back(next);
+            }
+        }
+    }
+}
+
+void CacheView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    if (mode == Mode::MazeSearch) {
+        drawMaze(renderer);
+    } else {
+        bars.render(renderer, data);
+    }
+    drawStats(renderer);
+    SDL_RenderPresent(renderer);
+}
+
+void CacheView::drawMaze(SDL_Renderer* renderer) const {
+    const int cellSize = std::max(1, std::min(screenWidth / MAZE_COLS, screenHeight / MAZE_ROWS));
+    const int left = (screenWidth - cellSize * MAZE_COLS) / 2;
+    const int top = (screenHeight - cellSize * MAZE_ROWS) / 2;
+    const int gap = cellSize > 3 ? 1 : 0;
+    // One batch per color: unvisited cells, then one per outcome.
+    std::vector<std::vector<SDL_Rect>> batches(palette.size() + 1);
+    for (std::size_t cell = 0; cell < outcomes.size(); ++cell) {
+        const int row = static_cast<int>(cell / MAZE_COLS);
+        const int col = static_cast<int>(cell % MAZE_COLS);
+        const std::size_t batch = outcomes[cell] == BarRenderer::NO_OWNER ? 0 : std::size_t{outcomes[cell]} + 1;
+        batches[batch].push_back({left + col * cellSize, top + row * cellSize, cellSize - gap, cellSize - gap});
+    }
+    for (std::size_t batch = 0; batch < batches.size(); ++batch) {
+        const SDL_Color color = batch == 0 ? UNVISITED_COLOR : palette[batch - 1];
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(renderer, batches[batch].data(), static_cast<int>(batches[batch].size()));
+    }
+}
+
+void CacheView::drawStats(SDL_Renderer* renderer) const {
+    if (!font) return;
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("{}, {} accesses", modeName(mode), cache.lookups(0)));
+    for (unsigned level = 0; level < cache.levels(); ++level) {
+        lines.push_back(fmt::format("{}: {:.1f}% hits of {}", cache.describe(level), cache.hitRate(level) * 100.0,
+                                    cache.lookups(level)));
+    }
+    const unsigned last = cache.levels() - 1;
+    const std::uint64_t toMemory = cache.lookups(last) - cache.hits(last);
+    lines.push_back(fmt::format("memory: {} accesses, {:.1f}%", toMemory,
+                                cache.lookups(0) == 0 ? 0.0 : static_cast<double>(toMemory) * 100.0 /
+                                                                   static_cast<double>(cache.lookups(0))));
+    int y = STATS_MARGIN;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        const SDL_Color color = i == 0 ? SDL_Color{255, 255, 255, 255} : palette[i - 1];
+        SDL_Surface* surface = TTF_RenderText_Blended(font, lines[i].c_str(), color);
+        if (!surface) continue;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        const SDL_Rect rect = {screenWidth - surface->w - STATS_MARGIN, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &rect);
+        y += surface->h;
+        SDL_FreeSurface(surface);
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void CacheView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_b:
+            start(Mode::Bubble);
+            break;
+        case SDLK_i:
+            start(Mode::Insertion);
+            break;
+        case SDLK_t:
+            start(Mode::Bitonic);
+            break;
+        case SDLK_m:
+            start(Mode::MazeSearch);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(mode);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(mode);
+            break;
+        }
+        case SDLK_UP:
+            speed *= 2.0;
+            break;
+        case SDLK_DOWN:
+            speed = std::max(1.0 / 64.0, speed / 2.0);
+            break;
+        default:
+            break;
+    }
+}
+
+void CacheView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    bars.setScreenDimensions(width, height);
+}
@@ -0,0 +1,92 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_CACHEVIEW_H
+#define ALGOVISUALIZER_CACHEVIEW_H
+#include "BarRenderer.h"
+#include "CacheSimulator.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "Maze.hpp"
+#include "SortEngine.h"
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Runs a sort or a maze search through a simulated cache hierarchy and colors every element by where its
+ * last access hit.
+ *
+ * In the sort modes each index the SortEngine reports as compared, swapped or written is one access to an int
+ * array; in the search mode a breadth-first search reads the wall byte of every cell it dequeues and the visited
+ * byte of every open neighbour, the two arrays laid out one after the other. Elements are drawn green when the last
+ * access hit L1, yellow for L2, orange for further levels and red when it went to memory, and the hit rate of every
+ * level is shown in the corner.
+ *
+ * Keys: b, i and t run bubble, insertion and bitonic sort, m runs the maze search, r restarts on new data, d
+ * switches to the next input distribution and up/down double or halve the speed.
+ */
+class CacheView : public IRenderable {
+public:
+    enum class Mode { Bubble, Insertion, Bitonic, MazeSearch };
+
+    /**
+     * @throws std::invalid_argument if the cache levels do not form a valid CacheSimulator.
+     */
+    CacheView(const DataSpec& spec, std::vector<CacheLevelConfig> levels);
+    CacheView(const CacheView&) = delete;
+    CacheView& operator=(const CacheView&) = delete;
+    ~CacheView() override;
+
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Empties the cache and runs mode from the start on the data or maze of the current seed.
+     */
+    void start(Mode newMode);
+
+private:
+    /**
+     * @brief Runs the sort for one frame and feeds the indices it touched to the cache.
+     */
+    void stepSort();
+    /**
+     * @brief Dequeues the next cells of the search, feeding their reads to the cache.
+     */
+    void stepSearch();
+    void drawMaze(SDL_Renderer* renderer) const;
+    void drawStats(SDL_Renderer* renderer) const;
+
+    DataSpec dataSpec;
+    Mode mode;
+    CacheSimulator cache;
+    std::vector<int> data;
+    SortEngine engine;
+    BarRenderer bars;
+    std::unique_ptr<Maze> maze;
+    /**
+     * @brief Outcome of the last access to each element or cell, as CacheSimulator::access returns it, or
+     * BarRenderer::NO_OWNER before the first.
+     */
+    std::vector<std::uint8_t> outcomes;
+    std::vector<SDL_Color> palette;
+    std::vector<std::uint64_t> addresses;
+    std::vector<std::uint8_t> results;
+    /**
+     * @brief Search queue, read from frontierHead on, and whether each cell has been queued.
+     */
+    std::vector<std::uint32_t> frontier;
+    std::size_t frontierHead;
+    std::vector<std::uint8_t> discovered;
+    double speed;
+    TTF_Font* font;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_CACHEVIEW_H
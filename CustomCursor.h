@@ -7,6 +7,8 @@
 
 
 #include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
 
 void createAndSetCustomCursor();
 void createAndSetCustomCursor() {
@@ -14,30 +16,24 @@ void createAndSetCustomCursor() {
     const int center = cursorSize / 2;
     const int radius = center - 50; // Radius of the circle
 
-    Uint8 cursorData[cursorSize * cursorSize];
-    Uint8 cursorMask[cursorSize * cursorSize];
-
-    // Initialize cursor data and mask
-    memset(cursorData, 0, sizeof(cursorData));
-    memset(cursorMask, 0, sizeof(cursorMask));
-
-    // Create a circle
-    for (int y = 0; y < cursorSize; ++y) {
-        for (int x = 0; x < cursorSize; ++x) {
-            int dx = x - center;
-            int dy = y - center;
-            if (dx * dx + dy * dy <= radius * radius) {
-                cursorData[y * cursorSize + x] = 1; // The cursor itself (black part)
-                cursorMask[y * cursorSize + x] = 1; // The mask (white part)
-            } else {
-                cursorData[y * cursorSize + x] = 0; // Outside the circle
-                cursorMask[y * cursorSize + x] = 0; // Make it transparent
+    // The circle is worked out at compile time; the same loop at run time trips -Wstrict-overflow in release builds.
+    constexpr auto circle = [] {
+        std::array<Uint8, cursorSize * cursorSize> cells{};
+        for (int y = 0; y < cursorSize; ++y) {
+            for (int x = 0; x < cursorSize; ++x) {
+                int dx = x - center;
+                int dy = y - center;
+                // 1 is the cursor itself (black part) and its mask (white part), 0 is transparent.
+                cells[static_cast<std::size_t>(y * cursorSize + x)] = dx * dx + dy * dy <= radius * radius ? 1 : 0;
             }
         }
-    }
+        return cells;
+    }();
+    std::array<Uint8, cursorSize * cursorSize> cursorData = circle;
+    std::array<Uint8, cursorSize * cursorSize> cursorMask = circle;
 
     // Create and set the SDL cursor
-    SDL_Cursor* customCursor = SDL_CreateCursor(cursorData, cursorMask, cursorSize, cursorSize, center, center);
+    SDL_Cursor* customCursor = SDL_CreateCursor(cursorData.data(), cursorMask.data(), cursorSize, cursorSize, center, center);
     SDL_SetCursor(customCursor);
 }
 
@@ -0,0 +1,367 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "DataGenerator.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fmt/core.h>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DATA_GENERATOR_AVX2 1
+#include <immintrin.h>
+#else
+#define DATA_GENERATOR_AVX2 0
+#endif
+
+namespace {
+    /**
+     * @brief Threads get whole multiples of this many elements.
+     */
+    constexpr std::size_t BLOCK = std::size_t{1} << 14;
+    /**
+     * @brief Arrays smaller than this are filled on the calling thread.
+     */
+    constexpr std::size_t PARALLEL_THRESHOLD = std::size_t{1} << 20;
+
+    enum Stream : std::uint64_t { VALUES = 0, SWAPS = 1, ZIPF_RETRIES = 2 };
+
+    constexpr std::uint64_t splitMix64(std::uint64_t x) noexcept {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Chris Wellons' lowbias32 integer hash; only 32-bit multiplies, so eight lanes fit one AVX2 register.
+     */
+    constexpr std::uint32_t mix32(std::uint32_t x) noexcept {
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    struct Keys {
+        std::uint32_t first;
+        std::uint32_t second;
+    };
+
+    /**
+     * @brief Keys for the counters [high << 32, (high + 1) << 32) of one stream of a seed.
+     */
+    Keys keysFor(std::uint64_t seed, std::uint64_t stream, std::uint64_t high) {
+        const std::uint64_t key = splitMix64(seed ^ splitMix64(stream ^ splitMix64(high)));
+        return {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+    }
+
+    constexpr std::uint32_t random32(Keys keys, std::uint32_t counter) noexcept {
+        return mix32(mix32(counter ^ keys.first) + keys.second);
+    }
+
+    /**
+     * @brief Maps a 32-bit random number onto [0, range) with a multiply instead of a division.
+     */
+    constexpr std::uint64_t scaled(std::uint32_t random, std::uint64_t range) noexcept {
+        return (std::uint64_t{random} * range) >> 32;
+    }
+
+    constexpr double unitInterval(std::uint32_t random) noexcept {
+        return (random + 0.5) / 4294967296.0;
+    }
+
+    /**
+     * @brief Samples Zipf ranks in [1, n] by rejection-inversion (Hörmann and Derflinger), without any table.
+     *
+     * Most draws are accepted on the first try, so one uniform per element is usually enough.
+     */
+    class ZipfSampler {
+    public:
+        ZipfSampler(double exponent, int n) :
+            exponent_(exponent),
+            n_(n),
+            hIntegralX1_(hIntegral(1.5) - 1.0),
+            hIntegralN_(hIntegral(static_cast<double>(n) + 0.5)),
+            s_(2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0))) {}
+
+        /**
+         * @brief One attempt with a uniform in (0, 1); returns 0 if it was rejected.
+         */
+        [[nodiscard]] int attempt(double uniform) const {
+            const double u = hIntegralN_ + uniform * (hIntegralX1_ - hIntegralN_);
+            const double x = hIntegralInverse(u);
+            const double k = std::clamp(std::floor(x + 0.5), 1.0, static_cast<double>(n_));
+            if (k - x <= s_ || u >= hIntegral(k + 0.5) - h(k)) {
+                return static_cast<int>(k);
+            }
+            return 0;
+        }
+
+    private:
+        // log1p(x) / x and expm1(x) / x, with their series near zero where the quotients lose precision.
+        static double helper1(double x) {
+            return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+        static double helper2(double x) {
+            return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+        }
+        [[nodiscard]] double h(double x) const { return std::exp(-exponent_ * std::log(x)); }
+        [[nodiscard]] double hIntegral(double x) const {
+            const double logX = std::log(x);
+            return helper2((1.0 - exponent_) * logX) * logX;
+        }
+        [[nodiscard]] double hIntegralInverse(double x) const {
+            const double t = std::max(x * (1.0 - exponent_), -1.0);
+            return std::exp(helper1(t) * x);
+        }
+
+        double exponent_;
+        int n_;
+        double hIntegralX1_;
+        double hIntegralN_;
+        double s_;
+    };
+
+    /**
+     * @brief Random numbers are produced a batch at a time into a buffer that stays in L1.
+     */
+    constexpr std::size_t BATCH = 1024;
+
+    /**
+     * @brief random[j] = random32(keys, first + j) for j in [0, count).
+     */
+    void fillRandomScalar(Keys keys, std::uint32_t first, std::uint32_t* random, std::size_t count) {
+        for (std::size_t j = 0; j < count; ++j) {
+            random[j] = random32(keys, first + static_cast<std::uint32_t>(j));
+        }
+    }
+
+#if DATA_GENERATOR_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+    AVX2_TARGET inline __m256i mix32(__m256i x) {
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+        return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    }
+
+    AVX2_TARGET void fillRandomAvx2(Keys keys, std::uint32_t first, std::uint32_t* random, std::size_t count) {
+        const __m256i first8 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        const __m256i key1 = _mm256_set1_epi32(static_cast<int>(keys.first));
+        const __m256i key2 = _mm256_set1_epi32(static_cast<int>(keys.second));
+        std::size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            const __m256i counter = _mm256_add_epi32(first8, _mm256_set1_epi32(static_cast<int>(j)));
+            const __m256i x = mix32(_mm256_add_epi32(mix32(_mm256_xor_si256(counter, key1)), key2));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(random + j), x);
+        }
+        // Leaving the upper halves dirty makes the SSE code that follows, libm included, pay for every transition.
+        _mm256_zeroupper();
+        fillRandomScalar(keys, first + static_cast<std::uint32_t>(j), random + j, count - j);
+    }
+#endif
+
+    using FillRandom = void (*)(Keys, std::uint32_t, std::uint32_t*, std::size_t);
+
+    FillRandom fillRandomKernel() {
+#if DATA_GENERATOR_AVX2
+        return __builtin_cpu_supports("avx2") ? &fillRandomAvx2 : &fillRandomScalar;
+#else
+        return &fillRandomScalar;
+#endif
+    }
+
+    /**
+     * @brief Writes 1 + floor(p * maxValue / period) for p = first, first + 1, ... to out[0, count), so consecutive
+     * positions climb from 1 towards maxValue. Only the first value needs a division.
+     */
+    void writeRamp(int* out, std::size_t count, std::size_t first, std::size_t period, std::uint64_t maxValue) {
+        const std::uint64_t step = maxValue / period;
+        const std::uint64_t rest = maxValue % period;
+        std::uint64_t value = first * maxValue / period;
+        std::uint64_t remainder = first * maxValue % period;
+        for (std::size_t j = 0; j < count; ++j) {
+            out[j] = 1 + static_cast<int>(value);
+            value += step;
+            remainder += rest;
+            if (remainder >= period) {
+                ++value;
+                remainder -= period;
+            }
+        }
+    }
+
+    /**
+     * @brief The ramp of positions [first, first + count) written right to left.
+     */
+    void writeDescendingRamp(int* out, std::size_t count, std::size_t first, std::size_t period, std::uint64_t maxValue) {
+        writeRamp(out, count, first, period, maxValue);
+        std::reverse(out, out + count);
+    }
+
+    void fillRandomValues(const DataSpec& spec, int* out, std::size_t begin, std::size_t end, FillRandom fillRandom,
+                          const ZipfSampler& zipf) {
+        const auto maxValue = static_cast<std::uint64_t>(spec.maxValue);
+        const auto unique = static_cast<std::uint64_t>(std::clamp(spec.uniqueValues, 1, spec.maxValue));
+        const auto step = static_cast<int>(maxValue / unique);
+        std::array<std::uint32_t, BATCH> random{};
+        for (std::size_t batch = begin; batch < end;) {
+            // Batches never straddle a 2^32 counter boundary, so one pair of keys covers the whole batch.
+            const std::size_t batchEnd = std::min(end, (batch / BATCH + 1) * BATCH);
+            const std::size_t count = batchEnd - batch;
+            const Keys keys = keysFor(spec.seed, VALUES, batch >> 32);
+            fillRandom(keys, static_cast<std::uint32_t>(batch), random.data(), count);
+            int* target = out + batch;
+            switch (spec.distribution) {
+                case Distribution::Uniform:
+                    for (std::size_t j = 0; j < count; ++j) {
+                        target[j] = 1 + static_cast<int>(scaled(random[j], maxValue));
+                    }
+                    break;
+                case Distribution::FewUnique:
+                    for (std::size_t j = 0; j < count; ++j) {
+                        target[j] = 1 + static_cast<int>(scaled(random[j], unique)) * step;
+                    }
+                    break;
+                case Distribution::Zipf:
+                    for (std::size_t j = 0; j < count; ++j) {
+                        int value = zipf.attempt(unitInterval(random[j]));
+                        for (std::uint64_t retry = ZIPF_RETRIES; value == 0; ++retry) {
+                            const Keys retryKeys = keysFor(spec.seed, retry, (batch + j) >> 32);
+                            value = zipf.attempt(unitInterval(random32(retryKeys, static_cast<std::uint32_t>(batch + j))));
+                        }
+                        target[j] = value;
+                    }
+                    break;
+                case Distribution::Sorted:
+                case Distribution::Reversed:
+                case Distribution::NearlySorted:
+                case Distribution::OrganPipe:
+                case Distribution::Sawtooth:
+                default:
+                    break;
+            }
+            batch = batchEnd;
+        }
+    }
+
+    void fillRange(const DataSpec& spec, int* out, std::size_t size, std::size_t begin, std::size_t end,
+                   FillRandom fillRandom, const ZipfSampler& zipf) {
+        const auto maxValue = static_cast<std::uint64_t>(spec.maxValue);
+        switch (spec.distribution) {
+            case Distribution::Uniform:
+            case Distribution::FewUnique:
+            case Distribution::Zipf:
+                fillRandomValues(spec, out, begin, end, fillRandom, zipf);
+                break;
+            case Distribution::Sorted:
+            case Distribution::NearlySorted:
+                writeRamp(out + begin, end - begin, begin, size, maxValue);
+                break;
+            case Distribution::Reversed:
+                writeDescendingRamp(out + begin, end - begin, size - end, size, maxValue);
+                break;
+            case Distribution::OrganPipe: {
+                const std::size_t half = (size + 1) / 2;
+                const std::size_t split = std::clamp(half, begin, end);
+                writeRamp(out + begin, split - begin, begin, half, maxValue);
+                writeDescendingRamp(out + split, end - split, size - end, half, maxValue);
+                break;
+            }
+            case Distribution::Sawtooth: {
+                const std::size_t teeth = std::clamp<std::size_t>(spec.teeth, 1, size);
+                const std::size_t period = (size + teeth - 1) / teeth;
+                for (std::size_t i = begin; i < end;) {
+                    const std::size_t position = i % period;
+                    const std::size_t count = std::min(end - i, period - position);
+                    writeRamp(out + i, count, position, period, maxValue);
+                    i += count;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+std::string_view distributionName(Distribution distribution) {
+    switch (distribution) {
+        case Distribution::Uniform: return "uniform";
+        case Distribution::Sorted: return "sorted";
+        case Distribution::Reversed: return "reversed";
+        case Distribution::NearlySorted: return "nearly-sorted";
+        case Distribution::FewUnique: return "few-unique";
+        case Distribution::OrganPipe: return "organ-pipe";
+        case Distribution::Zipf: return "zipf";
+        case Distribution::Sawtooth: return "sawtooth";
+        default: break;
+    }
+    return "unknown";
+}
+
+Distribution parseDistribution(std::string_view name) {
+    for (const auto distribution : ALL_DISTRIBUTIONS) {
+        if (distributionName(distribution) == name) {
+            return distribution;
+        }
+    }
+    throw std::invalid_argument(fmt::format("Unknown distribution '{}'", name));
+}
+
+void generateData(const DataSpec& spec, std::span<int> out, unsigned threads) {
+    if (spec.maxValue < 1) {
+        throw std::invalid_argument(fmt::format("maxValue must be positive, got {}", spec.maxValue));
+    }
+    if (spec.distribution == Distribution::Zipf && !(spec.zipfExponent > 0.0)) {
+        throw std::invalid_argument(fmt::format("zipfExponent must be positive, got {}", spec.zipfExponent));
+    }
+    const std::size_t size = out.size();
+    if (size == 0) return;
+    const ZipfSampler zipf(spec.distribution == Distribution::Zipf ? spec.zipfExponent : 1.0, spec.maxValue);
+    const FillRandom fillRandom = fillRandomKernel();
+
+    threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunks = std::min<std::size_t>(threads, size / (PARALLEL_THRESHOLD / 4));
+    if (size < PARALLEL_THRESHOLD || chunks < 2) {
+        fillRange(spec, out.data(), size, 0, size, fillRandom, zipf);
+    } else {
+        // Whole blocks per thread, so the split does not change which keys fill which elements.
+        const std::size_t chunk = (size / chunks + BLOCK - 1) / BLOCK * BLOCK;
+        std::vector<std::jthread> workers;
+        for (std::size_t begin = 0; begin < size; begin += chunk) {
+            workers.emplace_back([&spec, &out, &zipf, fillRandom, size, begin, chunk] {
+                fillRange(spec, out.data(), size, begin, std::min(size, begin + chunk), fillRandom, zipf);
+            });
+        }
+    }
+
+    if (spec.distribution == Distribution::NearlySorted && size > 1) {
+        const std::size_t swaps = spec.swaps ? spec.swaps : std::max<std::size_t>(1, size / 100);
+        for (std::size_t s = 0; s < swaps; ++s) {
+            const Keys keys = keysFor(spec.seed, SWAPS, s >> 31);
+            const auto counter = static_cast<std::uint32_t>(2 * (s & 0x7FFFFFFF));
+            std::swap(out[scaled(random32(keys, counter), size)], out[scaled(random32(keys, counter + 1), size)]);
+        }
+    }
+}
+
+std::vector<int> generateData(const DataSpec& spec, unsigned threads) {
+    std::vector<int> data(spec.size);
+    generateData(spec, data, threads);
+    return data;
+}
+
+std::uint64_t randomSeed() {
+    std::random_device device;
+    return (std::uint64_t{device()} << 32) | device();
+}
@@ -0,0 +1,75 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_DATAGENERATOR_H
+#define ALGOVISUALIZER_DATAGENERATOR_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+enum class Distribution { Uniform, Sorted, Reversed, NearlySorted, FewUnique, OrganPipe, Zipf, Sawtooth };
+
+constexpr std::array<Distribution, 8> ALL_DISTRIBUTIONS = {
+        Distribution::Uniform,   Distribution::Sorted,    Distribution::Reversed, Distribution::NearlySorted,
+        Distribution::FewUnique, Distribution::OrganPipe, Distribution::Zipf,     Distribution::Sawtooth,
+};
+
+/**
+ * @brief What input to generate for a sort. The same spec always produces the same data.
+ */
+struct DataSpec {
+    Distribution distribution = Distribution::Uniform;
+    std::size_t size = 0;
+    std::uint64_t seed = 1;
+    /**
+     * @brief Values lie in [1, maxValue].
+     */
+    int maxValue = 1'000'000'000;
+    /**
+     * @brief NearlySorted: random swaps applied to sorted data; 0 means one per hundred elements.
+     */
+    std::size_t swaps = 0;
+    /**
+     * @brief FewUnique: number of distinct values.
+     */
+    int uniqueValues = 16;
+    /**
+     * @brief Zipf: value k is drawn with probability proportional to 1 / k^zipfExponent.
+     */
+    double zipfExponent = 1.0;
+    /**
+     * @brief Sawtooth: number of ascending runs.
+     */
+    std::size_t teeth = 8;
+};
+
+/**
+ * @brief Name used on the command line and in reports, such as "nearly-sorted".
+ */
+std::string_view distributionName(Distribution distribution);
+/**
+ * @throws std::invalid_argument if name is not one of the distribution names.
+ */
+Distribution parseDistribution(std::string_view name);
+
+/**
+ * @brief Fills out with data following spec; spec.size is ignored in favour of out.size().
+ *
+ * Random values come from a counter-based generator: element i is a hash of (seed, i), so large arrays are filled
+ * in parallel by independent threads, the inner loop has no carried state and vectorizes, and the result does not
+ * depend on the thread count. Sorted, Reversed, OrganPipe and Sawtooth are exact ramps and ignore the seed.
+ * @param threads Threads to fill with; 0 uses every hardware thread. Small arrays are always filled on the caller.
+ */
+void generateData(const DataSpec& spec, std::span<int> out, unsigned threads = 0);
+std::vector<int> generateData(const DataSpec& spec, unsigned threads = 0);
+/**
+ * @brief A seed from std::random_device, for callers that want different data on every run.
+ */
+std::uint64_t randomSeed();
+
+
+#endif //ALGOVISUALIZER_DATAGENERATOR_H
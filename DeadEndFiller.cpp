@@ -0,0 +1,170 @@
+/**
+ * @file DeadEndFiller.cpp
+ * @brief
+ * @date Created on 19-10-26
+ * @author Renato Chavez
+ */
+#include "DeadEndFiller.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @brief Converts wall bits into openings and closes every opening that points out of the grid.
+ */
+DeadEndFiller::DeadEndFiller(const std::vector<std::uint8_t>& walls, std::size_t rows, std::size_t cols) :
+        rows_(rows),
+        cols_(cols),
+        open_(rows * cols, 0),
+        pinned_(rows * cols, 0),
+        keep_((rows + 2) * cols, 0),
+        rowDirty_(rows + 2, 0),
+        rowChanged_(rows + 2, 0) {
+    if (walls.size() != rows * cols) {
+        throw std::invalid_argument("DeadEndFiller: wall grid does not match the given dimensions");
+    }
+    for (std::size_t r = 0; r < rows_; ++r) {
+        auto border = ALL_OPEN;
+        if (r == 0) border = static_cast<std::uint8_t>(border & ~OPEN_TOP);
+        if (r + 1 == rows_) border = static_cast<std::uint8_t>(border & ~OPEN_BOTTOM);
+        for (std::size_t c = 0; c < cols_; ++c) {
+            auto mask = border;
+            if (c == 0) mask = static_cast<std::uint8_t>(mask & ~OPEN_LEFT);
+            if (c + 1 == cols_) mask = static_cast<std::uint8_t>(mask & ~OPEN_RIGHT);
+            open_[r * cols_ + c] = static_cast<std::uint8_t>(~walls[r * cols_ + c] & mask);
+        }
+    }
+}
+
+DeadEndFiller::~DeadEndFiller() = default;
+
+void DeadEndFiller::sweepKeep(std::size_t rowBegin, std::size_t rowEnd) {
+    const std::uint8_t* open = open_.data();
+    const std::uint8_t* pinned = pinned_.data();
+    std::uint8_t* keep = keep_.data() + cols_;
+    for (std::size_t r = rowBegin; r < rowEnd; ++r) {
+        // keep only depends on the row's own openings, so rows untouched by the previous pass are still valid.
+        if (!rowDirty_[r + 1]) {
+            continue;
+        }
+        for (std::size_t i = r * cols_; i < (r + 1) * cols_; ++i) {
+            const auto o = open[i];
+            // A cell survives with at least two openings, i.e. when clearing its lowest opening leaves one.
+            const auto branching = static_cast<std::uint8_t>((o & (o - 1)) != 0 ? 0xFF : 0x00);
+            keep[i] = static_cast<std::uint8_t>(branching | pinned[i]);
+        }
+    }
+}
+
+std::size_t DeadEndFiller::sweepOpen(std::size_t rowBegin, std::size_t rowEnd) {
+    std::uint8_t* open = open_.data();
+    // keep is padded by one row, so the cell above index i is keep[i] and the cell below is keep[i + 2 * cols].
+    const std::uint8_t* keep = keep_.data();
+    const std::size_t cols = cols_;
+    std::size_t total = 0;
+    for (std::size_t r = rowBegin; r < rowEnd; ++r) {
+        if (!(rowDirty_[r] | rowDirty_[r + 1] | rowDirty_[r + 2])) {
+            rowChanged_[r + 1] = 0;
+            continue;
+        }
+        std::size_t changed = 0;
+        for (std::size_t i = r * cols; i < (r + 1) * cols; ++i) {
+            // Left and right neighbours wrap into the adjacent row at the grid border, but the border openings
+            // are always closed so the wrapped value is masked away.
+            const auto alive = static_cast<std::uint8_t>((keep[i] & OPEN_TOP) |
+                                                         (keep[i + cols + 1] & OPEN_RIGHT) |
+                                                         (keep[i + 2 * cols] & OPEN_BOTTOM) |
+                                                         (keep[i + cols - 1] & OPEN_LEFT));
+            const auto o = open[i];
+            const auto next = static_cast<std::uint8_t>(o & keep[i + cols] & alive);
+            changed += static_cast<std::size_t>(next != o);
+            open[i] = next;
+        }
+        rowChanged_[r + 1] = static_cast<std::uint8_t>(changed != 0);
+        total += changed;
+    }
+    return total;
+}
+
+std::size_t DeadEndFiller::fill(std::size_t start, std::size_t end, unsigned threadCount) {
+    if (start >= open_.size() || end >= open_.size()) {
+        throw std::out_of_range("DeadEndFiller: endpoint outside the grid");
+    }
+    std::fill(pinned_.begin(), pinned_.end(), 0);
+    pinned_[start] = 0xFF;
+    pinned_[end] = 0xFF;
+    std::fill(rowDirty_.begin() + 1, rowDirty_.end() - 1, 1);
+
+    threadCount = std::clamp(threadCount, 1u, static_cast<unsigned>(std::max<std::size_t>(rows_, 1)));
+    if (threadCount > 1) {
+        return fillParallel(threadCount);
+    }
+    std::size_t passes = 0;
+    std::size_t changed = 0;
+    do {
+        sweepKeep(0, rows_);
+        changed = sweepOpen(0, rows_);
+        rowDirty_.swap(rowChanged_);
+        ++passes;
+    } while (changed != 0);
+    return passes;
+}
+
+std::size_t DeadEndFiller::fillParallel(unsigned threadCount) {
+    std::atomic<std::size_t> changed{0};
+    std::size_t passes = 0;
+    bool done = false;
+    auto onPassComplete = [&]() noexcept {
+        ++passes;
+        rowDirty_.swap(rowChanged_);
+        done = changed.exchange(0, std::memory_order_relaxed) == 0;
+    };
+    std::barrier keepBarrier(static_cast<std::ptrdiff_t>(threadCount));
+    std::barrier passBarrier(static_cast<std::ptrdiff_t>(threadCount), onPassComplete);
+
+    auto sweepStrip = [&](std::size_t rowBegin, std::size_t rowEnd) {
+        while (true) {
+            sweepKeep(rowBegin, rowEnd);
+            keepBarrier.arrive_and_wait();
+            changed.fetch_add(sweepOpen(rowBegin, rowEnd), std::memory_order_relaxed);
+            passBarrier.arrive_and_wait();
+            if (done) {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threadCount - 1);
+    const std::size_t stripRows = (rows_ + threadCount - 1) / threadCount;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        const std::size_t rowBegin = std::min(rows_, t * stripRows);
+        workers.emplace_back(sweepStrip, rowBegin, std::min(rows_, rowBegin + stripRows));
+    }
+    sweepStrip(0, std::min(rows_, stripRows));
+    workers.clear();
+    return passes;
+}
+
+std::vector<std::size_t> DeadEndFiller::corridor(std::size_t start, std::size_t end) const {
+    std::vector<std::size_t> path{start};
+    std::size_t previous = start;
+    std::size_t current = start;
+    while (current != end) {
+        const auto o = open_[current];
+        std::size_t next = current;
+        if ((o & OPEN_TOP) && current - cols_ != previous) next = current - cols_;
+        else if ((o & OPEN_RIGHT) && current + 1 != previous) next = current + 1;
+        else if ((o & OPEN_BOTTOM) && current + cols_ != previous) next = current + cols_;
+        else if ((o & OPEN_LEFT) && current - 1 != previous) next = current - 1;
+        if (next == current || path.size() > open_.size()) {
+            return {};
+        }
+        previous = current;
+        current = next;
+        path.push_back(current);
+    }
+    return path;
+}
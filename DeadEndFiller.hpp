@@ -0,0 +1,90 @@
+/**
+ * @file DeadEndFiller.hpp
+ * @brief Class definition for DeadEndFiller, a cellular-automaton maze solver.
+ * @date Created on 19-10-26.
+ * @author Renato Chavez
+ */
+#ifndef ALGOVISUALIZER_DEADENDFILLER_HPP
+#define ALGOVISUALIZER_DEADENDFILLER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Whole-grid maze solver that repeatedly fills dead ends.
+ *
+ * The solver keeps one byte of openings per cell, using the same bit layout as the wall bits of Maze
+ * (top, right, bottom, left). A pass first marks which cells survive (two or more openings, or pinned as an
+ * endpoint) and then clears the openings of filled cells and of the openings that lead into them. Both sweeps
+ * are branch-free loops over contiguous rows, so the compiler vectorizes them, and passes can be split across
+ * row strips that run on separate threads. No queue or predecessor map is needed: when no cell changes, only
+ * the corridor between the endpoints remains open.
+ */
+class DeadEndFiller {
+public:
+    static constexpr std::uint8_t OPEN_TOP = 0x01;
+    static constexpr std::uint8_t OPEN_RIGHT = 0x02;
+    static constexpr std::uint8_t OPEN_BOTTOM = 0x04;
+    static constexpr std::uint8_t OPEN_LEFT = 0x08;
+    static constexpr std::uint8_t ALL_OPEN = 0x0F;
+
+    /**
+     * @brief Builds the openings grid from packed wall bits.
+     * @param walls One byte per cell in row-major order, low four bits set where a wall is present.
+     * @param rows Number of rows in the grid.
+     * @param cols Number of columns in the grid.
+     */
+    DeadEndFiller(const std::vector<std::uint8_t>& walls, std::size_t rows, std::size_t cols);
+    ~DeadEndFiller();
+    /**
+     * @brief Fills dead ends until the grid is stable.
+     * @param start Index of the first endpoint, never filled.
+     * @param end Index of the second endpoint, never filled.
+     * @param threadCount Number of row strips swept in parallel, one thread each.
+     * @return Number of passes that were needed.
+     */
+    std::size_t fill(std::size_t start, std::size_t end, unsigned threadCount = 1);
+    /**
+     * @brief Walks the remaining corridor after fill().
+     * @return Cell indices from start to end, or an empty vector when the endpoints are not connected.
+     */
+    [[nodiscard]] std::vector<std::size_t> corridor(std::size_t start, std::size_t end) const;
+    [[nodiscard]] const std::vector<std::uint8_t>& getOpenings() const { return open_; }
+
+private:
+    /**
+     * @brief First sweep of a pass: records which cells survive into the padded keep grid.
+     */
+    void sweepKeep(std::size_t rowBegin, std::size_t rowEnd);
+    /**
+     * @brief Second sweep of a pass: closes openings of filled cells and openings into them.
+     * @return Number of cells whose openings changed.
+     */
+    std::size_t sweepOpen(std::size_t rowBegin, std::size_t rowEnd);
+    std::size_t fillParallel(unsigned threadCount);
+
+    std::size_t rows_;
+    std::size_t cols_;
+    /**
+     * @brief Openings per cell, zero once a cell is filled.
+     */
+    std::vector<std::uint8_t> open_;
+    /**
+     * @brief 0xFF for the two endpoints, 0 elsewhere.
+     */
+    std::vector<std::uint8_t> pinned_;
+    /**
+     * @brief 0xFF for cells that survive the current pass, padded with one empty row above and below.
+     */
+    std::vector<std::uint8_t> keep_;
+    /**
+     * @brief Rows whose openings changed in the previous pass, padded like keep_. Only rows next to a dirty row
+     * need to be swept again, which skips most of the grid once the remaining dead ends are few.
+     */
+    std::vector<std::uint8_t> rowDirty_;
+    /**
+     * @brief Rows whose openings changed in the current pass.
+     */
+    std::vector<std::uint8_t> rowChanged_;
+};
+#endif //ALGOVISUALIZER_DEADENDFILLER_HPP
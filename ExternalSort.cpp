@@ -0,0 +1,413 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "ExternalSort.h"
+#include "ParallelSort.h"
+#include "RadixSort.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Every merge input gets at least this much buffer, which caps the fan-in for a given budget.
+     */
+    constexpr std::size_t MIN_MERGE_BUFFER_BYTES = std::size_t{256} << 10;
+    /**
+     * @brief More simultaneous runs than this would press against the usual limit on open files.
+     */
+    constexpr std::size_t MAX_FAN_IN = 512;
+    /**
+     * @brief Reads and writes are at most this many ints, so progress moves and cancel() is noticed promptly.
+     */
+    constexpr std::size_t IO_SLICE = std::size_t{1} << 20;
+    constexpr std::size_t MIN_RUN_LENGTH = std::size_t{1} << 10;
+    /**
+     * @brief With fewer workers the single-threaded LSD radix sort forms runs faster than the parallel sample sort.
+     */
+    constexpr std::size_t PARALLEL_RUN_SORT_WORKERS = 4;
+
+    /**
+     * @brief Thrown from the I/O loops once the sort is cancelled, to unwind to sort().
+     */
+    struct SortCancelled {};
+
+    double secondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double>(Clock::now() - begin).count();
+    }
+
+    void readValues(std::ifstream& in, int* values, std::size_t count, const std::string& path) {
+        const auto bytes = static_cast<std::streamsize>(count * sizeof(int));
+        in.read(reinterpret_cast<char*>(values), bytes);
+        if (in.gcount() != bytes) {
+            throw std::runtime_error(fmt::format("Failed to read {} values from {}", count, path));
+        }
+    }
+
+    void writeValues(std::ofstream& out, const int* values, std::size_t count, const std::string& path) {
+        out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(int)));
+        if (!out) {
+            throw std::runtime_error(fmt::format("Failed to write {} values to {}", count, path));
+        }
+    }
+
+    /**
+     * @brief Sequential reader of one sorted run through a buffer refilled with one large read at a time.
+     */
+    class RunReader {
+    public:
+        RunReader(std::string path, ExternalSorter::Row& row, std::size_t bufferValues) :
+            path_(std::move(path)),
+            in_(path_, std::ios::binary),
+            buffer_(static_cast<std::size_t>(std::min<std::uint64_t>(bufferValues, std::max<std::uint64_t>(row.length, 1)))),
+            position_(0),
+            end_(0),
+            remaining_(row.length),
+            row_(row) {
+            if (!in_) {
+                throw std::runtime_error(fmt::format("Failed to open {} for reading", path_));
+            }
+        }
+        RunReader(RunReader&& other) noexcept;
+        RunReader& operator=(RunReader&&) = delete;
+        ~RunReader();
+
+        bool next(int& value) {
+            if (position_ == end_ && !refill()) return false;
+            value = buffer_[position_++];
+            return true;
+        }
+
+    private:
+        bool refill() {
+            if (remaining_ == 0) return false;
+            const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(buffer_.size(), remaining_));
+            readValues(in_, buffer_.data(), count, path_);
+            remaining_ -= count;
+            row_.consumed.fetch_add(count, std::memory_order_relaxed);
+            position_ = 0;
+            end_ = count;
+            return true;
+        }
+
+        std::string path_;
+        std::ifstream in_;
+        std::vector<int> buffer_;
+        std::size_t position_;
+        std::size_t end_;
+        std::uint64_t remaining_;
+        ExternalSorter::Row& row_;
+    };
+
+    // Defined out of line: GCC declines to inline them on the unlikely paths that destroy a reader, and -Winline
+    // would report every such call.
+    RunReader::RunReader(RunReader&& other) noexcept = default;
+    RunReader::~RunReader() = default;
+
+    /**
+     * @brief Writer of one merged run that fills one buffer while the other is written out in the background.
+     */
+    class RunWriter {
+    public:
+        RunWriter(std::string path, ExternalSorter::Row& row, std::size_t bufferValues,
+                  const std::atomic<bool>& cancelled) :
+            path_(std::move(path)),
+            out_(path_, std::ios::binary | std::ios::trunc),
+            buffer_(bufferValues),
+            spare_(bufferValues),
+            fill_(0),
+            row_(row),
+            cancelled_(cancelled),
+            pending_() {
+            if (!out_) {
+                throw std::runtime_error(fmt::format("Failed to open {} for writing", path_));
+            }
+        }
+        RunWriter(const RunWriter&) = delete;
+        RunWriter& operator=(const RunWriter&) = delete;
+        ~RunWriter() {
+            if (pending_.valid()) pending_.wait();
+        }
+
+        void push(int value) {
+            buffer_[fill_++] = value;
+            if (fill_ == buffer_.size()) flush();
+        }
+
+        void close() {
+            flush();
+            if (pending_.valid()) pending_.get();
+            out_.close();
+            if (!out_) {
+                throw std::runtime_error(fmt::format("Failed to finish writing {}", path_));
+            }
+        }
+
+    private:
+        void flush() {
+            if (pending_.valid()) pending_.get();
+            if (cancelled_.load(std::memory_order_relaxed)) throw SortCancelled();
+            std::swap(buffer_, spare_);
+            const std::size_t count = std::exchange(fill_, 0);
+            pending_ = std::async(std::launch::async, [this, count] {
+                writeValues(out_, spare_.data(), count, path_);
+                row_.written.fetch_add(count, std::memory_order_relaxed);
+            });
+        }
+
+        std::string path_;
+        std::ofstream out_;
+        std::vector<int> buffer_;
+        /**
+         * @brief The buffer being written out while buffer_ fills.
+         */
+        std::vector<int> spare_;
+        std::size_t fill_;
+        ExternalSorter::Row& row_;
+        const std::atomic<bool>& cancelled_;
+        /**
+         * @brief Declared last so a write still in flight finishes before the buffers go away.
+         */
+        std::future<void> pending_;
+    };
+}
+
+LoserTree::LoserTree(std::size_t sources) :
+    leaves_(std::max<std::size_t>(sources, 1), EXHAUSTED),
+    tree_(std::max<std::size_t>(sources, 1), EXHAUSTED) {
+}
+
+void LoserTree::set(std::size_t source, int key) {
+    leaves_[source] = entry(source, key);
+}
+
+void LoserTree::build() {
+    tree_[0] = playFrom(1);
+}
+
+std::uint64_t LoserTree::playFrom(std::size_t node) {
+    const std::size_t sources = tree_.size();
+    if (node >= sources) return leaves_[node - sources];
+    const std::uint64_t left = playFrom(2 * node);
+    const std::uint64_t right = playFrom(2 * node + 1);
+    tree_[node] = std::max(left, right);
+    return std::min(left, right);
+}
+
+// Defined out of line, like RunReader's, so that -Winline has no inline destructor to report on unlikely paths.
+ExternalSortConfig::ExternalSortConfig() = default;
+ExternalSortConfig::ExternalSortConfig(const ExternalSortConfig& other) = default;
+ExternalSortConfig::ExternalSortConfig(ExternalSortConfig&& other) noexcept = default;
+ExternalSortConfig& ExternalSortConfig::operator=(const ExternalSortConfig& other) = default;
+ExternalSortConfig& ExternalSortConfig::operator=(ExternalSortConfig&& other) noexcept = default;
+ExternalSortConfig::~ExternalSortConfig() = default;
+
+ExternalSorter::ExternalSorter(ExternalSortConfig config) :
+    config_(std::move(config)),
+    size_(0),
+    runLength_(0),
+    initialRuns_(0),
+    rowCount_(0),
+    rows_(),
+    steps_(),
+    phase_(Phase::Ready),
+    cancelled_(false),
+    formingSeconds_(0.0),
+    mergingSeconds_(0.0) {
+    std::error_code error;
+    const std::uintmax_t bytes = std::filesystem::file_size(config_.inputPath, error);
+    if (error) {
+        throw std::runtime_error(fmt::format("Failed to read {}: {}", config_.inputPath, error.message()));
+    }
+    if (bytes % sizeof(int) != 0) {
+        throw std::runtime_error(fmt::format("{} holds {} bytes, not a whole number of ints", config_.inputPath, bytes));
+    }
+    if (config_.tempDirectory.empty()) {
+        const auto parent = std::filesystem::path(config_.outputPath).parent_path();
+        config_.tempDirectory = parent.empty() ? "." : parent.string();
+    }
+    if (config_.threads == 0) {
+        config_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_ = bytes / sizeof(int);
+    // Per value of a run: the chunk being sorted, the chunk read ahead and the run sort's scratch, which for the
+    // sample sort is a buffer plus a 16-bit bucket id.
+    const std::size_t scratchBytes = config_.threads >= PARALLEL_RUN_SORT_WORKERS ? sizeof(int) + sizeof(std::uint16_t)
+                                                                                  : sizeof(int);
+    runLength_ = std::max(MIN_RUN_LENGTH, config_.memoryBytes / (2 * sizeof(int) + scratchBytes));
+    initialRuns_ = static_cast<std::size_t>(std::max<std::uint64_t>(1, (size_ + runLength_ - 1) / runLength_));
+
+    std::vector<std::uint64_t> lengths;
+    for (std::size_t run = 0; run < initialRuns_; ++run) {
+        lengths.push_back(std::min<std::uint64_t>(runLength_, size_ - run * std::uint64_t{runLength_}));
+    }
+    if (initialRuns_ > 1) {
+        const std::size_t fanIn = std::clamp<std::size_t>(config_.memoryBytes / MIN_MERGE_BUFFER_BYTES, 2, MAX_FAN_IN);
+        std::deque<std::size_t> pending(initialRuns_);
+        std::iota(pending.begin(), pending.end(), std::size_t{0});
+        // Merging the oldest runs first keeps every level of intermediate runs about the same length.
+        while (pending.size() > 1) {
+            const std::size_t count = pending.size() > fanIn ? fanIn : pending.size();
+            MergeStep step{{pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count)}, lengths.size()};
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+            std::uint64_t length = 0;
+            for (const std::size_t input : step.inputs) length += lengths[input];
+            lengths.push_back(length);
+            if (!pending.empty()) pending.push_back(step.output);
+            steps_.push_back(std::move(step));
+        }
+    }
+    rowCount_ = lengths.size();
+    rows_ = std::make_unique<Row[]>(rowCount_);
+    for (std::size_t i = 0; i < rowCount_; ++i) {
+        rows_[i].length = lengths[i];
+    }
+}
+
+ExternalSorter::~ExternalSorter() {
+    removeTemporaries();
+}
+
+std::string ExternalSorter::rowPath(std::size_t index) const {
+    if (index + 1 == rowCount_) return config_.outputPath;
+    const auto name = std::filesystem::path(config_.outputPath).filename().string();
+    return (std::filesystem::path(config_.tempDirectory) / fmt::format("{}.{}.run", name, index)).string();
+}
+
+void ExternalSorter::sort() {
+    try {
+        phase_.store(Phase::Forming, std::memory_order_release);
+        auto begin = Clock::now();
+        formRuns();
+        formingSeconds_ = secondsSince(begin);
+
+        phase_.store(Phase::Merging, std::memory_order_release);
+        begin = Clock::now();
+        for (const auto& step : steps_) {
+            merge(step);
+        }
+        mergingSeconds_ = secondsSince(begin);
+        phase_.store(Phase::Done, std::memory_order_release);
+    } catch (const SortCancelled&) {
+        removeTemporaries();
+        std::error_code ignored;
+        std::filesystem::remove(config_.outputPath, ignored);
+        phase_.store(Phase::Cancelled, std::memory_order_release);
+    } catch (...) {
+        removeTemporaries();
+        std::error_code ignored;
+        std::filesystem::remove(config_.outputPath, ignored);
+        phase_.store(Phase::Failed, std::memory_order_release);
+        throw;
+    }
+}
+
+void ExternalSorter::checkCancelled() const {
+    if (cancelled_.load(std::memory_order_relaxed)) throw SortCancelled();
+}
+
+void ExternalSorter::formRuns() {
+    std::ifstream in(config_.inputPath, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(fmt::format("Failed to open {} for reading", config_.inputPath));
+    }
+    WorkStealingPool pool(config_.threads);
+    std::vector<int> current;
+    std::vector<int> next;
+    auto read = [&](std::vector<int>& chunk, std::size_t run) {
+        chunk.resize(rows_[run].length);
+        for (std::size_t i = 0; i < chunk.size(); i += IO_SLICE) {
+            checkCancelled();
+            readValues(in, chunk.data() + i, std::min(IO_SLICE, chunk.size() - i), config_.inputPath);
+        }
+    };
+    read(current, 0);
+    for (std::size_t run = 0; run < initialRuns_; ++run) {
+        // Reading the next chunk overlaps sorting and writing this one.
+        std::future<void> ahead;
+        if (run + 1 < initialRuns_) {
+            ahead = std::async(std::launch::async, read, std::ref(next), run + 1);
+        }
+        if (pool.size() >= PARALLEL_RUN_SORT_WORKERS) {
+            sampleSort(pool, current);
+        } else {
+            lsdRadixSort(current);
+        }
+
+        const std::string path = rowPath(run);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+        }
+        for (std::size_t i = 0; i < current.size(); i += IO_SLICE) {
+            checkCancelled();
+            const std::size_t count = std::min(IO_SLICE, current.size() - i);
+            writeValues(out, current.data() + i, count, path);
+            rows_[run].written.fetch_add(count, std::memory_order_relaxed);
+        }
+        if (ahead.valid()) ahead.get();
+        std::swap(current, next);
+    }
+}
+
+void ExternalSorter::merge(const MergeStep& step) {
+    const std::size_t sources = step.inputs.size();
+    const std::size_t bufferValues = std::clamp<std::size_t>(config_.memoryBytes / sizeof(int) / (sources + 2),
+                                                             std::size_t{1} << 12, IO_SLICE);
+    std::vector<RunReader> readers;
+    readers.reserve(sources);
+    for (const std::size_t input : step.inputs) {
+        readers.emplace_back(rowPath(input), rows_[input], bufferValues);
+    }
+    RunWriter writer(rowPath(step.output), rows_[step.output], bufferValues, cancelled_);
+
+    LoserTree tree(sources);
+    for (std::size_t source = 0; source < sources; ++source) {
+        int value = 0;
+        if (readers[source].next(value)) tree.set(source, value);
+    }
+    tree.build();
+    while (!tree.empty()) {
+        writer.push(tree.winnerKey());
+        int value = 0;
+        if (readers[tree.winner()].next(value)) {
+            tree.replace(value);
+        } else {
+            tree.exhaust();
+        }
+    }
+    writer.close();
+    readers.clear();
+    for (const std::size_t input : step.inputs) {
+        std::filesystem::remove(rowPath(input));
+    }
+}
+
+void ExternalSorter::removeTemporaries() const {
+    for (std::size_t row = 0; row + 1 < rowCount_; ++row) {
+        std::error_code ignored;
+        std::filesystem::remove(rowPath(row), ignored);
+    }
+}
+
+void ExternalSorter::printReport(std::ostream& out) const {
+    const double mebibytes = static_cast<double>(size_ * sizeof(int)) / (1024.0 * 1024.0);
+    auto rate = [&](double seconds) { return seconds > 0 ? mebibytes / seconds : 0.0; };
+    out << fmt::format("Sorted {} ints ({:.1f} MiB) in {:.3f}s\n", size_, mebibytes, formingSeconds_ + mergingSeconds_);
+    out << fmt::format("  {} run(s) of up to {} ints formed in {:.3f}s ({:.1f} MiB/s)\n", initialRuns_, runLength_,
+                       formingSeconds_, rate(formingSeconds_));
+    out << fmt::format("  {} merge(s) in {:.3f}s ({:.1f} MiB/s)\n", steps_.size(), mergingSeconds_,
+                       rate(mergingSeconds_));
+}
@@ -0,0 +1,185 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_EXTERNALSORT_H
+#define ALGOVISUALIZER_EXTERNALSORT_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Tournament tree of losers over k sorted sources, for merging them.
+ *
+ * Every inner node keeps the source that lost the match played there and the root slot keeps the overall winner.
+ * When the winner's source moves on to its next key, only the matches on the path from its leaf to the root are
+ * replayed, each against a loser already in hand: log2(k) comparisons per merged element and no sift in both
+ * directions as with a heap. Nodes hold the key and its source packed into one word, key high, so a match is a
+ * single unsigned comparison the compiler turns into conditional moves, ties go to the lower source, and an
+ * exhausted source is the largest word of all.
+ */
+class LoserTree {
+public:
+    /**
+     * @brief Every source starts out exhausted; give the live ones their first key with set(), then build().
+     */
+    explicit LoserTree(std::size_t sources);
+    void set(std::size_t source, int key);
+    void build();
+
+    [[nodiscard]] bool empty() const { return tree_[0] == EXHAUSTED; }
+    [[nodiscard]] std::size_t winner() const { return static_cast<std::uint32_t>(tree_[0]); }
+    [[nodiscard]] int winnerKey() const {
+        return static_cast<int>(static_cast<std::uint32_t>(tree_[0] >> 32) ^ 0x80000000u);
+    }
+    /**
+     * @brief The winner's source moved on to key.
+     */
+    void replace(int key) { replay(winner(), entry(winner(), key)); }
+    /**
+     * @brief The winner's source has no more keys.
+     */
+    void exhaust() { replay(winner(), EXHAUSTED); }
+
+private:
+    static constexpr std::uint64_t EXHAUSTED = UINT64_MAX;
+
+    static std::uint64_t entry(std::size_t source, int key) {
+        return std::uint64_t{static_cast<std::uint32_t>(key) ^ 0x80000000u} << 32 | source;
+    }
+    std::uint64_t playFrom(std::size_t node);
+    void replay(std::size_t source, std::uint64_t winner) {
+        for (std::size_t node = (source + tree_.size()) / 2; node > 0; node /= 2) {
+            const std::uint64_t loser = tree_[node];
+            const bool wins = loser < winner;
+            tree_[node] = wins ? winner : loser;
+            winner = wins ? loser : winner;
+        }
+        tree_[0] = winner;
+    }
+
+    /**
+     * @brief First entry of every source, only needed to build the tree.
+     */
+    std::vector<std::uint64_t> leaves_;
+    /**
+     * @brief tree_[0] is the winner, tree_[1..k) the loser of every inner node; leaf i is node k + i.
+     */
+    std::vector<std::uint64_t> tree_;
+};
+
+/**
+ * @brief Parameters of one out-of-core sort of a file of native-endian 32-bit ints.
+ */
+struct ExternalSortConfig {
+    std::string inputPath{};
+    std::string outputPath{};
+    /**
+     * @brief Where sorted runs are kept until they are merged; empty for the directory of the output.
+     */
+    std::string tempDirectory{};
+    /**
+     * @brief Memory the sort may use for its buffers, which bounds the run length and the merge fan-in.
+     */
+    std::size_t memoryBytes = std::size_t{1} << 30;
+    /**
+     * @brief Workers of the in-memory run sort; 0 for one per hardware thread.
+     */
+    unsigned threads = 0;
+
+    ExternalSortConfig();
+    ExternalSortConfig(const ExternalSortConfig& other);
+    ExternalSortConfig(ExternalSortConfig&& other) noexcept;
+    ExternalSortConfig& operator=(const ExternalSortConfig& other);
+    ExternalSortConfig& operator=(ExternalSortConfig&& other) noexcept;
+    ~ExternalSortConfig();
+};
+
+/**
+ * @brief Sorts a file larger than memory: sorted runs first, then a k-way merge of the runs with a loser tree.
+ *
+ * Run formation reads memoryBytes / 12 ints at a time (memoryBytes / 14 with four or more workers), sorts them with
+ * the LSD radix sort (or the parallel sample sort when there are enough workers) and writes them out as a run while
+ * the next chunk is already being read. The budget is shared by the chunk, the read-ahead and the sort's scratch: a
+ * buffer as large as the chunk, plus a 16-bit bucket id per value for the sample sort. Only the sample sort's
+ * per-block bucket counts are left out; they take 256 bytes times the square of the worker count. The runs are then
+ * merged, each read through its own buffer with large sequential reads while the merged output is written from a
+ * second buffer in the background, so both passes stay close to disk speed. When there are more runs than the
+ * budget leaves buffers for, or than file handles allow, groups of runs are merged into longer intermediate runs
+ * first. A single run is written straight to the output.
+ *
+ * Every run, intermediate run and the output is planned when the sorter is constructed and reported as one Row,
+ * whose counters another thread may poll while sort() runs.
+ */
+class ExternalSorter {
+public:
+    enum class Phase : std::uint8_t { Ready, Forming, Merging, Done, Cancelled, Failed };
+
+    struct Row {
+        std::uint64_t length = 0;
+        std::atomic<std::uint64_t> written{0};
+        std::atomic<std::uint64_t> consumed{0};
+    };
+
+    /**
+     * @throws std::runtime_error if the input cannot be read or its size is not a whole number of ints.
+     */
+    explicit ExternalSorter(ExternalSortConfig config);
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+    /**
+     * @brief Removes whatever temporary runs a cancelled or failed sort left behind.
+     */
+    ~ExternalSorter();
+
+    /**
+     * @brief Runs the whole sort and blocks until the output is written or cancel() is called.
+     * @throws std::runtime_error if a file cannot be read or written.
+     */
+    void sort();
+    /**
+     * @brief Makes a running sort() stop at its next buffer and delete its files.
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] Phase phase() const { return phase_.load(std::memory_order_acquire); }
+    [[nodiscard]] std::uint64_t size() const { return size_; }
+    [[nodiscard]] std::size_t rowCount() const { return rowCount_; }
+    [[nodiscard]] const Row& row(std::size_t index) const { return rows_[index]; }
+    /**
+     * @brief Rows below this index are the runs made from the input; the last row is the output.
+     */
+    [[nodiscard]] std::size_t initialRuns() const { return initialRuns_; }
+    void printReport(std::ostream& out) const;
+
+private:
+    struct MergeStep {
+        std::vector<std::size_t> inputs;
+        std::size_t output;
+    };
+
+    [[nodiscard]] std::string rowPath(std::size_t index) const;
+    void formRuns();
+    void merge(const MergeStep& step);
+    void checkCancelled() const;
+    void removeTemporaries() const;
+
+    ExternalSortConfig config_;
+    std::uint64_t size_;
+    std::size_t runLength_;
+    std::size_t initialRuns_;
+    std::size_t rowCount_;
+    std::unique_ptr<Row[]> rows_;
+    std::vector<MergeStep> steps_;
+    std::atomic<Phase> phase_;
+    std::atomic<bool> cancelled_;
+    double formingSeconds_;
+    double mergingSeconds_;
+};
+
+
+#endif //ALGOVISUALIZER_EXTERNALSORT_H
@@ -0,0 +1,84 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "ExternalSortView.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    constexpr int MARGIN = 16;
+    constexpr int MAX_ROW_HEIGHT = 24;
+
+    /**
+     * @brief Width of the first count of length pixels, in 64-bit math since runs can hold billions of ints.
+     */
+    int scaled(std::uint64_t count, std::uint64_t length, int pixels) {
+        if (length == 0) return 0;
+        return static_cast<int>(std::min(count, length) * static_cast<std::uint64_t>(pixels) / length);
+    }
+}
+
+ExternalSortView::ExternalSortView(const ExternalSortConfig& config) :
+    sorter(config),
+    worker(),
+    screenWidth(0),
+    screenHeight(0) {
+    worker = std::jthread([this] {
+        try {
+            sorter.sort();
+        } catch (const std::exception& e) {
+            std::cerr << "External sort failed: " << e.what() << '\n';
+        }
+    });
+}
+
+ExternalSortView::~ExternalSortView() {
+    sorter.cancel();
+}
+
+void ExternalSortView::render(SDL_Renderer* renderer) {
+    const bool failed = sorter.phase() == ExternalSorter::Phase::Failed;
+    SDL_SetRenderDrawColor(renderer, failed ? 80 : 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    const std::size_t rows = sorter.rowCount();
+    std::uint64_t longest = 1;
+    for (std::size_t i = 0; i < rows; ++i) {
+        longest = std::max(longest, sorter.row(i).length);
+    }
+    // The output gets an extra row of space above it to set it apart from the runs.
+    const int slots = static_cast<int>(rows) + 1;
+    const int slotHeight = std::clamp((screenHeight - 2 * MARGIN) / slots, 1, MAX_ROW_HEIGHT);
+    const int barHeight = slotHeight > 4 ? slotHeight - 2 : slotHeight;
+    const int width = std::max(2 * MARGIN + 1, screenWidth) - 2 * MARGIN;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto& row = sorter.row(i);
+        const bool output = i + 1 == rows;
+        const int y = MARGIN + slotHeight * (static_cast<int>(i) + (output ? 1 : 0));
+        const int length = std::max(1, scaled(row.length, longest, width));
+        const int written = scaled(row.written.load(std::memory_order_relaxed), row.length, length);
+        const int consumed = scaled(row.consumed.load(std::memory_order_relaxed), row.length, length);
+
+        const SDL_Rect whole = {MARGIN, y, length, barHeight};
+        const SDL_Rect done = {MARGIN, y, written, barHeight};
+        const SDL_Rect read = {MARGIN, y, std::min(consumed, written), barHeight};
+        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+        SDL_RenderFillRect(renderer, &whole);
+        if (output) {
+            SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255);
+        } else if (i < sorter.initialRuns()) {
+            SDL_SetRenderDrawColor(renderer, 100, 149, 237, 255);
+        } else {
+            SDL_SetRenderDrawColor(renderer, 255, 165, 0, 255);
+        }
+        SDL_RenderFillRect(renderer, &done);
+        SDL_SetRenderDrawColor(renderer, 25, 25, 60, 255);
+        SDL_RenderFillRect(renderer, &read);
+    }
+    SDL_RenderPresent(renderer);
+}
+
+void ExternalSortView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+}
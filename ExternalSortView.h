@@ -0,0 +1,40 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_EXTERNALSORTVIEW_H
+#define ALGOVISUALIZER_EXTERNALSORTVIEW_H
+#include "ExternalSort.h"
+#include "IRenderable.hpp"
+#include <thread>
+
+/**
+ * @brief Runs an external sort on a worker thread and draws one bar per run instead of one per element.
+ *
+ * Bars are as long as their run. The runs cut from the input fill in blue as they are written, intermediate runs
+ * in orange and the output in green at the bottom; the part of a run the merge has already read turns dark. The
+ * background turns red if the sort fails. Closing the window cancels the sort.
+ */
+class ExternalSortView : public IRenderable {
+public:
+    explicit ExternalSortView(const ExternalSortConfig& config);
+    ExternalSortView(const ExternalSortView&) = delete;
+    ExternalSortView& operator=(const ExternalSortView&) = delete;
+    ~ExternalSortView() override;
+    void update() override {}
+    void render(SDL_Renderer* renderer) override;
+    void setScreenDimensions(int width, int height);
+    [[nodiscard]] const ExternalSorter& getSorter() const { return sorter; }
+
+private:
+    ExternalSorter sorter;
+    /**
+     * @brief Declared after sorter so it is joined before the sorter goes away.
+     */
+    std::jthread worker;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_EXTERNALSORTVIEW_H
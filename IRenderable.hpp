@@ -4,11 +4,17 @@
 
 #ifndef ALGOVISUALIZER_IRENDERABLE_HPP
 #define ALGOVISUALIZER_IRENDERABLE_HPP
+#include "PerfCounters.h"
 #include <SDL2/SDL.h>
 class IRenderable{
 public:
     virtual ~IRenderable() = default;
     virtual void update() = 0;
     virtual void render(SDL_Renderer* renderer) = 0;
+    virtual void handleEvent(const SDL_Event&) {}
+    /**
+     * @brief The view's last measured algorithm run, shown in the window overlay; null if it measures none.
+     */
+    [[nodiscard]] virtual const PerfRun* lastRun() const { return nullptr; }
 };
 #endif //ALGOVISUALIZER_IRENDERABLE_HPP
@@ -5,85 +5,69 @@
 #include "InsertionSort.h"
 
 #include "Constants.hpp"
-#include <cstdlib>
-#include <ctime>
+#include "SortRoutines.h"
 #include <iostream>
-
-InsertionSort::InsertionSort(int dataSize) :
-data(),
-currentIndex(1),
-keyIndex(0),
+#include <limits>
+
+InsertionSort::InsertionSort(const DataSpec& spec) :
+data(generateData(spec)),
+engine(),
+bars(),
+opsPerFrame(std::numeric_limits<std::size_t>::max()),
+frameBudget(std::chrono::milliseconds(4)),
+sortedEnd(0),
 sorting(false),
-dataSize_(dataSize),
+dataSize_(static_cast<int>(spec.size)),
 screenWidth(0),
 screenHeight(0),
 isComplete(false)
 {
-    srand(static_cast<unsigned>(time(nullptr)));
-    for(int i = 0; i < dataSize; i++){
-        int val = (rand() % 99) + 1;
-        data.push_back(val);
-    }
+    bars.setMaxValue(spec.maxValue);
+    bars.setColors(SDL_Color{173, 216, 230, 255},  // Light blue for the unsorted part
+                   SDL_Color{124, 252, 0, 255},    // Lawn green for the sorted part
+                   SDL_Color{255, 165, 0, 255});   // Orange for elements touched this frame
 }
 
 void InsertionSort::update() {
     if (isComplete) return;
     if (!sorting) {
-        sorting = true;
+        startSort();
         return;
     }
 
-    if (currentIndex < dataSize_) {
-        int key = data[static_cast<size_t>(currentIndex)];
-        keyIndex = currentIndex - 1;
-
-        while (keyIndex >= 0 && data[static_cast<unsigned long>(keyIndex)] > key) {
-            data[static_cast<size_t>(keyIndex + 1)] = data[static_cast<size_t>(keyIndex)];
-            keyIndex--;
-        }
-        data[static_cast<size_t>(keyIndex + 1)] = key;
-        currentIndex++;
-    } else {
+    engine.run(opsPerFrame, frameBudget);
+    bars.touch(engine.touched());
+    sortedEnd = static_cast<int>(engine.sortedEnd());
+    bars.setSortedRange(0, engine.sortedEnd());
+    if (!engine.running()) {
         isComplete = true;
         sorting = false;
     }
-
 }
 
 void InsertionSort::render(SDL_Renderer *renderer) {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
-
-    int barWidth = (screenWidth * 2) / (dataSize_ * 2) - 2;
-    for (int i = 0; i < dataSize_; ++i) {
-        int barHeight = data[static_cast<size_t>(i)] * (screenHeight / 100);
-        int barTop = screenHeight - barHeight;
-
-        // Change color based on the state
-        if (i == currentIndex) {
-            SDL_SetRenderDrawColor(renderer, 255, 165, 0, 255); // Orange for the current index
-        } else if (i <= currentIndex) {
-            SDL_SetRenderDrawColor(renderer, 124, 252, 0, 255); // Lawn green for sorted part
-        } else {
-            SDL_SetRenderDrawColor(renderer, 173, 216, 230, 255); // Light blue for unsorted part
-        }
-
-        SDL_Rect rect = {i * (barWidth + 2), barTop, barWidth, barHeight};
-        SDL_RenderFillRect(renderer, &rect);
-    }
-
-    // Additional rendering for text information can go here
-
+    bars.render(renderer, data);
     SDL_RenderPresent(renderer);
 }
 
 
 void InsertionSort::startSort() {
     sorting = true;
-    currentIndex = 1;
+    engine.start(insertionSortRoutine(data));
 }
 
 void InsertionSort::setScreenDimensions(int width, int height) {
     screenWidth = width;
     screenHeight = height;
+    bars.setScreenDimensions(width, height);
+}
+
+void InsertionSort::setOpsPerFrame(std::size_t ops) {
+    opsPerFrame = ops;
+}
+
+void InsertionSort::setFrameBudget(std::chrono::microseconds budget) {
+    frameBudget = budget;
 }
@@ -4,22 +4,34 @@
 
 #ifndef ALGOVISUALIZER_INSERTIONSORT_H
 #define ALGOVISUALIZER_INSERTIONSORT_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
 #include "IRenderable.hpp"
+#include "SortEngine.h"
+#include <chrono>
 #include <vector>
 
 class InsertionSort : public IRenderable{
 
 public:
-    InsertionSort(int dataSize);
+    explicit InsertionSort(const DataSpec& spec);
     void update() override;
     void render(SDL_Renderer* renderer) override;
     void startSort();
     void setScreenDimensions(int width, int height);
+    /**
+     * @brief Upper bound on sort steps per frame, unbounded by default; fewer are run once the frame budget runs out.
+     */
+    void setOpsPerFrame(std::size_t ops);
+    void setFrameBudget(std::chrono::microseconds budget);
 
 private:
     std::vector<int> data;
-    int currentIndex;
-    int keyIndex;
+    SortEngine engine;
+    BarRenderer bars;
+    std::size_t opsPerFrame;
+    std::chrono::microseconds frameBudget;
+    int sortedEnd;
     bool sorting;
     int dataSize_;
     int screenWidth;
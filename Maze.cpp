@@ -5,6 +5,7 @@
  * @author Renato Chavez
  */
 #include "Maze.hpp"
+#include "DeadEndFiller.hpp"
 #include <algorithm>
 #include <limits>
 #include <utility>
@@ -16,6 +17,10 @@
 #include <cstdlib>
 #include <queue>
 
+static_assert(Maze::TOP_WALL == DeadEndFiller::OPEN_TOP && Maze::RIGHT_WALL == DeadEndFiller::OPEN_RIGHT &&
+              Maze::BOTTOM_WALL == DeadEndFiller::OPEN_BOTTOM && Maze::LEFT_WALL == DeadEndFiller::OPEN_LEFT,
+              "DeadEndFiller must share the wall bit layout of Maze");
+
  std::array<Maze::Point, 4> Maze::directions = {{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
 
 /**
@@ -25,20 +30,22 @@
  *
  * @param rows Number of rows in the maze.
  * @param cols Number of columns in the maze.
+ * @param seed Optional seed for a reproducible maze.
  */
-Maze::Maze(int rows, int cols) :
+Maze::Maze(int rows, int cols, std::optional<std::uint64_t> seed) :
         farthestPoint_(),
         farthestPointSet_(),
         path_() ,
-        maze_(static_cast<unsigned long>(rows),
-    std::vector<Cell>(static_cast<unsigned long>(cols))),
+        cells_(static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols), ALL_WALLS),
         rows_(rows),
         cols_(cols),
+        seed_(seed),
         windowWidth_(0),
         windowHeight_(0),
         wallThickness_(0),
         startPosition_(),
-        startPositionSet_(false){
+        startPositionSet_(false),
+        lastRun_(){
 #ifndef ENABLE_LOGGIN
     BOOST_LOG_TRIVIAL(info) << "Creating Maze of size " << rows << "x" << cols;
 #endif
@@ -47,6 +54,8 @@ Maze::Maze(int rows, int cols) :
     generateMaze();
 //    fmt::print("Maze created and generated.\n");
 }
+
+Maze::~Maze() = default;
 /**
  * @brief Initializes the maze grid with default cell values.
  *
@@ -56,138 +65,111 @@ void Maze::initializeMaze() {
 #ifndef ENABLE_LOGGING
     BOOST_LOG_TRIVIAL(debug) << "Initializing Maze grid.";
 #endif
-    maze_.resize(static_cast<std::size_t>(rows_), std::vector<Cell>(static_cast<std::size_t>(cols_)));
-    for (auto& row : maze_) {
-        for (auto& cell : row) {
-            cell.visited = false;
-            cell.topWall = true;
-            cell.leftWall = true;
-            cell.bottomWall = true;
-            cell.rightWall = true;
-        }
-    }
+    cells_.assign(static_cast<std::size_t>(rows_) * static_cast<std::size_t>(cols_), ALL_WALLS);
 }
 /**
  * @brief Public interface to generate the maze structure.
  *
- * Initiates the recursive maze generation algorithm.
+ * Initiates the depth-first maze generation algorithm.
  */
 void Maze::generateMaze() {
 #ifndef ENABLE_LOGGING
     BOOST_LOG_TRIVIAL(info) << "Generating Maze.";
 #endif
     //std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    generateMazeRecursive(0, 0);
-    for (int r = 0; r < std::min(3, rows_); ++r) {
-        for (int c = 0; c < std::min(3, cols_); ++c) {
-//            fmt::print("Cell[{},{}]: Top:{} Left:{} Bottom:{} Right:{}\n",
-//                       r, c,
-//                       maze_[static_cast<unsigned long>(r)][static_cast<unsigned long>(c)].topWall,
-//                       maze_[static_cast<unsigned long>(r)][static_cast<unsigned long>(c)].leftWall,
-//                       maze_[static_cast<unsigned long>(r)][static_cast<unsigned long>(c)].bottomWall,
-//                       maze_[static_cast<unsigned long>(r)][static_cast<unsigned long>(c)].rightWall);
+    lastRun_ = {"generate", measurePerf([this] {
+        if(seed_){
+            std::mt19937_64 randomGen(*seed_);
+            carvePassages(0, 0, randomGen);
         }
-    }
+        else{
+            SodiumRandom randomGen;
+            carvePassages(0, 0, randomGen);
+        }
+    })};
 }
 /**
- * @brief Recursive algorithm to generate   the maze.
+ * @brief Iterative depth-first backtracker used to generate the maze.
  *
- * Randomly selects a direction and carves a path in the maze grid recursively.
+ * Carves a passage from the current cell to a random unvisited neighbour, or backtracks when there is none, which
+ * yields a perfect maze (exactly one path between any two cells). Instead of an explicit stack, every carved cell
+ * records the direction back to its parent in its spare bits, so generation needs no memory beyond the grid.
  *
- * @param r Row index for the current cell.
- * @param c Column index for the current cell.
+ * @param r Row index of the first cell.
+ * @param c Column index of the first cell.
+ * @param random Uniform random bit generator choosing the next neighbour.
  */
-void Maze::generateMazeRecursive(std::size_t r, std::size_t c) {
+template<typename Random>
+void Maze::carvePassages(std::size_t r, std::size_t c, Random& random) {
 #ifndef ENABLE_LOGGING
-    BOOST_LOG_TRIVIAL(trace) << "Generating maze at cell [" << r << ", " << c << "]";
+    BOOST_LOG_TRIVIAL(trace) << "Carving maze from cell [" << r << ", " << c << "]";
 #endif
-    //std::vector<std::pair<std::ptrdiff_t , std::ptrdiff_t>> directions = {{1,0}, {-1,0}, {0,1},{0,-1}};
-
-    SodiumRandom randomGen;
-
-    std::shuffle(directions.begin(), directions.end(), randomGen);
-
-    //std::default_random_engine randomGen(std::random_device{}());
-    //std::shuffle(directions.begin(), directions.end(), randomGen);
-
-    maze_[r][c].visited = true;
-
-    for(auto [dr, dc] : directions){
-        if (dr < 0){
-            // Underflow check
-            if (static_cast<std::size_t>(-dr) > r)
-                continue;
-        }
-        else{
-            // Overflow check
-            if (dr >= 0 && r > std::numeric_limits<std::size_t>::max() - static_cast<std::size_t>(dr))
-                continue;
+    const auto rows = static_cast<std::size_t>(rows_);
+    const auto cols = static_cast<std::size_t>(cols_);
+    const std::size_t start = r * cols + c;
+    constexpr std::array<std::uint8_t, 4> walls = {TOP_WALL, RIGHT_WALL, BOTTOM_WALL, LEFT_WALL};
+
+    std::size_t current = start;
+    cells_[current] |= VISITED;
+    while(true){
+        const std::size_t row = current / cols;
+        const std::size_t col = current % cols;
+        const std::array<bool, 4> open = {
+                row > 0 && !(cells_[current - cols] & VISITED),
+                col + 1 < cols && !(cells_[current + 1] & VISITED),
+                row + 1 < rows && !(cells_[current + cols] & VISITED),
+                col > 0 && !(cells_[current - 1] & VISITED)};
+        const std::array<std::size_t, 4> neighbours = {current - cols, current + 1, current + cols, current - 1};
+
+        std::array<std::size_t, 4> candidates{};
+        std::size_t count = 0;
+        for(std::size_t d = 0; d < 4; ++d){
+            if(open[d]) candidates[count++] = d;
         }
 
-        if (dc < 0){
-            // Underflow check
-            if (static_cast<std::size_t>(-dc) > c)
-                continue;
-        }
-        else{
-            // Overflow check
-            if (dc >= 0 && c > std::numeric_limits<std::size_t>::max() - static_cast<std::size_t>(dc))
-                continue;
-        }
-
-        std::size_t newR = r + static_cast<std::size_t>(dr);
-        std::size_t newC = c + static_cast<std::size_t>(dc);
-
-        if(newR < static_cast<std::size_t>(rows_) && newC < static_cast<std::size_t>(cols_) && !maze_[newR][newC].visited){
-            if(dr == -1){
-                maze_[r][c].topWall = false;
-                maze_[newR][newC].bottomWall = false;
-            }
-            if(dr == 1){
-                maze_[r][c].bottomWall = false;
-                maze_[newR][newC].topWall = false;
-            }
-            if(dc == -1){
-                maze_[r][c].leftWall = false;
-                maze_[newR][newC].rightWall = false;
-            }
-            if(dc == 1){
-                maze_[r][c].rightWall = false;
-                maze_[newR][newC].leftWall = false;
-            }
-            generateMazeRecursive(newR, newC);
+        if(count == 0){
+            if(current == start) break;
+            const auto parent = static_cast<std::size_t>((cells_[current] & PARENT_MASK) >> PARENT_SHIFT);
+            current = neighbours[parent];
+            continue;
         }
+        const std::size_t d = candidates[static_cast<std::size_t>(random() % count)];
+        const std::size_t next = neighbours[d];
+        const auto back = static_cast<std::uint8_t>((d + 2) % 4);
+        cells_[current] = static_cast<std::uint8_t>(cells_[current] & ~walls[d]);
+        cells_[next] = static_cast<std::uint8_t>((cells_[next] & ~walls[back]) | VISITED | (back << PARENT_SHIFT));
+        current = next;
     }
 }
 /**
- * @brief Returns a constant reference to the maze grid.
+ * @brief Returns a constant reference to the packed maze grid.
  *
- * @return Constant reference to the maze's 2D cell grid.
+ * @return Constant reference to the maze's cells, one byte per cell in row-major order.
  */
-const std::vector<std::vector<Maze::Cell>>& Maze::getMaze() const {
-    return maze_;
+const std::vector<std::uint8_t>& Maze::getCells() const {
+    return cells_;
 }
 
 void Maze::drawCell(std::size_t row, std::size_t col, int startX, int startY, int cellWidth, int cellHeight, int wallThickness, SDL_Renderer* renderer) {
-    const auto &cell = maze_[row][col];
+    const auto cell = cells_[row * static_cast<std::size_t>(cols_) + col];
     int x = startX + static_cast<int>(col) * cellWidth;
     int y = startY + static_cast<int>(row) * cellHeight;
 
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 
-    if (cell.topWall) {
+    if (cell & TOP_WALL) {
         SDL_Rect topWall = {x, y, cellWidth, wallThickness};
         SDL_RenderFillRect(renderer, &topWall);
     }
-    if (cell.leftWall) {
+    if (cell & LEFT_WALL) {
         SDL_Rect leftWall = {x, y, wallThickness, cellHeight};
         SDL_RenderFillRect(renderer, &leftWall);
     }
-    if (cell.bottomWall) {
+    if (cell & BOTTOM_WALL) {
         SDL_Rect bottomWall = {x, y + cellHeight - wallThickness, cellWidth, wallThickness};
         SDL_RenderFillRect(renderer, &bottomWall);
     }
-    if (cell.rightWall) {
+    if (cell & RIGHT_WALL) {
         SDL_Rect rightWall = {x + cellWidth - wallThickness, y, wallThickness, cellHeight};
         SDL_RenderFillRect(renderer, &rightWall);
     }
@@ -200,7 +182,7 @@ void Maze::render(SDL_Renderer* renderer){
     SDL_SetRenderDrawColor(renderer, 137, 196, 244, 255);
     SDL_RenderClear(renderer);
 
-    if(!maze_.size()){
+    if(cells_.empty()){
 #ifndef ENABLE_LOGGING
         BOOST_LOG_TRIVIAL(warning) << "Maze object is null. Rendering aborted.";
 #endif
@@ -281,11 +263,11 @@ void Maze::handleMouseClick(Sint32 mouseX, Sint32 mouseY, SDL_Window* sdlWindow)
 
     int buffer = wallThickness_;
 
-    const auto& clickedCell = maze_[static_cast<unsigned long>(row)][static_cast<unsigned long>(col)];
-    bool clickedOnWall = (clickedCell.topWall && mouseY < wallStartY + buffer) ||
-                         (clickedCell.bottomWall && mouseY > wallEndY - buffer) ||
-                         (clickedCell.leftWall && mouseX < wallStartX + buffer) ||
-                         (clickedCell.rightWall && mouseX > wallEndX - buffer);
+    const auto clickedCell = cells_[indexOf(Point(row, col))];
+    bool clickedOnWall = ((clickedCell & TOP_WALL) && mouseY < wallStartY + buffer) ||
+                         ((clickedCell & BOTTOM_WALL) && mouseY > wallEndY - buffer) ||
+                         ((clickedCell & LEFT_WALL) && mouseX < wallStartX + buffer) ||
+                         ((clickedCell & RIGHT_WALL) && mouseX > wallEndX - buffer);
 
     if (!clickedOnWall) {
         startPosition_ = std::make_pair(row, col);
@@ -296,7 +278,7 @@ void Maze::handleMouseClick(Sint32 mouseX, Sint32 mouseY, SDL_Window* sdlWindow)
 
         Point startPoint(row, col);
         Point endPoint(rows_ - 1, cols_ - 1); // Example endpoint, can be any point
-        findShortestPath(startPoint, endPoint);
+        lastRun_ = {"search", measurePerf([&] { findShortestPath(startPoint, endPoint); })};
     } else {
         SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Invalid Start Position", "Clicked on a wall.", sdlWindow);
         std::cout << "Invalid click detected on a wall.\n";
@@ -360,3 +342,16 @@ void Maze::findShortestPath(Point startPoint, Point endPoint) {
     farthestPointSet_ = true;
     traceBackPath(predecessor, startPoint, farthestPoint);
 }
+
+
+std::size_t Maze::solveByDeadEndFilling(Point startPoint, Point endPoint, unsigned threadCount) {
+    DeadEndFiller filler(cells_, static_cast<std::size_t>(rows_), static_cast<std::size_t>(cols_));
+    const std::size_t passes = filler.fill(indexOf(startPoint), indexOf(endPoint), threadCount);
+
+    path_.clear();
+    for (std::size_t index : filler.corridor(indexOf(startPoint), indexOf(endPoint))) {
+        path_.push_back(Point(static_cast<int>(index / static_cast<std::size_t>(cols_)),
+                              static_cast<int>(index % static_cast<std::size_t>(cols_))));
+    }
+    return passes;
+}
@@ -17,6 +17,8 @@
 #include <cryptopp/osrng.h>
 #include <sodium.h>
 #include <array>
+#include <cstdint>
+#include <optional>
 /**
  * @brief Represents a maze with cells and walls.
  *
@@ -53,27 +55,42 @@ public:
     std::vector<Point> path_;
 
     static  std::array<Point, 4> directions;
-    struct Cell {
-        bool visited;
-        bool topWall;
-        bool leftWall;
-        bool bottomWall;
-        bool rightWall;
-        bool isBlocked(const Point& direction) const {
-            if(direction.row == -1 && topWall) return true;
-            if(direction.row == 1 && bottomWall) return true;
-            if(direction.col == -1 && leftWall) return true;
-            if(direction.col == 1 && rightWall) return true;
-            return false;
-        }
-    };
+    /**
+     * @brief Wall and state bits packed into one byte per cell.
+     *
+     * The four wall bits are laid out clockwise so that the opposite wall of any bit is a two bit rotation.
+     */
+    static constexpr std::uint8_t TOP_WALL = 0x01;
+    static constexpr std::uint8_t RIGHT_WALL = 0x02;
+    static constexpr std::uint8_t BOTTOM_WALL = 0x04;
+    static constexpr std::uint8_t LEFT_WALL = 0x08;
+    static constexpr std::uint8_t ALL_WALLS = 0x0F;
+    static constexpr std::uint8_t VISITED = 0x10;
+    /**
+     * @brief Direction back to the parent cell during generation, as an index into top, right, bottom, left.
+     */
+    static constexpr std::uint8_t PARENT_MASK = 0x60;
+    static constexpr int PARENT_SHIFT = 5;
+
+    static constexpr std::uint8_t oppositeWall(std::uint8_t wall) {
+        return static_cast<std::uint8_t>(((wall << 2) | (wall >> 2)) & ALL_WALLS);
+    }
+    static std::uint8_t wallToward(const Point& direction) {
+        if(direction.row == -1) return TOP_WALL;
+        if(direction.row == 1) return BOTTOM_WALL;
+        if(direction.col == -1) return LEFT_WALL;
+        if(direction.col == 1) return RIGHT_WALL;
+        return 0;
+    }
 
     /**
      * @brief Constructs a Maze object with specified dimensions.
      * @param rows Number of rows in the maze.
      * @param cols Number of columns in the maze.
+     * @param seed Seed for a reproducible maze; without one the maze is drawn from libsodium's random source.
      */
-    Maze(int rows, int cols);
+    Maze(int rows, int cols, std::optional<std::uint64_t> seed = std::nullopt);
+    ~Maze() override;
     /**
      * @brief Generates the maze structure.
      *
@@ -83,9 +100,19 @@ public:
 
     [[nodiscard]] int getRows() const { return rows_; }
     [[nodiscard]] int getCols() const { return cols_; }
-    [[nodiscard]] const std::vector<std::vector<Cell>>& getMaze() const;
+    /**
+     * @brief Returns the packed cells, one byte of wall bits per cell in row-major order.
+     */
+    [[nodiscard]] const std::vector<std::uint8_t>& getCells() const;
+    [[nodiscard]] std::size_t indexOf(const Point& p) const {
+        return static_cast<std::size_t>(p.row) * static_cast<std::size_t>(cols_) + static_cast<std::size_t>(p.col);
+    }
     void update() override{}
     void render(SDL_Renderer* renderer) override;
+    /**
+     * @brief Counters of the last generation or search.
+     */
+    [[nodiscard]] const PerfRun* lastRun() const override { return &lastRun_; }
     void setScreenDimensions(int screenWidth, int screenHeight);
     void handleMouseClick(Sint32 mouseX, Sint32 mouseY, SDL_Window* sdlWindow);
     [[nodiscard]] std::pair<int, int> getStartPosition() const {
@@ -97,10 +124,21 @@ public:
         return p.row >= 0 && p.row < rows_ && p.col >= 0 && p.col < cols_;
     }
     bool isWall(const Point& current, const Point& direction) const {
-
-        return maze_[static_cast<unsigned long>(current.row)][static_cast<unsigned long>(current.col)].isBlocked(direction);
+        return (cells_[indexOf(current)] & wallToward(direction)) != 0;
     }
     void traceBackPath(const std::map<Point, Point>& predecessor, const Point& start, const Point& end);
+    /**
+     * @brief Solves the maze by dead-end filling instead of a breadth-first search.
+     *
+     * Every cell except the two endpoints that is enclosed by three walls is filled, repeatedly, until only the
+     * corridor between the endpoints is left. The corridor is then stored as the current path.
+     *
+     * @param startPoint Cell the corridor starts at.
+     * @param endPoint Cell the corridor ends at.
+     * @param threadCount Number of row strips swept in parallel.
+     * @return Number of fill passes needed.
+     */
+    std::size_t solveByDeadEndFilling(Point startPoint, Point endPoint, unsigned threadCount = 1);
 
 private:
     /**
@@ -110,18 +148,23 @@ private:
      */
     void initializeMaze();
     /**
-     * @brief Recursive function to generate the maze.
+     * @brief Depth-first backtracker that carves the maze.
+     *
+     * Backtracks through parent directions stored in the cells instead of recursing, so that large mazes neither
+     * overflow the call stack nor need a separate stack.
      *
-     * @param r Row index for the current cell.
-     * @param c Column index for the current cell.
+     * @param r Row index of the first cell.
+     * @param c Column index of the first cell.
+     * @param random Uniform random bit generator choosing the next neighbour.
      */
-    void generateMazeRecursive(std::size_t r, std::size_t c);
+    template<typename Random>
+    void carvePassages(std::size_t r, std::size_t c, Random& random);
 
     /**
-     * @brief 2D grid representing the maze.
-     * A vector of vectorof cells, where each cell represents a position in the maze.
+     * @brief Packed grid representing the maze.
+     * One byte per cell in row-major order, holding the wall bits, the visited flag and the parent direction.
      */
-    std::vector<std::vector<Cell>> maze_;
+    std::vector<std::uint8_t> cells_;
     /**
      * @brief Number of rows in the maze.
      */
@@ -130,12 +173,17 @@ private:
      * @brief Number of columns in the maze.
      */
     int cols_;
+    /**
+     * @brief Seed used by generateMaze(), if the maze is reproducible.
+     */
+    std::optional<std::uint64_t> seed_;
     int windowWidth_;
     int windowHeight_;
     int wallThickness_;
 
     std::pair<int, int> startPosition_;
     bool startPositionSet_;
+    PerfRun lastRun_;
 
     void drawCell(std::size_t row, std::size_t col, int startX, int startY, int cellWidth, int cellHeight, int wallThickness, SDL_Renderer* sdlRenderer);
 
@@ -0,0 +1,297 @@
+/**
+ * @file MazeExporter.cpp
+ * @brief
+ * @date Created on 19-10-26
+ * @author Renato Chavez
+ */
+#define ZLIB_CONST
+#include "MazeExporter.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fmt/core.h>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <zlib.h>
+
+namespace {
+    constexpr std::array<std::array<std::uint8_t, 3>, 3> PALETTE = {{
+        {137, 196, 244}, // BACKGROUND, same light blue as Maze::render
+        {0, 0, 0},       // WALL
+        {128, 0, 128},   // PATH
+    }};
+
+    /**
+     * @brief Minimal PNG encoder that deflates scanlines as they arrive and emits them as IDAT chunks.
+     */
+    class PngStream {
+    public:
+        PngStream(const std::string& path, std::uint32_t width, std::uint32_t height) :
+                out_(path, std::ios::binary),
+                stream_(),
+                deflated_(1u << 16),
+                width_(width) {
+            if (!out_) {
+                throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+            }
+            if (deflateInit(&stream_, Z_BEST_SPEED) != Z_OK) {
+                throw std::runtime_error("Failed to initialize zlib");
+            }
+            static constexpr std::array<std::uint8_t, 8> SIGNATURE = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+            out_.write(reinterpret_cast<const char*>(SIGNATURE.data()), SIGNATURE.size());
+
+            std::array<std::uint8_t, 13> header{};
+            putBigEndian(header.data(), width);
+            putBigEndian(header.data() + 4, height);
+            header[8] = 8;  // bit depth
+            header[9] = 3;  // indexed color
+            writeChunk("IHDR", header.data(), header.size());
+
+            std::array<std::uint8_t, PALETTE.size() * 3> palette{};
+            for (std::size_t i = 0; i < PALETTE.size(); ++i) {
+                std::copy(PALETTE[i].begin(), PALETTE[i].end(), palette.begin() + static_cast<std::ptrdiff_t>(i * 3));
+            }
+            writeChunk("PLTE", palette.data(), palette.size());
+        }
+        PngStream(const PngStream&) = delete;
+        PngStream& operator=(const PngStream&) = delete;
+        ~PngStream() {
+            deflateEnd(&stream_);
+        }
+
+        void writeRow(const std::uint8_t* row) {
+            static constexpr std::uint8_t FILTER_NONE = 0;
+            deflateBytes(&FILTER_NONE, 1, Z_NO_FLUSH);
+            deflateBytes(row, width_, Z_NO_FLUSH);
+        }
+
+        void finish() {
+            deflateBytes(nullptr, 0, Z_FINISH);
+            writeChunk("IEND", nullptr, 0);
+            out_.flush();
+            if (!out_) {
+                throw std::runtime_error("Failed to write PNG data");
+            }
+        }
+
+    private:
+        static void putBigEndian(std::uint8_t* destination, std::uint32_t value) {
+            destination[0] = static_cast<std::uint8_t>(value >> 24);
+            destination[1] = static_cast<std::uint8_t>(value >> 16);
+            destination[2] = static_cast<std::uint8_t>(value >> 8);
+            destination[3] = static_cast<std::uint8_t>(value);
+        }
+
+        void writeChunk(const char* type, const std::uint8_t* data, std::size_t size) {
+            std::array<std::uint8_t, 4> field{};
+            putBigEndian(field.data(), static_cast<std::uint32_t>(size));
+            out_.write(reinterpret_cast<const char*>(field.data()), field.size());
+            out_.write(type, 4);
+            uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+            if (size > 0) {
+                out_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+                crc = crc32(crc, data, static_cast<uInt>(size));
+            }
+            putBigEndian(field.data(), static_cast<std::uint32_t>(crc));
+            out_.write(reinterpret_cast<const char*>(field.data()), field.size());
+        }
+
+        void deflateBytes(const std::uint8_t* data, std::size_t size, int flush) {
+            stream_.next_in = data;
+            stream_.avail_in = static_cast<uInt>(size);
+            do {
+                stream_.next_out = deflated_.data();
+                stream_.avail_out = static_cast<uInt>(deflated_.size());
+                if (deflate(&stream_, flush) == Z_STREAM_ERROR) {
+                    throw std::runtime_error("zlib failed to deflate PNG data");
+                }
+                const std::size_t produced = deflated_.size() - stream_.avail_out;
+                if (produced > 0) {
+                    writeChunk("IDAT", deflated_.data(), produced);
+                }
+            } while (stream_.avail_out == 0 || (flush == Z_FINISH && stream_.avail_in != 0));
+        }
+
+        std::ofstream out_;
+        z_stream stream_;
+        std::vector<std::uint8_t> deflated_;
+        std::uint32_t width_;
+    };
+
+    /**
+     * @brief Fills a rectangle given in image coordinates, clipped to the tile starting at image row tileY.
+     */
+    void fillRect(std::vector<std::uint8_t>& pixels, std::size_t width, std::size_t tileY, std::size_t x, std::size_t y,
+                  std::size_t w, std::size_t h, std::uint8_t color) {
+        const std::size_t tileHeight = pixels.size() / width;
+        const std::size_t top = std::max(y, tileY);
+        const std::size_t bottom = std::min(y + h, tileY + tileHeight);
+        const std::size_t right = std::min(x + w, width);
+        for (std::size_t py = top; py < bottom && x < right; ++py) {
+            std::memset(pixels.data() + (py - tileY) * width + x, color, right - x);
+        }
+    }
+}
+
+MazeExporter::MazeExporter(const Maze& maze, int cellSize, int wallThickness) :
+        maze_(maze),
+        rows_(static_cast<std::size_t>(maze.getRows())),
+        cols_(static_cast<std::size_t>(maze.getCols())),
+        cellSize_(static_cast<std::size_t>(std::max(cellSize, 0))),
+        wallThickness_(static_cast<std::size_t>(std::max(wallThickness, 0))),
+        pathSegments_() {
+    if (cellSize <= 0 || wallThickness <= 0 || 2 * wallThickness > cellSize) {
+        throw std::invalid_argument(fmt::format("Invalid export sizes: cell {} px, wall {} px", cellSize, wallThickness));
+    }
+    const auto& path = maze_.path_;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        const auto& a = path[i - 1];
+        const auto& b = path[i];
+        pathSegments_.push_back({static_cast<std::size_t>(std::min(a.row, b.row)),
+                                 static_cast<std::size_t>(std::min(a.col, b.col)), a.col == b.col});
+    }
+    std::sort(pathSegments_.begin(), pathSegments_.end(),
+              [](const PathSegment& a, const PathSegment& b) { return a.row < b.row; });
+}
+
+void MazeExporter::rasterizeTile(std::size_t firstRow, std::size_t rowCount, std::vector<std::uint8_t>& pixels) const {
+    const std::size_t width = cols_ * cellSize_;
+    const std::size_t cs = cellSize_;
+    const std::size_t t = wallThickness_;
+    const std::size_t tileY = firstRow * cs;
+    pixels.assign(rowCount * cs * width, BACKGROUND);
+
+    const auto& cells = maze_.getCells();
+    for (std::size_t r = firstRow; r < firstRow + rowCount; ++r) {
+        for (std::size_t c = 0; c < cols_; ++c) {
+            const auto cell = cells[r * cols_ + c];
+            const std::size_t x = c * cs;
+            const std::size_t y = r * cs;
+            if (cell & Maze::TOP_WALL) fillRect(pixels, width, tileY, x, y, cs, t, WALL);
+            if (cell & Maze::LEFT_WALL) fillRect(pixels, width, tileY, x, y, t, cs, WALL);
+            if (cell & Maze::BOTTOM_WALL) fillRect(pixels, width, tileY, x, y + cs - t, cs, t, WALL);
+            if (cell & Maze::RIGHT_WALL) fillRect(pixels, width, tileY, x + cs - t, y, t, cs, WALL);
+        }
+    }
+
+    // A segment reaches one cell below its row, so segments starting one row above the tile can cross it.
+    const std::size_t lineWidth = std::max<std::size_t>(1, cs / 4);
+    auto first = std::lower_bound(pathSegments_.begin(), pathSegments_.end(), firstRow == 0 ? 0 : firstRow - 1,
+                                  [](const PathSegment& segment, std::size_t row) { return segment.row < row; });
+    for (auto it = first; it != pathSegments_.end() && it->row < firstRow + rowCount; ++it) {
+        const std::size_t cx = it->col * cs + cs / 2 - lineWidth / 2;
+        const std::size_t cy = it->row * cs + cs / 2 - lineWidth / 2;
+        if (it->vertical) {
+            fillRect(pixels, width, tileY, cx, cy, lineWidth, cs + lineWidth, PATH);
+        } else {
+            fillRect(pixels, width, tileY, cx, cy, cs + lineWidth, lineWidth, PATH);
+        }
+    }
+}
+
+void MazeExporter::exportPng(const std::string& path, unsigned threadCount, std::size_t tileBytes) const {
+    const std::size_t width = cols_ * cellSize_;
+    PngStream png(path, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(rows_ * cellSize_));
+
+    threadCount = std::max(threadCount, 1u);
+    const std::size_t tileRows = std::max<std::size_t>(1, tileBytes / (width * cellSize_));
+    std::vector<std::vector<std::uint8_t>> tiles(threadCount);
+
+    for (std::size_t batchRow = 0; batchRow < rows_; batchRow += tileRows * threadCount) {
+        std::vector<std::jthread> workers;
+        std::size_t batchTiles = 0;
+        for (std::size_t row = batchRow; row < rows_ && batchTiles < threadCount; row += tileRows, ++batchTiles) {
+            const std::size_t count = std::min(tileRows, rows_ - row);
+            if (batchTiles + 1 < threadCount && row + count < rows_) {
+                workers.emplace_back([this, row, count, &tile = tiles[batchTiles]] { rasterizeTile(row, count, tile); });
+            } else {
+                rasterizeTile(row, count, tiles[batchTiles]);
+            }
+        }
+        workers.clear();
+
+        for (std::size_t i = 0; i < batchTiles; ++i) {
+            for (std::size_t offset = 0; offset < tiles[i].size(); offset += width) {
+                png.writeRow(tiles[i].data() + offset);
+            }
+        }
+    }
+    png.finish();
+}
+
+void MazeExporter::exportSvg(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+    }
+    const std::size_t cs = cellSize_;
+    const std::size_t width = cols_ * cs;
+    const std::size_t height = rows_ * cs;
+    const auto& cells = maze_.getCells();
+
+    out << fmt::format("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"{0}\" height=\"{1}\" viewBox=\"0 0 {0} {1}\">\n"
+                       "<rect width=\"{0}\" height=\"{1}\" fill=\"rgb({2},{3},{4})\"/>\n"
+                       "<path fill=\"none\" stroke=\"black\" stroke-width=\"{5}\" stroke-linecap=\"square\" d=\"",
+                       width, height, PALETTE[BACKGROUND][0], PALETTE[BACKGROUND][1], PALETTE[BACKGROUND][2],
+                       wallThickness_);
+
+    std::string buffer;
+    auto flushBuffer = [&](std::size_t threshold) {
+        if (buffer.size() >= threshold) {
+            out << buffer;
+            buffer.clear();
+        }
+    };
+    auto hasWall = [&](std::size_t r, std::size_t c, std::uint8_t wall) {
+        return (cells[r * cols_ + c] & wall) != 0;
+    };
+
+    // Vertical runs can span many rows, so only their start row is kept per boundary column.
+    constexpr std::size_t NO_RUN = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> verticalRunStart(cols_ + 1, NO_RUN);
+
+    for (std::size_t boundary = 0; boundary <= rows_; ++boundary) {
+        // Horizontal runs along the line between row boundary - 1 and row boundary.
+        std::size_t runStart = NO_RUN;
+        for (std::size_t c = 0; c <= cols_; ++c) {
+            const bool wall = c < cols_ && ((boundary < rows_ && hasWall(boundary, c, Maze::TOP_WALL)) ||
+                                            (boundary > 0 && hasWall(boundary - 1, c, Maze::BOTTOM_WALL)));
+            if (wall && runStart == NO_RUN) {
+                runStart = c;
+            } else if (!wall && runStart != NO_RUN) {
+                buffer += fmt::format("M{} {}H{}", runStart * cs, boundary * cs, c * cs);
+                runStart = NO_RUN;
+            }
+        }
+        // Vertical runs through row boundary, closed by the first row without a wall.
+        for (std::size_t c = 0; c <= cols_; ++c) {
+            const bool wall = boundary < rows_ && ((c < cols_ && hasWall(boundary, c, Maze::LEFT_WALL)) ||
+                                                   (c > 0 && hasWall(boundary, c - 1, Maze::RIGHT_WALL)));
+            if (wall && verticalRunStart[c] == NO_RUN) {
+                verticalRunStart[c] = boundary;
+            } else if (!wall && verticalRunStart[c] != NO_RUN) {
+                buffer += fmt::format("M{} {}V{}", c * cs, verticalRunStart[c] * cs, boundary * cs);
+                verticalRunStart[c] = NO_RUN;
+            }
+        }
+        flushBuffer(1u << 16);
+    }
+    buffer += "\"/>\n";
+
+    if (!maze_.path_.empty()) {
+        buffer += fmt::format("<polyline fill=\"none\" stroke=\"rgb({},{},{})\" stroke-width=\"{}\" points=\"",
+                              PALETTE[PATH][0], PALETTE[PATH][1], PALETTE[PATH][2], std::max<std::size_t>(1, cs / 4));
+        for (const auto& point : maze_.path_) {
+            buffer += fmt::format("{},{} ", static_cast<std::size_t>(point.col) * cs + cs / 2,
+                                  static_cast<std::size_t>(point.row) * cs + cs / 2);
+            flushBuffer(1u << 16);
+        }
+        buffer += "\"/>\n";
+    }
+    buffer += "</svg>\n";
+    flushBuffer(0);
+    if (!out) {
+        throw std::runtime_error(fmt::format("Failed to write {}", path));
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file MazeExporter.hpp
+ * @brief Class definition for MazeExporter, which writes mazes to PNG or SVG without a window.
+ * @date Created on 19-10-26.
+ * @author Renato Chavez
+ */
+#ifndef ALGOVISUALIZER_MAZEEXPORTER_HPP
+#define ALGOVISUALIZER_MAZEEXPORTER_HPP
+#include "Maze.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streams a Maze to an image file one horizontal tile at a time.
+ *
+ * Only a bounded number of tiles is held in memory at once, so the memory used does not depend on the number of
+ * maze rows. No SDL window or renderer is involved; the walls are laid out the same way Maze::render draws them.
+ */
+class MazeExporter {
+public:
+    /**
+     * @brief Palette indices used in the rasterized tiles.
+     */
+    static constexpr std::uint8_t BACKGROUND = 0;
+    static constexpr std::uint8_t WALL = 1;
+    static constexpr std::uint8_t PATH = 2;
+
+    /**
+     * @brief Constructs an exporter for the given maze.
+     * @param maze Maze to export, which must outlive the exporter.
+     * @param cellSize Size of one cell in pixels.
+     * @param wallThickness Thickness of a wall in pixels.
+     * @throws std::invalid_argument if the sizes are not positive or the walls do not fit in a cell.
+     */
+    MazeExporter(const Maze& maze, int cellSize, int wallThickness);
+    /**
+     * @brief Writes the maze as an indexed-color PNG, streaming deflated scanlines to disk.
+     *
+     * Tiles are rasterized in parallel in batches of threadCount and written in order.
+     *
+     * @param path Destination file.
+     * @param threadCount Number of tiles rasterized at once.
+     * @param tileBytes Approximate size of one rasterized tile.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void exportPng(const std::string& path, unsigned threadCount = 1, std::size_t tileBytes = 4u << 20) const;
+    /**
+     * @brief Writes the maze as an SVG, merging neighbouring wall segments into single runs.
+     * @param path Destination file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void exportSvg(const std::string& path) const;
+
+private:
+    /**
+     * @brief A piece of the solution path between two neighbouring cells, stored from the top/left cell.
+     */
+    struct PathSegment {
+        std::size_t row;
+        std::size_t col;
+        bool vertical;
+    };
+
+    /**
+     * @brief Rasterizes maze rows [firstRow, firstRow + rowCount) into palette indices.
+     */
+    void rasterizeTile(std::size_t firstRow, std::size_t rowCount, std::vector<std::uint8_t>& pixels) const;
+
+    const Maze& maze_;
+    std::size_t rows_;
+    std::size_t cols_;
+    std::size_t cellSize_;
+    std::size_t wallThickness_;
+    /**
+     * @brief Path segments sorted by row, so each tile only looks at the ones crossing it.
+     */
+    std::vector<PathSegment> pathSegments_;
+};
+#endif //ALGOVISUALIZER_MAZEEXPORTER_HPP
@@ -0,0 +1,282 @@
+/**
+ * @file MazePipeline.cpp
+ * @brief
+ * @date Created on 19-10-26
+ * @author Renato Chavez
+ */
+#include "MazePipeline.hpp"
+#include "BoundedQueue.h"
+#include "Maze.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fmt/core.h>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct MazeJob {
+        std::uint64_t id;
+        std::uint64_t seed;
+        std::unique_ptr<Maze> maze;
+        std::uint32_t pathLength;
+        std::uint32_t pathTurns;
+        std::uint32_t deadEnds;
+        std::uint32_t junctions;
+    };
+    using JobPtr = std::unique_ptr<MazeJob>;
+    using JobQueue = BoundedQueue<JobPtr>;
+
+    /**
+     * @brief Per-stage counters, updated by every worker of the stage.
+     */
+    struct StageCounters {
+        std::atomic<std::size_t> processed{0};
+        std::atomic<std::int64_t> busyNanos{0};
+        std::atomic<std::int64_t> starvedNanos{0};
+        std::atomic<std::int64_t> stalledNanos{0};
+        /**
+         * @brief Workers still running; the last one to leave closes the stage's output.
+         */
+        std::atomic<unsigned> active{0};
+        std::atomic<bool> finished{false};
+    };
+
+    std::int64_t nanosSince(Clock::time_point begin) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+    }
+
+    /**
+     * @brief Pops the next job, yielding while the queue is empty. Returns false once the producing stage has
+     * finished and the queue is drained.
+     */
+    bool popJob(JobQueue& queue, const StageCounters& producer, StageCounters& consumer, JobPtr& job) {
+        const auto begin = Clock::now();
+        while (!queue.tryPop(job)) {
+            if (producer.finished.load(std::memory_order_acquire)) {
+                // finished is set after the producer's last push, so one more pop settles the race.
+                const bool popped = queue.tryPop(job);
+                consumer.starvedNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+                return popped;
+            }
+            std::this_thread::yield();
+        }
+        consumer.starvedNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+        return true;
+    }
+
+    void pushJob(JobQueue& queue, StageCounters& producer, JobPtr& job) {
+        const auto begin = Clock::now();
+        while (!queue.tryPush(job)) {
+            std::this_thread::yield();
+        }
+        producer.stalledNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+    }
+
+    void leaveStage(StageCounters& stage) {
+        if (stage.active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            stage.finished.store(true, std::memory_order_release);
+        }
+    }
+
+    void solve(MazeJob& job) {
+        Maze& maze = *job.maze;
+        maze.findShortestPath(Maze::Point(0, 0), Maze::Point(maze.getRows() - 1, maze.getCols() - 1));
+    }
+
+    void analyze(MazeJob& job) {
+        const Maze& maze = *job.maze;
+        job.deadEnds = 0;
+        job.junctions = 0;
+        for (const auto cell : maze.getCells()) {
+            const int walls = std::popcount(static_cast<unsigned>(cell & Maze::ALL_WALLS));
+            job.deadEnds += walls == 3 ? 1u : 0u;
+            job.junctions += walls <= 1 ? 1u : 0u;
+        }
+        const auto& path = maze.path_;
+        job.pathLength = static_cast<std::uint32_t>(path.size());
+        job.pathTurns = 0;
+        for (std::size_t i = 2; i < path.size(); ++i) {
+            const bool straight = (path[i].row - path[i - 1].row == path[i - 1].row - path[i - 2].row) &&
+                                  (path[i].col - path[i - 1].col == path[i - 1].col - path[i - 2].col);
+            job.pathTurns += straight ? 0u : 1u;
+        }
+    }
+
+    template<typename Integer>
+    void writeLittleEndian(std::ofstream& out, Integer value) {
+        for (std::size_t i = 0; i < sizeof(Integer); ++i) {
+            out.put(static_cast<char>(static_cast<std::uint64_t>(value) >> (8 * i)));
+        }
+    }
+
+    void serialize(std::ofstream& out, const MazeJob& job, std::vector<std::uint8_t>& packed) {
+        const Maze& maze = *job.maze;
+        writeLittleEndian(out, job.id);
+        writeLittleEndian(out, job.seed);
+        writeLittleEndian(out, static_cast<std::uint32_t>(maze.getRows()));
+        writeLittleEndian(out, static_cast<std::uint32_t>(maze.getCols()));
+        writeLittleEndian(out, job.pathLength);
+        writeLittleEndian(out, job.pathTurns);
+        writeLittleEndian(out, job.deadEnds);
+        writeLittleEndian(out, job.junctions);
+
+        const auto& cells = maze.getCells();
+        packed.assign((cells.size() + 1) / 2, 0);
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            packed[i / 2] = static_cast<std::uint8_t>(packed[i / 2] | ((cells[i] & Maze::ALL_WALLS) << (4 * (i % 2))));
+        }
+        out.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+    }
+}
+
+MazePipeline::MazePipeline(MazeBatchConfig config) :
+        config_(std::move(config)),
+        elapsedSeconds_(0.0),
+        stages_(),
+        queues_() {
+    config_.generators = std::max(config_.generators, 1u);
+    config_.solvers = std::max(config_.solvers, 1u);
+    config_.analyzers = std::max(config_.analyzers, 1u);
+}
+
+MazePipeline::~MazePipeline() = default;
+
+void MazePipeline::run() {
+    std::ofstream out(config_.outputPath, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error(fmt::format("Failed to open {} for writing", config_.outputPath));
+    }
+    out.write("AMZB", 4);
+    writeLittleEndian(out, std::uint32_t{1});
+    writeLittleEndian(out, std::uint64_t{config_.count});
+
+    JobQueue generated(config_.queueCapacity);
+    JobQueue solved(config_.queueCapacity);
+    JobQueue analyzed(config_.queueCapacity);
+    const std::array<const JobQueue*, 3> queues = {&generated, &solved, &analyzed};
+    std::array<StageCounters, 4> counters;
+    auto& [generating, solving, analyzing, writing] = counters;
+    generating.active = config_.generators;
+    solving.active = config_.solvers;
+    analyzing.active = config_.analyzers;
+    writing.active = 1;
+
+    std::atomic<std::size_t> nextId{0};
+    auto generator = [&] {
+        for (std::size_t id = nextId++; id < config_.count; id = nextId++) {
+            const auto begin = Clock::now();
+            auto job = std::make_unique<MazeJob>(MazeJob{id, config_.seed + id, nullptr, 0, 0, 0, 0});
+            job->maze = std::make_unique<Maze>(config_.rows, config_.cols, job->seed);
+            generating.busyNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+            generating.processed.fetch_add(1, std::memory_order_relaxed);
+            pushJob(generated, generating, job);
+        }
+        leaveStage(generating);
+    };
+    auto transform = [](JobQueue& input, StageCounters& producer, StageCounters& self, JobQueue& output,
+                        void (*work)(MazeJob&)) {
+        JobPtr job;
+        while (popJob(input, producer, self, job)) {
+            const auto begin = Clock::now();
+            work(*job);
+            self.busyNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+            self.processed.fetch_add(1, std::memory_order_relaxed);
+            pushJob(output, self, job);
+        }
+        leaveStage(self);
+    };
+    auto writer = [&] {
+        JobPtr job;
+        std::vector<std::uint8_t> packed;
+        // Parallel stages finish jobs out of order; the few that arrive early wait here so records keep id order.
+        std::map<std::uint64_t, JobPtr> pending;
+        std::uint64_t nextRecord = 0;
+        while (popJob(analyzed, analyzing, writing, job)) {
+            const auto begin = Clock::now();
+            pending.emplace(job->id, std::move(job));
+            for (auto it = pending.begin(); it != pending.end() && it->first == nextRecord; ++nextRecord) {
+                serialize(out, *it->second, packed);
+                it = pending.erase(it);
+                writing.processed.fetch_add(1, std::memory_order_relaxed);
+            }
+            writing.busyNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+        }
+        leaveStage(writing);
+    };
+
+    std::array<std::size_t, 3> occupancySum{};
+    std::array<std::size_t, 3> occupancyMax{};
+    std::size_t samples = 0;
+    const auto begin = Clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned i = 0; i < config_.generators; ++i) workers.emplace_back(generator);
+        for (unsigned i = 0; i < config_.solvers; ++i) {
+            workers.emplace_back(transform, std::ref(generated), std::ref(generating), std::ref(solving),
+                                 std::ref(solved), &solve);
+        }
+        for (unsigned i = 0; i < config_.analyzers; ++i) {
+            workers.emplace_back(transform, std::ref(solved), std::ref(solving), std::ref(analyzing),
+                                 std::ref(analyzed), &analyze);
+        }
+        workers.emplace_back(writer);
+
+        while (!writing.finished.load(std::memory_order_acquire)) {
+            for (std::size_t q = 0; q < queues.size(); ++q) {
+                const std::size_t size = queues[q]->size();
+                occupancySum[q] += size;
+                occupancyMax[q] = std::max(occupancyMax[q], size);
+            }
+            ++samples;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    elapsedSeconds_ = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    out.flush();
+    if (!out) {
+        throw std::runtime_error(fmt::format("Failed to write {}", config_.outputPath));
+    }
+
+    const std::array<const char*, 4> stageNames = {"generate", "solve", "analyze", "serialize"};
+    const std::array<unsigned, 4> stageWorkers = {config_.generators, config_.solvers, config_.analyzers, 1};
+    stages_.clear();
+    for (std::size_t s = 0; s < counters.size(); ++s) {
+        stages_.push_back({stageNames[s], stageWorkers[s], counters[s].processed.load(),
+                           static_cast<double>(counters[s].busyNanos.load()) / 1e9,
+                           static_cast<double>(counters[s].starvedNanos.load()) / 1e9,
+                           static_cast<double>(counters[s].stalledNanos.load()) / 1e9});
+    }
+    const std::array<const char*, 3> queueNames = {"generate->solve", "solve->analyze", "analyze->serialize"};
+    queues_.clear();
+    for (std::size_t q = 0; q < queues.size(); ++q) {
+        queues_.push_back({queueNames[q], queues[q]->capacity(),
+                           samples ? static_cast<double>(occupancySum[q]) / static_cast<double>(samples) : 0.0,
+                           occupancyMax[q]});
+    }
+}
+
+void MazePipeline::printReport(std::ostream& out) const {
+    out << fmt::format("{} mazes of {}x{} in {:.3f}s ({:.1f} mazes/s)\n", config_.count, config_.rows, config_.cols,
+                       elapsedSeconds_, elapsedSeconds_ > 0 ? static_cast<double>(config_.count) / elapsedSeconds_ : 0.0);
+    out << fmt::format("{:<10} {:>7} {:>9} {:>14} {:>10} {:>10} {:>10}\n", "stage", "workers", "items",
+                       "items/s/worker", "busy s", "starved s", "stalled s");
+    for (const auto& stage : stages_) {
+        const double rate = stage.busySeconds > 0 ? static_cast<double>(stage.processed) / stage.busySeconds : 0.0;
+        out << fmt::format("{:<10} {:>7} {:>9} {:>14.1f} {:>10.3f} {:>10.3f} {:>10.3f}\n", stage.name, stage.workers,
+                           stage.processed, rate, stage.busySeconds, stage.starvedSeconds, stage.stalledSeconds);
+    }
+    out << fmt::format("{:<20} {:>8} {:>10} {:>8}\n", "queue", "capacity", "mean occ.", "max occ.");
+    for (const auto& queue : queues_) {
+        out << fmt::format("{:<20} {:>8} {:>10.1f} {:>8}\n", queue.name, queue.capacity, queue.meanOccupancy,
+                           queue.maxOccupancy);
+    }
+}
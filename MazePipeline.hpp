@@ -0,0 +1,77 @@
+/**
+ * @file MazePipeline.hpp
+ * @brief Class definition for MazePipeline, a headless generate, solve, analyze and serialize batch.
+ * @date Created on 19-10-26.
+ * @author Renato Chavez
+ */
+#ifndef ALGOVISUALIZER_MAZEPIPELINE_HPP
+#define ALGOVISUALIZER_MAZEPIPELINE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parameters of one batch run.
+ */
+struct MazeBatchConfig {
+    std::size_t count = 1000;
+    int rows = 64;
+    int cols = 64;
+    /**
+     * @brief Maze i is generated from seed + i, so a batch is reproducible.
+     */
+    std::uint64_t seed = 1;
+    std::string outputPath = "mazes.bin";
+    unsigned generators = 1;
+    unsigned solvers = 1;
+    unsigned analyzers = 1;
+    std::size_t queueCapacity = 64;
+};
+
+/**
+ * @brief Produces many mazes as a pipeline of stages connected by bounded lock-free queues.
+ *
+ * Generation, solving and analysis each run on their own pool of workers; serialization runs on a single writer
+ * so records reach the file without locking. No SDL window is created. While the batch runs, the calling thread
+ * samples queue occupancy, and afterwards printReport() shows per-stage throughput together with the time each
+ * stage spent starved for input or stalled on a full output queue, which points at the bottleneck stage.
+ *
+ * File layout: the magic "AMZB", a u32 version and a u64 record count, followed by one record per maze in id
+ * order, whatever the worker counts, holding its id, seed, dimensions, analytics and the wall bits packed two
+ * cells per byte. Integers are little-endian.
+ */
+class MazePipeline {
+public:
+    struct StageReport {
+        std::string name;
+        unsigned workers;
+        std::size_t processed;
+        double busySeconds;
+        double starvedSeconds;
+        double stalledSeconds;
+    };
+    struct QueueReport {
+        std::string name;
+        std::size_t capacity;
+        double meanOccupancy;
+        std::size_t maxOccupancy;
+    };
+
+    explicit MazePipeline(MazeBatchConfig config);
+    ~MazePipeline();
+    /**
+     * @brief Runs the whole batch and blocks until the last record is written.
+     * @throws std::runtime_error if the output file cannot be written.
+     */
+    void run();
+    void printReport(std::ostream& out) const;
+
+private:
+    MazeBatchConfig config_;
+    double elapsedSeconds_;
+    std::vector<StageReport> stages_;
+    std::vector<QueueReport> queues_;
+};
+#endif //ALGOVISUALIZER_MAZEPIPELINE_HPP
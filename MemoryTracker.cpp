@@ -0,0 +1,45 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    std::atomic<std::size_t> inUse{0};
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::uint64_t> allocationCount{0};
+    std::atomic<std::uint64_t> allocatedTotal{0};
+}
+
+void MemoryTracker::recordAllocation(std::size_t bytes) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedTotal.fetch_add(bytes, std::memory_order_relaxed);
+    const std::size_t now = inUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t highest = peak.load(std::memory_order_relaxed);
+    while (now > highest && !peak.compare_exchange_weak(highest, now, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryTracker::recordRelease(std::size_t bytes) noexcept {
+    inUse.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::MemoryTracker() noexcept :
+    baseline_(inUse.load(std::memory_order_relaxed)),
+    allocationsBefore_(allocationCount.load(std::memory_order_relaxed)),
+    allocatedBytesBefore_(allocatedTotal.load(std::memory_order_relaxed)) {
+    peak.store(baseline_, std::memory_order_relaxed);
+}
+
+std::size_t MemoryTracker::peakBytes() const noexcept {
+    return std::max(peak.load(std::memory_order_relaxed), baseline_) - baseline_;
+}
+
+std::uint64_t MemoryTracker::allocations() const noexcept {
+    return allocationCount.load(std::memory_order_relaxed) - allocationsBefore_;
+}
+
+std::uint64_t MemoryTracker::allocatedBytes() const noexcept {
+    return allocatedTotal.load(std::memory_order_relaxed) - allocatedBytesBefore_;
+}
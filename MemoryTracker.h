@@ -0,0 +1,43 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_MEMORYTRACKER_H
+#define ALGOVISUALIZER_MEMORYTRACKER_H
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Heap bytes in use and their peak, for measuring how much auxiliary memory an algorithm takes.
+ *
+ * The counts only move when a program replaces the global operator new and delete and reports every allocation and
+ * release through recordAllocation and recordRelease, as sort_bench does; a release has to be reported with the same
+ * size as its allocation, e.g. the allocator's usable size of the block. A tracker measures from its construction:
+ * it resets the global peak to the bytes in use then, so trackers must not overlap, and everything the program
+ * allocates meanwhile counts, on any thread.
+ */
+class MemoryTracker {
+public:
+    static void recordAllocation(std::size_t bytes) noexcept;
+    static void recordRelease(std::size_t bytes) noexcept;
+
+    MemoryTracker() noexcept;
+
+    /**
+     * @brief Most bytes in use at once since construction, beyond those in use at construction.
+     */
+    [[nodiscard]] std::size_t peakBytes() const noexcept;
+    /**
+     * @brief Number and total size of the allocations since construction.
+     */
+    [[nodiscard]] std::uint64_t allocations() const noexcept;
+    [[nodiscard]] std::uint64_t allocatedBytes() const noexcept;
+
+private:
+    std::size_t baseline_;
+    std::uint64_t allocationsBefore_;
+    std::uint64_t allocatedBytesBefore_;
+};
+
+
+#endif //ALGOVISUALIZER_MEMORYTRACKER_H
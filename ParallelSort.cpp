@@ -0,0 +1,33 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "ParallelSort.h"
+
+SortWriteLog::SortWriteLog(unsigned workers) :
+    // One extra log for writes made outside the pool.
+    logs_(workers + 1),
+    sequence_(0) {
+}
+
+void SortWriteLog::wrote(std::size_t position, const int* values, std::size_t count) {
+    const int worker = WorkStealingPool::currentWorker();
+    const auto index = worker >= 0 && static_cast<std::size_t>(worker) + 1 < logs_.size()
+                       ? static_cast<std::size_t>(worker) : logs_.size() - 1;
+    WorkerLog& log = logs_[index];
+    log.events.push_back({sequence_.fetch_add(1, std::memory_order_relaxed), static_cast<unsigned>(index), position,
+                          count, log.values.size()});
+    log.values.insert(log.values.end(), values, values + count);
+}
+
+std::vector<SortWriteLog::Event> SortWriteLog::events() const {
+    std::vector<Event> merged;
+    for (const auto& log : logs_) {
+        merged.insert(merged.end(), log.events.begin(), log.events.end());
+    }
+    std::sort(merged.begin(), merged.end(), [](const Event& a, const Event& b) { return a.sequence < b.sequence; });
+    return merged;
+}
+
+const int* SortWriteLog::values(const Event& event) const {
+    return logs_[event.worker].values.data() + event.valueOffset;
+}
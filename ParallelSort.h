@@ -0,0 +1,236 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_PARALLELSORT_H
+#define ALGOVISUALIZER_PARALLELSORT_H
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Observer that records nothing; calls to it compile away.
+ *
+ * The parallel sorts report every block of final or intermediate values they write as wrote(position, values,
+ * count), where position is the index in the array the values belong at. Observers are called concurrently from
+ * all workers.
+ */
+struct NullSortObserver {
+    void wrote(std::size_t, const int*, std::size_t) {}
+};
+
+/**
+ * @brief Observer that logs which worker wrote which values where, for replaying a parallel sort.
+ *
+ * Each worker appends to its own log, so recording takes no locks; a shared counter orders the writes.
+ */
+class SortWriteLog {
+public:
+    struct Event {
+        std::uint64_t sequence;
+        unsigned worker;
+        std::size_t position;
+        std::size_t count;
+        std::size_t valueOffset;
+    };
+
+    explicit SortWriteLog(unsigned workers);
+    SortWriteLog(const SortWriteLog&) = delete;
+    SortWriteLog& operator=(const SortWriteLog&) = delete;
+
+    void wrote(std::size_t position, const int* values, std::size_t count);
+    /**
+     * @brief All writes of every worker in the order they completed.
+     */
+    [[nodiscard]] std::vector<Event> events() const;
+    [[nodiscard]] const int* values(const Event& event) const;
+    [[nodiscard]] unsigned workers() const { return static_cast<unsigned>(logs_.size()); }
+
+private:
+    struct alignas(64) WorkerLog {
+        std::vector<Event> events{};
+        std::vector<int> values{};
+    };
+
+    std::vector<WorkerLog> logs_;
+    std::atomic<std::uint64_t> sequence_;
+};
+
+namespace parallel_sort_detail {
+    /**
+     * @brief Merges a and b into out, splitting around the median of the larger input while the work is large.
+     */
+    template<typename Observer>
+    void merge(WorkStealingPool& pool, const int* a, std::size_t aSize, const int* b, std::size_t bSize, int* out,
+               std::size_t position, Observer& observer, std::size_t grain) {
+        if (aSize < bSize) {
+            std::swap(a, b);
+            std::swap(aSize, bSize);
+        }
+        if (aSize + bSize <= grain) {
+            std::merge(a, a + aSize, b, b + bSize, out);
+            observer.wrote(position, out, aSize + bSize);
+            return;
+        }
+        const std::size_t aMiddle = aSize / 2;
+        const auto bMiddle = static_cast<std::size_t>(std::lower_bound(b, b + bSize, a[aMiddle]) - b);
+        const std::size_t split = aMiddle + bMiddle;
+        out[split] = a[aMiddle];
+        observer.wrote(position + split, out + split, 1);
+        pool.invoke([&] { merge(pool, a, aMiddle, b, bMiddle, out, position, observer, grain); },
+                    [&] {
+                        merge(pool, a + aMiddle + 1, aSize - aMiddle - 1, b + bMiddle, bSize - bMiddle, out + split + 1,
+                              position + split + 1, observer, grain);
+                    });
+    }
+
+    /**
+     * @brief Sorts [begin, end) of data and leaves the result in buffer if toBuffer, otherwise in data.
+     *
+     * The halves are sorted into the opposite array, so each level merges straight into its destination without
+     * copying back.
+     */
+    template<typename Observer>
+    void mergeSort(WorkStealingPool& pool, int* data, int* buffer, std::size_t begin, std::size_t end, bool toBuffer,
+                   Observer& observer, std::size_t grain) {
+        if (end - begin <= grain) {
+            std::sort(data + begin, data + end);
+            if (toBuffer) {
+                std::copy(data + begin, data + end, buffer + begin);
+            }
+            observer.wrote(begin, (toBuffer ? buffer : data) + begin, end - begin);
+            return;
+        }
+        const std::size_t middle = begin + (end - begin) / 2;
+        pool.invoke([&] { mergeSort(pool, data, buffer, begin, middle, !toBuffer, observer, grain); },
+                    [&] { mergeSort(pool, data, buffer, middle, end, !toBuffer, observer, grain); });
+        const int* from = toBuffer ? data : buffer;
+        int* to = toBuffer ? buffer : data;
+        merge(pool, from + begin, middle - begin, from + middle, end - middle, to + begin, begin, observer, grain);
+    }
+}
+
+/**
+ * @brief Default number of elements below which the parallel sorts stop forking.
+ */
+constexpr std::size_t PARALLEL_SORT_GRAIN = std::size_t{1} << 14;
+
+/**
+ * @brief Merge sort whose recursive calls and merges are forked onto a work-stealing pool.
+ *
+ * Leaves of at most grain elements are sorted with std::sort; merges split around the median of the larger run so
+ * they parallelize too. Needs a buffer as large as the input.
+ */
+template<typename Observer = NullSortObserver>
+void parallelMergeSort(WorkStealingPool& pool, std::vector<int>& data, Observer&& observer = {},
+                       std::size_t grain = PARALLEL_SORT_GRAIN) {
+    if (data.size() < 2) return;
+    grain = std::max<std::size_t>(grain, 2);
+    std::vector<int> buffer(data.size());
+    pool.run([&] { parallel_sort_detail::mergeSort(pool, data.data(), buffer.data(), 0, data.size(), false, observer, grain); });
+}
+
+/**
+ * @brief Sample sort: splitters drawn from a sample cut the input into buckets that are then sorted independently.
+ *
+ * Blocks of the input are classified in parallel, a prefix sum over the per-block bucket counts gives every block
+ * its own slice of each bucket, and the blocks scatter into a buffer without synchronizing. Each bucket is then
+ * sorted and copied back by one task. Needs a buffer as large as the input. Heavily duplicated keys can leave one
+ * bucket much larger than the others.
+ */
+template<typename Observer = NullSortObserver>
+void sampleSort(WorkStealingPool& pool, std::vector<int>& data, Observer&& observer = {},
+                std::size_t grain = PARALLEL_SORT_GRAIN) {
+    const std::size_t size = data.size();
+    if (size < 2) return;
+    grain = std::max<std::size_t>(grain, 2);
+    if (size <= grain) {
+        pool.run([&] {
+            std::sort(data.begin(), data.end());
+            observer.wrote(0, data.data(), size);
+        });
+        return;
+    }
+
+    // Several buckets per worker so stealing can even out unlucky splitters.
+    const std::size_t bucketCount = std::min<std::size_t>(std::clamp<std::size_t>(size / grain, 2, std::size_t{8} * pool.size()),
+                                                          std::size_t{1} << 16);
+    constexpr std::size_t OVERSAMPLING = 32;
+    std::vector<int> sample;
+    sample.reserve(bucketCount * OVERSAMPLING);
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (std::size_t i = 0; i < bucketCount * OVERSAMPLING; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        sample.push_back(data[(state >> 33) % size]);
+    }
+    std::sort(sample.begin(), sample.end());
+    std::vector<int> splitters;
+    for (std::size_t i = 1; i < bucketCount; ++i) {
+        splitters.push_back(sample[i * OVERSAMPLING]);
+    }
+    auto bucketOf = [&](int value) {
+        return static_cast<std::size_t>(std::upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin());
+    };
+
+    const std::size_t blockCount = std::clamp<std::size_t>(size / grain, 1, std::size_t{4} * pool.size());
+    const std::size_t blockSize = (size + blockCount - 1) / blockCount;
+    // offsets[block * bucketCount + bucket]: first the counts, then where the block's part of the bucket starts.
+    std::vector<std::size_t> offsets(blockCount * bucketCount, 0);
+    std::vector<std::size_t> bucketStart(bucketCount + 1, 0);
+    std::vector<int> buffer(size);
+    // Bucket of every element, so the scatter pass does not search the splitters a second time.
+    std::vector<std::uint16_t> buckets(size);
+
+    pool.run([&] {
+        pool.parallelFor(0, blockCount, [&](std::size_t block) {
+            std::size_t* counts = offsets.data() + block * bucketCount;
+            const std::size_t end = std::min(size, (block + 1) * blockSize);
+            for (std::size_t i = block * blockSize; i < end; ++i) {
+                buckets[i] = static_cast<std::uint16_t>(bucketOf(data[i]));
+                ++counts[buckets[i]];
+            }
+        });
+
+        std::size_t total = 0;
+        for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+            bucketStart[bucket] = total;
+            for (std::size_t block = 0; block < blockCount; ++block) {
+                const std::size_t count = offsets[block * bucketCount + bucket];
+                offsets[block * bucketCount + bucket] = total;
+                total += count;
+            }
+        }
+        bucketStart[bucketCount] = total;
+
+        pool.parallelFor(0, blockCount, [&](std::size_t block) {
+            std::size_t* next = offsets.data() + block * bucketCount;
+            std::vector<std::size_t> first(next, next + bucketCount);
+            const std::size_t end = std::min(size, (block + 1) * blockSize);
+            for (std::size_t i = block * blockSize; i < end; ++i) {
+                buffer[next[buckets[i]]++] = data[i];
+            }
+            for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+                if (next[bucket] > first[bucket]) {
+                    observer.wrote(first[bucket], buffer.data() + first[bucket], next[bucket] - first[bucket]);
+                }
+            }
+        });
+
+        pool.parallelFor(0, bucketCount, [&](std::size_t bucket) {
+            const std::size_t begin = bucketStart[bucket];
+            const std::size_t end = bucketStart[bucket + 1];
+            std::sort(buffer.begin() + static_cast<std::ptrdiff_t>(begin), buffer.begin() + static_cast<std::ptrdiff_t>(end));
+            std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(begin), buffer.begin() + static_cast<std::ptrdiff_t>(end),
+                      data.begin() + static_cast<std::ptrdiff_t>(begin));
+            if (end > begin) {
+                observer.wrote(begin, data.data() + begin, end - begin);
+            }
+        });
+    });
+}
+
+
+#endif //ALGOVISUALIZER_PARALLELSORT_H
@@ -0,0 +1,108 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "ParallelSortView.h"
+#include <algorithm>
+
+namespace {
+    const std::vector<SDL_Color> WORKER_COLORS = {
+            {230, 25, 75, 255},   // Red
+            {60, 180, 75, 255},   // Green
+            {0, 130, 200, 255},   // Blue
+            {255, 225, 25, 255},  // Yellow
+            {245, 130, 48, 255},  // Orange
+            {145, 30, 180, 255},  // Purple
+            {70, 240, 240, 255},  // Cyan
+            {240, 50, 230, 255},  // Magenta
+    };
+    /**
+     * @brief Roughly how many frames one replay should take.
+     */
+    constexpr std::size_t REPLAY_FRAMES = 600;
+}
+
+ParallelSortView::ParallelSortView(const DataSpec& spec, unsigned threads) :
+    pool(threads),
+    algorithm(Algorithm::MergeSort),
+    data(),
+    owners(),
+    log(),
+    events(),
+    nextEvent(0),
+    eventsPerFrame(1),
+    bars(),
+    dataSpec(spec),
+    screenWidth(0),
+    screenHeight(0) {
+    bars.setMaxValue(spec.maxValue);
+    bars.setOwners(&owners, WORKER_COLORS);
+    start(algorithm);
+}
+
+void ParallelSortView::start(Algorithm newAlgorithm) {
+    algorithm = newAlgorithm;
+    data = generateData(dataSpec);
+    owners.assign(data.size(), BarRenderer::NO_OWNER);
+
+    // Small grains so every worker gets many tasks even on a few thousand elements.
+    const std::size_t grain = std::max<std::size_t>(8, data.size() / (std::size_t{16} * pool.size()));
+    std::vector<int> sorted = data;
+    log = std::make_unique<SortWriteLog>(pool.size());
+    if (algorithm == Algorithm::MergeSort) {
+        parallelMergeSort(pool, sorted, *log, grain);
+    } else {
+        sampleSort(pool, sorted, *log, grain);
+    }
+    events = log->events();
+    nextEvent = 0;
+    eventsPerFrame = std::max<std::size_t>(1, events.size() / REPLAY_FRAMES);
+    bars.invalidate();
+}
+
+void ParallelSortView::update() {
+    for (std::size_t applied = 0; applied < eventsPerFrame && nextEvent < events.size(); ++applied) {
+        const auto& event = events[nextEvent++];
+        const int* values = log->values(event);
+        std::copy(values, values + event.count, data.begin() + static_cast<std::ptrdiff_t>(event.position));
+        std::fill_n(owners.begin() + static_cast<std::ptrdiff_t>(event.position), event.count,
+                    static_cast<std::uint8_t>(event.worker % WORKER_COLORS.size()));
+        bars.invalidate(event.position, event.position + event.count);
+    }
+}
+
+void ParallelSortView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    SDL_RenderPresent(renderer);
+}
+
+void ParallelSortView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_m:
+            start(Algorithm::MergeSort);
+            break;
+        case SDLK_s:
+            start(Algorithm::SampleSort);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(algorithm);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(algorithm);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ParallelSortView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    bars.setScreenDimensions(width, height);
+}
@@ -0,0 +1,54 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_PARALLELSORTVIEW_H
+#define ALGOVISUALIZER_PARALLELSORTVIEW_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "ParallelSort.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Runs a parallel sort on its own pool, then replays the recorded writes with every worker in its own color.
+ *
+ * Elements keep the color of the worker that last wrote them, so a worker that got less of the array stands out.
+ * Keys: m replays the merge sort and s the sample sort on the same input, r restarts the current one on new data,
+ * and d switches to the next input distribution.
+ */
+class ParallelSortView : public IRenderable {
+public:
+    enum class Algorithm { MergeSort, SampleSort };
+
+    ParallelSortView(const DataSpec& spec, unsigned threads);
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Generates the input of the current spec, sorts it with algorithm while recording, and rewinds the
+     * replay.
+     */
+    void start(Algorithm algorithm);
+
+private:
+    WorkStealingPool pool;
+    Algorithm algorithm;
+    std::vector<int> data;
+    std::vector<std::uint8_t> owners;
+    std::unique_ptr<SortWriteLog> log;
+    std::vector<SortWriteLog::Event> events;
+    std::size_t nextEvent;
+    std::size_t eventsPerFrame;
+    BarRenderer bars;
+    DataSpec dataSpec;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_PARALLELSORTVIEW_H
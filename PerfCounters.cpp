@@ -0,0 +1,191 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cerrno>
+#include <fmt/core.h>
+#include <system_error>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::string formatCount(double count) {
+        if (count >= 1e9) return fmt::format("{:.2f}G", count / 1e9);
+        if (count >= 1e6) return fmt::format("{:.2f}M", count / 1e6);
+        if (count >= 1e4) return fmt::format("{:.1f}k", count / 1e3);
+        return fmt::format("{:.0f}", count);
+    }
+
+#ifdef __linux__
+    perf_event_attr eventAttributes(PerfEvent event) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        switch (event) {
+            case PerfEvent::Cycles:
+                attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfEvent::Instructions:
+                attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfEvent::BranchMisses:
+                attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case PerfEvent::L1Misses:
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case PerfEvent::LlcMisses:
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            default:
+                break;
+        }
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        return attributes;
+    }
+#endif
+}
+
+std::string_view perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::BranchMisses: return "branch-misses";
+        case PerfEvent::L1Misses: return "L1d-misses";
+        case PerfEvent::LlcMisses: return "LLC-misses";
+        default: return "unknown";
+    }
+}
+
+bool PerfSample::hasCounters() const {
+    return std::any_of(counts.begin(), counts.end(), [](const auto& count) { return count.has_value(); });
+}
+
+std::optional<double> PerfSample::ipc() const {
+    const auto cycles = count(PerfEvent::Cycles);
+    const auto instructions = count(PerfEvent::Instructions);
+    if (!cycles || !instructions || *cycles == 0) return std::nullopt;
+    return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+}
+
+std::optional<double> PerfSample::per(PerfEvent event, double divisor) const {
+    const auto value = count(event);
+    if (!value || divisor <= 0.0) return std::nullopt;
+    return static_cast<double>(*value) / divisor;
+}
+
+std::string PerfSample::summary() const {
+    std::string text = seconds < 1.0 ? fmt::format("{:.2f} ms", seconds * 1e3) : fmt::format("{:.2f} s", seconds);
+    if (!hasCounters()) {
+        return text + ", timing only";
+    }
+    for (const PerfEvent event : ALL_PERF_EVENTS) {
+        if (const auto value = count(event)) {
+            text += fmt::format(", {} {}", formatCount(static_cast<double>(*value)), perfEventName(event));
+        }
+        if (event == PerfEvent::Instructions) {
+            if (const auto perCycle = ipc()) text += fmt::format(", IPC {:.2f}", *perCycle);
+        }
+    }
+    return text;
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    seconds += other.seconds;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] && other.counts[i]) {
+            *counts[i] += *other.counts[i];
+        } else {
+            counts[i].reset();
+        }
+    }
+    return *this;
+}
+
+PerfCounters::PerfCounters() :
+    fds_(),
+    reason_() {
+    fds_.fill(-1);
+#ifdef __linux__
+    for (const PerfEvent event : ALL_PERF_EVENTS) {
+        perf_event_attr attributes = eventAttributes(event);
+        // This thread, any CPU, no group.
+        const long fd = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        if (fd >= 0) {
+            fds_[static_cast<std::size_t>(event)] = static_cast<int>(fd);
+        } else if (reason_.empty()) {
+            reason_ = fmt::format("{}: {}", perfEventName(event), std::system_category().message(errno));
+        }
+    }
+#else
+    reason_ = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+PerfCounters& PerfCounters::forThisThread() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+bool PerfCounters::available() const {
+    return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+}
+
+PerfCounters::Reading PerfCounters::read() const {
+    Reading reading;
+    readCounters(reading);
+    // Taken after the counters before a run and before them after it, so the reads are not timed.
+    reading.time = std::chrono::steady_clock::now();
+    return reading;
+}
+
+void PerfCounters::readCounters(Reading& reading) const {
+#ifdef __linux__
+    for (std::size_t i = 0; i < fds_.size(); ++i) {
+        if (fds_[i] < 0) continue;
+        if (::read(fds_[i], reading.values[i].data(), sizeof(reading.values[i])) !=
+            static_cast<ssize_t>(sizeof(reading.values[i]))) {
+            reading.values[i] = {};
+        }
+    }
+#else
+    static_cast<void>(reading);
+#endif
+}
+
+PerfSample PerfCounters::since(const Reading& before) const {
+    Reading after;
+    after.time = std::chrono::steady_clock::now();
+    readCounters(after);
+    PerfSample sample;
+    sample.seconds = std::chrono::duration<double>(after.time - before.time).count();
+    for (std::size_t i = 0; i < fds_.size(); ++i) {
+        if (fds_[i] < 0) continue;
+        const auto& [value, enabled, running] = after.values[i];
+        const auto& [valueBefore, enabledBefore, runningBefore] = before.values[i];
+        // The event never got a hardware counter during the run: no count rather than a guess.
+        if (running <= runningBefore) continue;
+        const double scale = static_cast<double>(enabled - enabledBefore) / static_cast<double>(running - runningBefore);
+        sample.counts[i] = static_cast<std::uint64_t>(static_cast<double>(value - valueBefore) * scale + 0.5);
+    }
+    return sample;
+}
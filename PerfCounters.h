@@ -0,0 +1,135 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_PERFCOUNTERS_H
+#define ALGOVISUALIZER_PERFCOUNTERS_H
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+enum class PerfEvent : std::uint8_t { Cycles, Instructions, BranchMisses, L1Misses, LlcMisses };
+
+constexpr std::array<PerfEvent, 5> ALL_PERF_EVENTS = {
+        PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::BranchMisses, PerfEvent::L1Misses, PerfEvent::LlcMisses,
+};
+
+/**
+ * @brief Short name used in reports and column headers, such as "branch-misses".
+ */
+std::string_view perfEventName(PerfEvent event);
+
+/**
+ * @brief Wall time and hardware event counts of one measured run; events that could not be counted are empty.
+ */
+struct PerfSample {
+    double seconds = 0.0;
+    std::array<std::optional<std::uint64_t>, ALL_PERF_EVENTS.size()> counts{};
+
+    [[nodiscard]] std::optional<std::uint64_t> count(PerfEvent event) const {
+        return counts[static_cast<std::size_t>(event)];
+    }
+    /**
+     * @brief Whether any event was counted, as opposed to a timing-only sample.
+     */
+    [[nodiscard]] bool hasCounters() const;
+    /**
+     * @brief Instructions per cycle, if both were counted.
+     */
+    [[nodiscard]] std::optional<double> ipc() const;
+    /**
+     * @brief count(event) divided by divisor, e.g. misses per element.
+     */
+    [[nodiscard]] std::optional<double> per(PerfEvent event, double divisor) const;
+    /**
+     * @brief One line such as "1.52 ms, 4.1M cycles, IPC 2.31, 12k branch-misses, ..." for overlays and logs.
+     */
+    [[nodiscard]] std::string summary() const;
+    /**
+     * @brief Adds other's time and counts; an event stays counted only if it was counted in both.
+     */
+    PerfSample& operator+=(const PerfSample& other);
+};
+
+/**
+ * @brief A labelled sample, such as the last maze generation, for the window overlay.
+ */
+struct PerfRun {
+    std::string label{};
+    PerfSample sample{};
+};
+
+/**
+ * @brief Hardware performance counters of the calling thread, read through Linux perf_event_open.
+ *
+ * The counters are opened once per thread, count user-space events only (which is what perf_event_paranoid 2, the
+ * usual default, allows) and run continuously; a measurement reads them before and after the run and subtracts, so
+ * measurements nest and cost a few reads. Counts are scaled when the kernel multiplexes more events than the PMU
+ * has counters. Work done on other threads, such as pool workers of a parallel sort, is not counted. Events that
+ * cannot be opened, on other platforms, without a PMU in a VM or when a container forbids the syscall, are left
+ * out; if none can be, samples hold the wall time only.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    /**
+     * @brief The counters of the calling thread, opened on first use.
+     */
+    static PerfCounters& forThisThread();
+
+    /**
+     * @brief Whether any event is counted.
+     */
+    [[nodiscard]] bool available() const;
+    [[nodiscard]] bool counts(PerfEvent event) const { return fds_[static_cast<std::size_t>(event)] >= 0; }
+    /**
+     * @brief Why the first event that failed to open is missing, or empty if all are counted.
+     */
+    [[nodiscard]] const std::string& unavailableReason() const { return reason_; }
+
+    /**
+     * @brief Runs function and returns its wall time and the events counted meanwhile.
+     */
+    template<typename Function>
+    PerfSample measure(Function&& function) {
+        const Reading before = read();
+        std::forward<Function>(function)();
+        return since(before);
+    }
+
+private:
+    /**
+     * @brief Raw value, time enabled and time running of every event, and the wall clock.
+     */
+    struct Reading {
+        std::chrono::steady_clock::time_point time{};
+        std::array<std::array<std::uint64_t, 3>, ALL_PERF_EVENTS.size()> values{};
+    };
+
+    [[nodiscard]] Reading read() const;
+    void readCounters(Reading& reading) const;
+    [[nodiscard]] PerfSample since(const Reading& before) const;
+
+    std::array<int, ALL_PERF_EVENTS.size()> fds_;
+    std::string reason_;
+};
+
+/**
+ * @brief Measures function with the calling thread's counters.
+ */
+template<typename Function>
+PerfSample measurePerf(Function&& function) {
+    return PerfCounters::forThisThread().measure(std::forward<Function>(function));
+}
+
+
+#endif //ALGOVISUALIZER_PERFCOUNTERS_H
@@ -2,47 +2,44 @@
 // Created by daily on 03-01-24.
 //
 #include "Piece.h"
+#include "TetrisBoard.h"
 
-Piece::Piece(int pieceType) : blocks(), type(pieceType) {
-    blocks.emplace_back(0, 0, type);
-    blocks.emplace_back(0, 1, type);
-    blocks.emplace_back(1, 0, type);
-    blocks.emplace_back(1, 1, type);
+Piece::Piece(int pieceType) :
+    type(pieceType),
+    rotation(0),
+    x((TetrisBoard::WIDTH - piece_tables::SHAPES[static_cast<std::size_t>(pieceType)].box) / 2),
+    // I lies in the second row of its box; lift it so it spawns in the top row like the others.
+    y(pieceType == 0 ? -1 : 0) {
 }
-Piece::Piece(const std::vector<Block>& newBlocks, int newType): blocks(newBlocks), type(newType){
-
-}
-void Piece::rotate() {
-    Block pivot = blocks[0];
-    for (auto& block : blocks) {
-        int newX = pivot.getX() - (block.getY() - pivot.getY());
-        int newY = pivot.getY() + (block.getX() - pivot.getX());
-        block.setX(newX);
-        block.setY(newY);
-    }
+Piece::Piece(int pieceType, int pieceRotation, int pieceX, int pieceY) :
+    type(pieceType), rotation(pieceRotation), x(pieceX), y(pieceY) {
 }
 
 void Piece::moveLeft() {
-    for (auto& block : blocks) {
-        block.setX(block.getX() - 1);
-    }
+    --x;
 }
 void Piece::moveRight() {
-    for (auto& block : blocks) {
-        block.setX(block.getX() + 1);
-    }
-}
-std::vector<Block> Piece::getBlocks() const {
-    return blocks;
-}
-int Piece::getType() const {
-    return type;
-}
-void Piece::setBlocks(const std::vector<Block>& newBlocks){
-    blocks = newBlocks;
+    ++x;
 }
 void Piece::dropBlocks() {
-    for (auto& block : blocks) {
-        block.setY(block.getY() + 1);
+    ++y;
+}
+Piece Piece::rotated(bool clockwise) const {
+    return Piece(type, (rotation + (clockwise ? 1 : piece_tables::ROTATIONS - 1)) % piece_tables::ROTATIONS, x, y);
+}
+std::span<const PieceOffset> Piece::kicks(bool clockwise) const {
+    const auto row = static_cast<std::size_t>(2 * rotation + (clockwise ? 0 : 1));
+    switch (type) {
+        case 0:
+            return piece_tables::I_KICKS[row];
+        case 1:
+            return piece_tables::NO_KICKS;
+        default:
+            return piece_tables::JLSTZ_KICKS[row];
     }
 }
+std::array<Block, piece_tables::CELLS> Piece::getBlocks() const {
+    const auto& cells = piece_tables::CELL_TABLE[static_cast<std::size_t>(type)][static_cast<std::size_t>(rotation)];
+    return {Block(x + cells[0].x, y + cells[0].y, type), Block(x + cells[1].x, y + cells[1].y, type),
+            Block(x + cells[2].x, y + cells[2].y, type), Block(x + cells[3].x, y + cells[3].y, type)};
+}
@@ -4,24 +4,160 @@
 
 #ifndef ALGOVISUALIZER_PIECE_H
 #define ALGOVISUALIZER_PIECE_H
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include "Block.h"
 
+/**
+ * @brief A cell of a piece within its bounding box, or a wall kick; x grows to the right and y downwards.
+ */
+struct PieceOffset {
+    int x;
+    int y;
+};
+
+namespace piece_tables {
+    constexpr int TYPES = 7;
+    constexpr int ROTATIONS = 4;
+    constexpr int CELLS = 4;
+    constexpr int KICKS = 5;
+
+    /**
+     * @brief A piece in its spawn rotation, inside a square box of side box that it rotates in.
+     */
+    struct Shape {
+        int box;
+        std::array<PieceOffset, CELLS> cells;
+    };
+
+    /**
+     * @brief The SRS spawn rotations of I, O, T, S, Z, J and L, in that order.
+     */
+    constexpr std::array<Shape, TYPES> SHAPES = {{
+        {4, {{{0, 1}, {1, 1}, {2, 1}, {3, 1}}}},
+        {2, {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}}},
+        {3, {{{1, 0}, {0, 1}, {1, 1}, {2, 1}}}},
+        {3, {{{1, 0}, {2, 0}, {0, 1}, {1, 1}}}},
+        {3, {{{0, 0}, {1, 0}, {1, 1}, {2, 1}}}},
+        {3, {{{0, 0}, {0, 1}, {1, 1}, {2, 1}}}},
+        {3, {{{2, 0}, {0, 1}, {1, 1}, {2, 1}}}},
+    }};
+
+    /**
+     * @brief Cells of every type in every rotation, each rotation a quarter turn clockwise within the box.
+     */
+    constexpr auto CELL_TABLE = [] {
+        std::array<std::array<std::array<PieceOffset, CELLS>, ROTATIONS>, TYPES> table{};
+        for (std::size_t type = 0; type < TYPES; ++type) {
+            const Shape& shape = SHAPES[type];
+            table[type][0] = shape.cells;
+            for (std::size_t rotation = 1; rotation < ROTATIONS; ++rotation) {
+                for (std::size_t cell = 0; cell < CELLS; ++cell) {
+                    const PieceOffset& previous = table[type][rotation - 1][cell];
+                    table[type][rotation][cell] = {shape.box - 1 - previous.y, previous.x};
+                }
+            }
+        }
+        return table;
+    }();
+
+    /**
+     * @brief The cells of CELL_TABLE as one occupancy mask per box row, bit x for column x, as TetrisBoard takes them.
+     */
+    constexpr auto ROW_TABLE = [] {
+        std::array<std::array<std::array<std::uint16_t, CELLS>, ROTATIONS>, TYPES> table{};
+        for (std::size_t type = 0; type < TYPES; ++type) {
+            for (std::size_t rotation = 0; rotation < ROTATIONS; ++rotation) {
+                for (const PieceOffset& cell : CELL_TABLE[type][rotation]) {
+                    auto& row = table[type][rotation][static_cast<std::size_t>(cell.y)];
+                    row = static_cast<std::uint16_t>(row | 1u << cell.x);
+                }
+            }
+        }
+        return table;
+    }();
+
+    /**
+     * @brief SRS wall kicks of J, L, S, T and Z, tried in order. Row 2 * rotation is the clockwise turn out of that
+     * rotation, row 2 * rotation + 1 the counter-clockwise one. With y pointing down, the usual tables' y is negated.
+     */
+    constexpr std::array<std::array<PieceOffset, KICKS>, 2 * ROTATIONS> JLSTZ_KICKS = {{
+        {{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}},  // 0 -> R
+        {{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},     // 0 -> L
+        {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},    // R -> 2
+        {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},    // R -> 0
+        {{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},     // 2 -> L
+        {{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}},  // 2 -> R
+        {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}}, // L -> 0
+        {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}}, // L -> 2
+    }};
+
+    /**
+     * @brief SRS wall kicks of I, laid out as JLSTZ_KICKS.
+     */
+    constexpr std::array<std::array<PieceOffset, KICKS>, 2 * ROTATIONS> I_KICKS = {{
+        {{{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}}},  // 0 -> R
+        {{{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}}},  // 0 -> L
+        {{{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}}},  // R -> 2
+        {{{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}}},  // R -> 0
+        {{{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}}},  // 2 -> L
+        {{{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}}},  // 2 -> R
+        {{{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}}},  // L -> 0
+        {{{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}}},  // L -> 2
+    }};
+
+    /**
+     * @brief O turns onto itself and never kicks.
+     */
+    constexpr std::array<PieceOffset, 1> NO_KICKS = {{{0, 0}}};
+}
+
+/**
+ * @brief A falling piece: its type, rotation and the position of its box's top left corner in the well.
+ *
+ * The cells and row masks of every rotation come from constexpr tables, so moving, rotating and reading a piece
+ * never allocates. Types 0 to 6 are I, O, T, S, Z, J and L.
+ */
 class Piece {
 public:
-    Piece(int type);
-    Piece(const std::vector<Block>& newBlocks, int newType);
-    void rotate();
+    /**
+     * @brief A piece of type in its spawn rotation, centered at the top of the well.
+     */
+    explicit Piece(int type);
+    Piece(int type, int rotation, int x, int y);
     void moveLeft();
     void moveRight();
-    std::vector<Block> getBlocks() const;
-    int getType() const;
-    void setBlocks(const std::vector<Block>& newBlocks);
     void dropBlocks();
+    /**
+     * @brief The same piece turned a quarter clockwise or counter-clockwise about its box, not yet kicked.
+     */
+    Piece rotated(bool clockwise) const;
+    /**
+     * @brief The SRS kicks to try, in order, after the turn rotated(clockwise) makes.
+     */
+    std::span<const PieceOffset> kicks(bool clockwise) const;
+    /**
+     * @brief The cells as blocks at their place in the well.
+     */
+    std::array<Block, piece_tables::CELLS> getBlocks() const;
+    /**
+     * @brief Occupancy masks of the box's rows, bit b for column getX() + b, row r for row getY() + r.
+     */
+    const std::array<std::uint16_t, piece_tables::CELLS>& getRows() const {
+        return piece_tables::ROW_TABLE[static_cast<std::size_t>(type)][static_cast<std::size_t>(rotation)];
+    }
+    int getType() const { return type; }
+    int getRotation() const { return rotation; }
+    int getX() const { return x; }
+    int getY() const { return y; }
 
 private:
-    std::vector<Block> blocks;
     int type;
+    int rotation;
+    int x;
+    int y;
 };
 
 
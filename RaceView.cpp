@@ -0,0 +1,460 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "RaceView.h"
+#include "BarRenderer.h"
+#include "Constants.hpp"
+#include "SnapshotBuffer.h"
+#include "SortInstrumentation.h"
+#include "SortRoutines.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fmt/core.h>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int LABEL_HEIGHT = 18;
+    constexpr int LABEL_FONT_SIZE = 13;
+    constexpr int LANE_GAP = 4;
+    /**
+     * @brief Lanes start together this long after the race is set up, once every worker has timed its native run.
+     */
+    constexpr auto START_DELAY = std::chrono::milliseconds(100);
+    constexpr auto PACING_SLEEP = std::chrono::milliseconds(2);
+    /**
+     * @brief Native runs are repeated this often and the fastest is kept; one run of a small array is too short
+     * to time on its own.
+     */
+    constexpr int NATIVE_REPEATS = 5;
+
+    /**
+     * @brief What a lane shows: its array and counters as of the last publish.
+     */
+    struct LaneSnapshot {
+        std::vector<int> data;
+        /**
+         * @brief Elements compared or changed since the previous snapshot.
+         */
+        std::vector<std::uint32_t> touched;
+        std::uint64_t sequence = 0;
+        unsigned long long comparisons = 0;
+        unsigned long long swaps = 0;
+        unsigned long long writes = 0;
+        std::size_t sortedBegin = 0;
+        std::size_t sortedEnd = 0;
+        double raceSeconds = 0.0;
+        double nativeSeconds = 0.0;
+        bool finished = false;
+    };
+
+    /**
+     * @brief Counts the operations of one lane's sort and holds the sort back to the shared rate.
+     *
+     * Whenever the sort gets ahead of the operations the elapsed race time allows, the pacer publishes a snapshot
+     * and sleeps. Stopping the lane makes the next push throw SortTraceCancelled out of the sort.
+     */
+    class LanePacer : public SortOpSink {
+    public:
+        LanePacer(SnapshotBuffer<LaneSnapshot>& snapshots, const std::atomic<double>& opsPerSecond,
+                  std::stop_token stop, Clock::time_point start, double nativeSeconds) :
+            snapshots_(snapshots),
+            opsPerSecond_(opsPerSecond),
+            stop_(std::move(stop)),
+            copy_(),
+            touched_(),
+            start_(start),
+            lastWake_(start),
+            nativeSeconds_(nativeSeconds),
+            ops_(0),
+            allowed_(0.0),
+            comparisons_(0),
+            swaps_(0),
+            writes_(0),
+            sortedBegin_(0),
+            sortedEnd_(0),
+            sequence_(0) {
+        }
+        ~LanePacer() override;
+
+        /**
+         * @brief The array snapshots are taken from; it has to outlive every push and finish().
+         */
+        template<typename T>
+        void watch(const std::vector<T>& values) {
+            copy_ = [&values](std::vector<int>& out) {
+                out.resize(values.size());
+                if constexpr (std::is_same_v<T, int>) {
+                    std::copy(values.begin(), values.end(), out.begin());
+                } else {
+                    std::transform(values.begin(), values.end(), out.begin(), [](const T& v) { return v.value(); });
+                }
+            };
+        }
+
+        /**
+         * @brief Shows the unsorted input until the race starts.
+         */
+        void waitForStart() {
+            publish(false);
+            while (Clock::now() < start_) {
+                if (stop_.stop_requested()) throw SortTraceCancelled();
+                std::this_thread::sleep_for(PACING_SLEEP);
+            }
+            lastWake_ = Clock::now();
+        }
+
+        void push(const SortOp& op) override {
+            switch (op.kind) {
+                case SortOp::Kind::Compare:
+                    ++comparisons_;
+                    touched_.push_back(op.i);
+                    touched_.push_back(op.j);
+                    break;
+                case SortOp::Kind::Swap:
+                    ++swaps_;
+                    touched_.push_back(op.i);
+                    touched_.push_back(op.j);
+                    break;
+                case SortOp::Kind::Write:
+                    ++writes_;
+                    touched_.push_back(op.i);
+                    break;
+                case SortOp::Kind::Sorted:
+                    sortedBegin_ = op.i;
+                    sortedEnd_ = op.j;
+                    return;
+                case SortOp::Kind::Run:
+                case SortOp::Kind::Fallback:
+                case SortOp::Kind::Window:
+                    return;
+                default:
+                    return;
+            }
+            if (static_cast<double>(++ops_) >= allowed_) {
+                publish(false);
+                do {
+                    if (stop_.stop_requested()) throw SortTraceCancelled();
+                    std::this_thread::sleep_for(PACING_SLEEP);
+                    const auto now = Clock::now();
+                    allowed_ += opsPerSecond_.load(std::memory_order_relaxed) *
+                                std::chrono::duration<double>(now - lastWake_).count();
+                    lastWake_ = now;
+                } while (static_cast<double>(ops_) >= allowed_);
+            }
+        }
+
+        void finish() { publish(true); }
+
+    private:
+        void publish(bool finished) {
+            LaneSnapshot& snapshot = snapshots_.back();
+            copy_(snapshot.data);
+            snapshot.touched.swap(touched_);
+            touched_.clear();
+            snapshot.sequence = ++sequence_;
+            snapshot.comparisons = comparisons_;
+            snapshot.swaps = swaps_;
+            snapshot.writes = writes_;
+            snapshot.sortedBegin = sortedBegin_;
+            snapshot.sortedEnd = sortedEnd_;
+            snapshot.raceSeconds = std::max(0.0, std::chrono::duration<double>(Clock::now() - start_).count());
+            snapshot.nativeSeconds = nativeSeconds_;
+            snapshot.finished = finished;
+            snapshots_.publish();
+        }
+
+        SnapshotBuffer<LaneSnapshot>& snapshots_;
+        const std::atomic<double>& opsPerSecond_;
+        std::stop_token stop_;
+        std::function<void(std::vector<int>&)> copy_;
+        std::vector<std::uint32_t> touched_;
+        Clock::time_point start_;
+        Clock::time_point lastWake_;
+        double nativeSeconds_;
+        unsigned long long ops_;
+        /**
+         * @brief Operations the elapsed race time allows so far.
+         */
+        double allowed_;
+        unsigned long long comparisons_;
+        unsigned long long swaps_;
+        unsigned long long writes_;
+        std::size_t sortedBegin_;
+        std::size_t sortedEnd_;
+        std::uint64_t sequence_;
+    };
+
+    LanePacer::~LanePacer() = default;
+
+    struct RaceAlgorithm {
+        std::string_view name;
+        /**
+         * @brief The sort on plain ints, timed without any tracing.
+         */
+        void (*native)(std::vector<int>&);
+        /**
+         * @brief The same sort reporting every operation to pacer.
+         */
+        void (*traced)(std::vector<int>&, LanePacer&);
+    };
+
+    template<SortRoutine (*Routine)(std::vector<int>&)>
+    RaceAlgorithm routineAlgorithm(std::string_view name) {
+        return {name,
+                [](std::vector<int>& data) {
+                    SortRoutine routine = Routine(data);
+                    while (routine.next()) {}
+                },
+                [](std::vector<int>& data, LanePacer& pacer) {
+                    pacer.watch(data);
+                    pacer.waitForStart();
+                    SortRoutine routine = Routine(data);
+                    while (routine.next()) pacer.push(routine.op());
+                    pacer.finish();
+                }};
+    }
+
+    /**
+     * @brief A standard library sort, given as one function template over the iterator type.
+     */
+    template<typename Sorter>
+    RaceAlgorithm countedAlgorithm(std::string_view name) {
+        return {name,
+                [](std::vector<int>& data) { Sorter{}(data.begin(), data.end()); },
+                [](std::vector<int>& data, LanePacer& pacer) {
+                    std::vector<counted<int>> values(data.begin(), data.end());
+                    pacer.watch(values);
+                    pacer.waitForStart();
+                    {
+                        SortTracer tracer(values.data(), values.size(), sizeof(counted<int>), pacer);
+                        Sorter{}(values.begin(), values.end());
+                        tracer.sorted(0, values.size());
+                    }
+                    pacer.finish();
+                }};
+    }
+
+    struct StdSorter {
+        template<typename Iterator>
+        void operator()(Iterator first, Iterator last) const { std::sort(first, last); }
+    };
+    struct StdStableSorter {
+        template<typename Iterator>
+        void operator()(Iterator first, Iterator last) const { std::stable_sort(first, last); }
+    };
+    struct HeapSorter {
+        template<typename Iterator>
+        void operator()(Iterator first, Iterator last) const {
+            std::make_heap(first, last);
+            std::sort_heap(first, last);
+        }
+    };
+
+    const std::array<RaceAlgorithm, 6>& raceAlgorithms() {
+        static const std::array<RaceAlgorithm, 6> algorithms = {
+                routineAlgorithm<&bubbleSortRoutine>("bubble"),
+                routineAlgorithm<&insertionSortRoutine>("insertion"),
+                routineAlgorithm<&bitonicSortRoutine>("bitonic"),
+                countedAlgorithm<StdSorter>("std::sort"),
+                countedAlgorithm<StdStableSorter>("std::stable_sort"),
+                countedAlgorithm<HeapSorter>("heap sort"),
+        };
+        return algorithms;
+    }
+
+    double timeNative(const RaceAlgorithm& algorithm, const std::vector<int>& input) {
+        double best = 0.0;
+        for (int repeat = 0; repeat < NATIVE_REPEATS; ++repeat) {
+            std::vector<int> data = input;
+            const auto begin = Clock::now();
+            algorithm.native(data);
+            const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            best = repeat == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    std::string formatCount(unsigned long long count) {
+        if (count >= 10'000'000) return fmt::format("{}M", count / 1'000'000);
+        if (count >= 10'000) return fmt::format("{}k", count / 1'000);
+        return std::to_string(count);
+    }
+}
+
+/**
+ * @brief One algorithm's worker thread, its snapshots and the bars drawing them.
+ */
+class RaceView::Lane {
+public:
+    Lane(const RaceAlgorithm& algorithm, std::vector<int> input, const std::atomic<double>& opsPerSecond,
+         Clock::time_point start) :
+        name(algorithm.name),
+        bars(),
+        rank(0),
+        snapshots(),
+        shownSequence(0),
+        worker([this, &algorithm, input = std::move(input), &opsPerSecond, start](std::stop_token stop) mutable {
+            LanePacer pacer(snapshots, opsPerSecond, std::move(stop), start, timeNative(algorithm, input));
+            try {
+                algorithm.traced(input, pacer);
+            } catch (const SortTraceCancelled&) {
+                // The race was restarted or the window closed.
+            }
+        }) {
+    }
+
+    /**
+     * @brief Takes the latest snapshot, if there is a new one, and marks what changed for the bars.
+     * @return Whether the lane finished with this snapshot.
+     */
+    bool update() {
+        const bool wasFinished = snapshot().finished;
+        if (!snapshots.update()) return false;
+        const LaneSnapshot& latest = snapshot();
+        // Touched indices only cover the step from the previous snapshot; after a skipped one redraw everything.
+        if (latest.sequence != shownSequence + 1) {
+            bars.invalidate();
+        }
+        bars.touch(latest.touched);
+        bars.setSortedRange(latest.sortedBegin, latest.sortedEnd);
+        shownSequence = latest.sequence;
+        return latest.finished && !wasFinished;
+    }
+
+    [[nodiscard]] const LaneSnapshot& snapshot() const { return snapshots.front(); }
+
+    std::string_view name;
+    BarRenderer bars;
+    /**
+     * @brief Finishing position, 0 while still running.
+     */
+    unsigned rank;
+
+private:
+    SnapshotBuffer<LaneSnapshot> snapshots;
+    std::uint64_t shownSequence;
+    /**
+     * @brief Declared last so it is joined before the snapshots it publishes to go away.
+     */
+    std::jthread worker;
+};
+
+RaceView::RaceView(const DataSpec& spec) :
+    dataSpec(spec),
+    // About two seconds for std::sort, which makes a few operations per element and level.
+    opsPerSecond(static_cast<double>(std::max<std::size_t>(spec.size, 1)) * 16.0),
+    lanes(),
+    finishedLanes(0),
+    font(TTF_OpenFont(Constants::FONT_PATH, LABEL_FONT_SIZE)),
+    screenWidth(0),
+    screenHeight(0) {
+    start();
+}
+
+RaceView::~RaceView() {
+    lanes.clear();
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+void RaceView::start() {
+    // Joining the old workers first keeps them off the CPU while the new ones time their native runs.
+    lanes.clear();
+    const std::vector<int> input = generateData(dataSpec);
+    const auto raceStart = Clock::now() + START_DELAY;
+    for (const auto& algorithm : raceAlgorithms()) {
+        auto lane = std::make_unique<Lane>(algorithm, input, opsPerSecond, raceStart);
+        lane->bars.setMaxValue(dataSpec.maxValue);
+        lane->bars.setColors(SDL_Color{255, 255, 255, 255},  // White for bars not yet in their final place
+                             SDL_Color{0, 255, 0, 255},      // Green once the lane reports them final
+                             SDL_Color{255, 0, 0, 255});     // Red for elements compared or moved since last frame
+        lanes.push_back(std::move(lane));
+    }
+    finishedLanes = 0;
+    layoutLanes();
+}
+
+void RaceView::layoutLanes() {
+    if (lanes.empty()) return;
+    const int laneHeight = screenHeight / static_cast<int>(lanes.size());
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        auto& bars = lanes[i]->bars;
+        bars.setScreenDimensions(screenWidth, std::max(LABEL_HEIGHT + LANE_GAP + 1, laneHeight) - LABEL_HEIGHT - LANE_GAP);
+        bars.setPosition(0, static_cast<int>(i) * laneHeight + LABEL_HEIGHT);
+    }
+}
+
+void RaceView::update() {
+    for (auto& lane : lanes) {
+        if (lane->update()) {
+            lane->rank = ++finishedLanes;
+        }
+    }
+}
+
+void RaceView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    const int laneHeight = lanes.empty() ? 0 : screenHeight / static_cast<int>(lanes.size());
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        const Lane& lane = *lanes[i];
+        lanes[i]->bars.render(renderer, lane.snapshot().data);
+        drawLabel(renderer, lane, static_cast<int>(i) * laneHeight);
+    }
+    SDL_RenderPresent(renderer);
+}
+
+void RaceView::drawLabel(SDL_Renderer* renderer, const Lane& lane, int y) const {
+    if (!font) return;
+    const LaneSnapshot& snapshot = lane.snapshot();
+    const std::string place = lane.rank ? fmt::format("#{} ", lane.rank) : std::string();
+    const std::string text = fmt::format("{}{}  {:.2f}s  cmp {}  swap {}  write {}  native {:.1f}us", place, lane.name,
+                                         snapshot.raceSeconds, formatCount(snapshot.comparisons),
+                                         formatCount(snapshot.swaps), formatCount(snapshot.writes),
+                                         snapshot.nativeSeconds * 1e6);
+    const SDL_Color color = snapshot.finished ? SDL_Color{0, 255, 0, 255} : SDL_Color{255, 255, 255, 255};
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    const SDL_Rect rect = {4, y + (LABEL_HEIGHT - surface->h) / 2, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
+}
+
+void RaceView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_r:
+            ++dataSpec.seed;
+            start();
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start();
+            break;
+        }
+        case SDLK_UP:
+            opsPerSecond.store(opsPerSecond.load() * 2.0);
+            break;
+        case SDLK_DOWN:
+            opsPerSecond.store(std::max(1.0, opsPerSecond.load() / 2.0));
+            break;
+        default:
+            break;
+    }
+}
+
+void RaceView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    layoutLanes();
+}
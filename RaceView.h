@@ -0,0 +1,61 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_RACEVIEW_H
+#define ALGOVISUALIZER_RACEVIEW_H
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Races several sorts on the same generated array, one lane per algorithm, in one window.
+ *
+ * Every lane runs its sort on a worker thread of its own, paced to the same number of operations per second, and
+ * publishes snapshots of its array and counters through a SnapshotBuffer; the render thread only composites the
+ * latest snapshot of each lane. So a lane finishes when its operation count runs out, and the finish order is the
+ * order of cost. Each label shows the race time, the comparisons, swaps and writes so far, and how long the same
+ * sort takes natively on plain ints. The coroutine sorts report their own operations, the standard library sorts
+ * are traced through counted elements.
+ *
+ * Keys: r races again on new data, d switches to the next input distribution and up/down double or halve the
+ * operations per second.
+ */
+class RaceView : public IRenderable {
+public:
+    explicit RaceView(const DataSpec& spec);
+    RaceView(const RaceView&) = delete;
+    RaceView& operator=(const RaceView&) = delete;
+    ~RaceView() override;
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Stops the current race and starts a new one on the input of the current spec.
+     */
+    void start();
+
+private:
+    class Lane;
+
+    void layoutLanes();
+    void drawLabel(SDL_Renderer* renderer, const Lane& lane, int y) const;
+
+    DataSpec dataSpec;
+    /**
+     * @brief Read by every lane's worker; declared before lanes so it outlives them.
+     */
+    std::atomic<double> opsPerSecond;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    unsigned finishedLanes;
+    TTF_Font* font;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_RACEVIEW_H
@@ -0,0 +1,28 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "RadixSort.h"
+
+RadixSortLog::RadixSortLog() :
+    events_(),
+    histograms_(),
+    values_(),
+    writeCount_(0) {
+}
+
+RadixSortLog::~RadixSortLog() = default;
+RadixSortLog::RadixSortLog(RadixSortLog&& other) noexcept = default;
+RadixSortLog& RadixSortLog::operator=(RadixSortLog&& other) noexcept = default;
+
+void RadixSortLog::pass(std::size_t begin, unsigned shift, const RadixHistogram& histogram) {
+    std::size_t total = 0;
+    for (const auto count : histogram) total += count;
+    events_.push_back({Event::Kind::Pass, shift, begin, total, histograms_.size()});
+    histograms_.push_back(histogram);
+}
+
+void RadixSortLog::wrote(std::size_t position, const int* values, std::size_t count) {
+    events_.push_back({Event::Kind::Write, 0, position, count, values_.size()});
+    values_.insert(values_.end(), values, values + count);
+    ++writeCount_;
+}
@@ -0,0 +1,294 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_RADIXSORT_H
+#define ALGOVISUALIZER_RADIXSORT_H
+#include "SortAlgorithms.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#define RADIX_SORT_STREAMING 1
+#include <emmintrin.h>
+#else
+#define RADIX_SORT_STREAMING 0
+#endif
+
+/**
+ * @brief Radix sorts look at 8-bit digits, so every pass distributes over 256 buckets.
+ */
+constexpr std::size_t RADIX_BUCKETS = 256;
+using RadixHistogram = std::array<std::size_t, RADIX_BUCKETS>;
+
+/**
+ * @brief Observer that records nothing; calls to it compile away.
+ *
+ * The radix sorts report the digit counts of [begin, begin + total) as pass(begin, shift, histogram) before they
+ * distribute that range by the digit at bit shift, and every block of values they write as wrote(position, values,
+ * count), where position is the index in the array the values belong at after the pass.
+ */
+struct NullRadixObserver {
+    void pass(std::size_t, unsigned, const RadixHistogram&) {}
+    void wrote(std::size_t, const int*, std::size_t) {}
+};
+
+/**
+ * @brief Observer that keeps every pass and write of a radix sort in order, for replaying it.
+ */
+class RadixSortLog {
+public:
+    struct Event {
+        enum class Kind : std::uint8_t { Pass, Write };
+
+        Kind kind;
+        unsigned shift;
+        std::size_t position;
+        std::size_t count;
+        /**
+         * @brief Index of the histogram for a pass, of the first value for a write.
+         */
+        std::size_t offset;
+    };
+
+    RadixSortLog();
+    ~RadixSortLog();
+    RadixSortLog(RadixSortLog&& other) noexcept;
+    RadixSortLog& operator=(RadixSortLog&& other) noexcept;
+    void pass(std::size_t begin, unsigned shift, const RadixHistogram& histogram);
+    void wrote(std::size_t position, const int* values, std::size_t count);
+
+    [[nodiscard]] const std::vector<Event>& events() const { return events_; }
+    [[nodiscard]] const RadixHistogram& histogram(const Event& event) const { return histograms_[event.offset]; }
+    [[nodiscard]] const int* values(const Event& event) const { return values_.data() + event.offset; }
+    [[nodiscard]] std::size_t writeCount() const { return writeCount_; }
+
+private:
+    std::vector<Event> events_;
+    std::vector<RadixHistogram> histograms_;
+    std::vector<int> values_;
+    std::size_t writeCount_;
+};
+
+namespace radix_sort_detail {
+    constexpr unsigned DIGIT_BITS = 8;
+    constexpr unsigned DIGITS = 32 / DIGIT_BITS;
+    /**
+     * @brief ints per 64-byte cache line, the size of one write-combining buffer.
+     */
+    constexpr std::size_t LINE = 64 / sizeof(int);
+    /**
+     * @brief Ranges this small are finished by insertion sort instead of another pass.
+     */
+    constexpr std::size_t INSERTION_CUTOFF = 32;
+
+    /**
+     * @brief Flipping the sign bit orders negative ints before positive ones as unsigned keys.
+     */
+    constexpr std::uint32_t key(int value) noexcept {
+        return static_cast<std::uint32_t>(value) ^ 0x80000000u;
+    }
+    constexpr std::size_t digit(int value, unsigned shift) noexcept {
+        return (key(value) >> shift) & (RADIX_BUCKETS - 1);
+    }
+
+    /**
+     * @brief Arrays at least this large no longer fit in cache and are scattered through write-combining buffers;
+     * below it plain stores into cached lines are faster.
+     */
+    constexpr std::size_t STREAMING_THRESHOLD = std::size_t{1} << 18;
+
+    /**
+     * @brief Copies one full 64-byte line from an aligned buffer to an aligned destination with non-temporal
+     * stores, so the destination is neither read for ownership nor left in cache to evict the buffers.
+     */
+    inline void storeLine(int* to, const int* line) {
+#if RADIX_SORT_STREAMING
+        auto* target = reinterpret_cast<__m128i*>(to);
+        const auto* source = reinterpret_cast<const __m128i*>(line);
+        for (std::size_t i = 0; i < LINE * sizeof(int) / sizeof(__m128i); ++i) {
+            _mm_stream_si128(target + i, _mm_load_si128(source + i));
+        }
+#else
+        std::memcpy(to, line, LINE * sizeof(int));
+#endif
+    }
+
+    /**
+     * @brief Stable counting scatter of from into to by the digit at shift.
+     *
+     * Large arrays are scattered through write-combining buffers: values are collected in a cache-line sized buffer
+     * per bucket (16 KiB in all, so they stay in L1) and written out a whole line at a time with non-temporal
+     * stores once a buffer fills. The destination then sees 256 streams of full-line writes that are never read
+     * for ownership, which roughly halves the time of a pass once it is bound by memory. The first line of every
+     * bucket is shortened so the later ones land on line boundaries.
+     */
+    template<typename Observer>
+    void scatter(const int* from, int* to, std::size_t size, unsigned shift, const RadixHistogram& histogram,
+                 Observer& observer) {
+        if (size < STREAMING_THRESHOLD) {
+            std::array<std::size_t, RADIX_BUCKETS> next{};
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+                next[bucket] = offset;
+                offset += histogram[bucket];
+            }
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::size_t position = next[digit(from[i], shift)]++;
+                to[position] = from[i];
+                observer.wrote(position, to + position, 1);
+            }
+            return;
+        }
+
+        alignas(64) int lines[RADIX_BUCKETS][LINE];
+        std::array<std::size_t, RADIX_BUCKETS> next{};
+        std::array<std::uint32_t, RADIX_BUCKETS> fill{};
+        std::array<std::uint32_t, RADIX_BUCKETS> first{};
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            next[bucket] = offset;
+            offset += histogram[bucket];
+            const auto address = reinterpret_cast<std::uintptr_t>(to + next[bucket]);
+            first[bucket] = fill[bucket] = static_cast<std::uint32_t>(address / sizeof(int) % LINE);
+        }
+
+        auto flush = [&](std::size_t bucket) {
+            const std::size_t count = fill[bucket] - first[bucket];
+            if (count == LINE) {
+                storeLine(to + next[bucket], lines[bucket]);
+            } else {
+                std::memcpy(to + next[bucket], lines[bucket] + first[bucket], count * sizeof(int));
+            }
+            observer.wrote(next[bucket], lines[bucket] + first[bucket], count);
+            next[bucket] += count;
+            fill[bucket] = first[bucket] = 0;
+        };
+        for (std::size_t i = 0; i < size; ++i) {
+            const int value = from[i];
+            const std::size_t bucket = digit(value, shift);
+            lines[bucket][fill[bucket]++] = value;
+            if (fill[bucket] == LINE) {
+                flush(bucket);
+            }
+        }
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            if (fill[bucket] > first[bucket]) {
+                flush(bucket);
+            }
+        }
+#if RADIX_SORT_STREAMING
+        // Non-temporal stores are weakly ordered; fence before anyone reads the destination.
+        _mm_sfence();
+#endif
+    }
+
+    /**
+     * @brief American flag sort of [begin, end) by the digit at shift, then of every bucket by the next digit.
+     *
+     * Elements are permuted in place along cycles: each displaced element is carried straight to the next free
+     * slot of its bucket.
+     */
+    template<typename Observer>
+    void msdSort(int* data, std::size_t begin, std::size_t end, unsigned shift, Observer& observer) {
+        if (end - begin <= INSERTION_CUTOFF) {
+            insertionSort(data + begin, data + end);
+            observer.wrote(begin, data + begin, end - begin);
+            return;
+        }
+        RadixHistogram histogram{};
+        for (std::size_t i = begin; i < end; ++i) {
+            ++histogram[digit(data[i], shift)];
+        }
+        observer.pass(begin, shift, histogram);
+
+        RadixHistogram head{};
+        RadixHistogram tail{};
+        std::size_t offset = begin;
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            head[bucket] = offset;
+            offset += histogram[bucket];
+            tail[bucket] = offset;
+        }
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            while (head[bucket] < tail[bucket]) {
+                int value = data[head[bucket]];
+                for (std::size_t target = digit(value, shift); target != bucket; target = digit(value, shift)) {
+                    std::swap(value, data[head[target]]);
+                    observer.wrote(head[target], data + head[target], 1);
+                    ++head[target];
+                }
+                data[head[bucket]] = value;
+                observer.wrote(head[bucket], data + head[bucket], 1);
+                ++head[bucket];
+            }
+        }
+
+        if (shift == 0) return;
+        offset = begin;
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            if (histogram[bucket] > 1) {
+                msdSort(data, offset, offset + histogram[bucket], shift - DIGIT_BITS, observer);
+            }
+            offset += histogram[bucket];
+        }
+    }
+}
+
+/**
+ * @brief Least-significant-digit radix sort: one stable scatter per 8-bit digit through write-combining buffers.
+ *
+ * All four digit histograms are counted in a single read of the input, and passes in which every element has the
+ * same digit are skipped, so small value ranges take fewer passes. Needs a buffer as large as the input.
+ */
+template<typename Observer = NullRadixObserver>
+void lsdRadixSort(std::vector<int>& data, Observer&& observer = {}) {
+    using namespace radix_sort_detail;
+    const std::size_t size = data.size();
+    if (size <= INSERTION_CUTOFF) {
+        insertionSort(data.begin(), data.end());
+        if (size) observer.wrote(0, data.data(), size);
+        return;
+    }
+    std::array<RadixHistogram, DIGITS> histograms{};
+    for (const int value : data) {
+        const std::uint32_t k = key(value);
+        for (unsigned d = 0; d < DIGITS; ++d) {
+            ++histograms[d][(k >> (d * DIGIT_BITS)) & (RADIX_BUCKETS - 1)];
+        }
+    }
+
+    std::vector<int> buffer(size);
+    int* from = data.data();
+    int* to = buffer.data();
+    for (unsigned d = 0; d < DIGITS; ++d) {
+        const auto& histogram = histograms[d];
+        if (std::find(histogram.begin(), histogram.end(), size) != histogram.end()) continue;
+        observer.pass(0, d * DIGIT_BITS, histogram);
+        scatter(from, to, size, d * DIGIT_BITS, histogram, observer);
+        std::swap(from, to);
+    }
+    if (from != data.data()) {
+        std::copy(from, from + size, data.data());
+    }
+}
+
+/**
+ * @brief Most-significant-digit radix sort in place (American flag sort), finishing small buckets by insertion sort.
+ *
+ * Needs no buffer. Recursion follows the digits, so it is at most four levels deep.
+ */
+template<typename Observer = NullRadixObserver>
+void msdRadixSort(std::vector<int>& data, Observer&& observer = {}) {
+    using namespace radix_sort_detail;
+    if (data.size() < 2) return;
+    msdSort(data.data(), 0, data.size(), (DIGITS - 1) * DIGIT_BITS, observer);
+}
+
+
+#endif //ALGOVISUALIZER_RADIXSORT_H
@@ -0,0 +1,155 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "RadixSortView.h"
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Roughly how many frames one replay should take.
+     */
+    constexpr std::size_t REPLAY_FRAMES = 600;
+    /**
+     * @brief Width of the histogram panel; one pixel column per bucket when the window allows it.
+     */
+    constexpr int HISTOGRAM_WIDTH = static_cast<int>(RADIX_BUCKETS);
+    constexpr int HISTOGRAM_MARGIN = 8;
+}
+
+RadixSortView::RadixSortView(const DataSpec& spec) :
+    algorithm(Algorithm::Lsd),
+    data(),
+    log(),
+    nextEvent(0),
+    writesPerFrame(1),
+    inPass(false),
+    histogram(),
+    bucketEnd(),
+    placed(),
+    bars(),
+    dataSpec(spec),
+    run(),
+    screenWidth(0),
+    screenHeight(0) {
+    bars.setMaxValue(spec.maxValue);
+    bars.setColors(SDL_Color{255, 255, 255, 255},  // White for bars not yet in their final place
+                   SDL_Color{0, 255, 0, 255},      // Green once the sort has finished
+                   SDL_Color{255, 165, 0, 255});   // Orange for values written this frame
+    start(algorithm);
+}
+
+void RadixSortView::start(Algorithm newAlgorithm) {
+    algorithm = newAlgorithm;
+    data = generateData(dataSpec);
+    std::vector<int> sorted = data;
+    log = RadixSortLog();
+    run.label = algorithm == Algorithm::Lsd ? "lsd radix sort" : "msd radix sort";
+    run.sample = measurePerf([&] {
+        if (algorithm == Algorithm::Lsd) {
+            lsdRadixSort(sorted, log);
+        } else {
+            msdRadixSort(sorted, log);
+        }
+    });
+    nextEvent = 0;
+    writesPerFrame = std::max<std::size_t>(1, log.writeCount() / REPLAY_FRAMES);
+    inPass = false;
+    bars.setSortedRange(0, 0);
+    bars.invalidate();
+}
+
+void RadixSortView::beginPass(const RadixSortLog::Event& event) {
+    inPass = true;
+    histogram = log.histogram(event);
+    std::size_t end = event.position;
+    for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+        end += histogram[bucket];
+        bucketEnd[bucket] = end;
+    }
+    placed.fill(0);
+}
+
+void RadixSortView::update() {
+    const auto& events = log.events();
+    for (std::size_t applied = 0; applied < writesPerFrame && nextEvent < events.size(); ++nextEvent) {
+        const auto& event = events[nextEvent];
+        if (event.kind == RadixSortLog::Event::Kind::Pass) {
+            beginPass(event);
+            continue;
+        }
+        const int* values = log.values(event);
+        std::copy(values, values + event.count, data.begin() + static_cast<std::ptrdiff_t>(event.position));
+        for (std::size_t i = event.position; i < event.position + event.count; ++i) {
+            bars.touch(i);
+        }
+        // Insertion-sorted leaves of the MSD sort can lie outside the range of the last pass.
+        const auto bucket = static_cast<std::size_t>(
+                std::upper_bound(bucketEnd.begin(), bucketEnd.end(), event.position) - bucketEnd.begin());
+        if (inPass && bucket < RADIX_BUCKETS && event.position >= bucketEnd[bucket] - histogram[bucket]) {
+            placed[bucket] += event.count;
+        }
+        ++applied;
+    }
+    if (nextEvent == events.size()) {
+        bars.setSortedRange(0, data.size());
+    }
+}
+
+void RadixSortView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    drawHistogram(renderer);
+    SDL_RenderPresent(renderer);
+}
+
+void RadixSortView::drawHistogram(SDL_Renderer* renderer) const {
+    if (!inPass) return;
+    const std::size_t largest = std::max<std::size_t>(1, *std::max_element(histogram.begin(), histogram.end()));
+    const int panelWidth = std::min(HISTOGRAM_WIDTH, screenWidth / 3);
+    const int left = screenWidth - panelWidth;
+    for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+        const int x = left + static_cast<int>(bucket) * panelWidth / HISTOGRAM_WIDTH;
+        const int width = std::max(1, left + static_cast<int>(bucket + 1) * panelWidth / HISTOGRAM_WIDTH - x);
+        const auto total = static_cast<int>(histogram[bucket] * static_cast<std::size_t>(screenHeight) / largest);
+        const auto done = static_cast<int>(std::min(placed[bucket], histogram[bucket]) *
+                                           static_cast<std::size_t>(screenHeight) / largest);
+        const SDL_Rect totalRect = {x, screenHeight - total, width, total};
+        const SDL_Rect doneRect = {x, screenHeight - done, width, done};
+        SDL_SetRenderDrawColor(renderer, 70, 70, 110, 255);
+        SDL_RenderFillRect(renderer, &totalRect);
+        SDL_SetRenderDrawColor(renderer, 100, 149, 237, 255);
+        SDL_RenderFillRect(renderer, &doneRect);
+    }
+}
+
+void RadixSortView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_l:
+            start(Algorithm::Lsd);
+            break;
+        case SDLK_m:
+            start(Algorithm::Msd);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(algorithm);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(algorithm);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void RadixSortView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    const int panelWidth = std::min(HISTOGRAM_WIDTH, width / 3);
+    bars.setScreenDimensions(std::max(HISTOGRAM_MARGIN + 1, width - panelWidth) - HISTOGRAM_MARGIN, height);
+}
@@ -0,0 +1,73 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_RADIXSORTVIEW_H
+#define ALGOVISUALIZER_RADIXSORTVIEW_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "RadixSort.h"
+#include <vector>
+
+/**
+ * @brief Runs a radix sort while recording, then replays it with the digit histogram of the current pass drawn
+ * beside the bars.
+ *
+ * Every histogram bar is as tall as the number of elements with that digit in the range being distributed, and
+ * fills in brightly as they land in their bucket. Keys: l replays the LSD sort and m the MSD sort on the same
+ * input, r restarts the current one on new data, and d switches to the next input distribution.
+ */
+class RadixSortView : public IRenderable {
+public:
+    enum class Algorithm { Lsd, Msd };
+
+    explicit RadixSortView(const DataSpec& spec);
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Generates the input of the current spec, sorts it with algorithm while recording, and rewinds the
+     * replay.
+     */
+    void start(Algorithm algorithm);
+    /**
+     * @brief Counters of the recorded sort, logging included.
+     */
+    [[nodiscard]] const PerfRun* lastRun() const override { return &run; }
+
+private:
+    void beginPass(const RadixSortLog::Event& event);
+    void drawHistogram(SDL_Renderer* renderer) const;
+
+    Algorithm algorithm;
+    std::vector<int> data;
+    RadixSortLog log;
+    std::size_t nextEvent;
+    std::size_t writesPerFrame;
+    /**
+     * @brief Whether a pass has been replayed yet; histogram is only meaningful once one has.
+     */
+    bool inPass;
+    /**
+     * @brief Digit counts of the pass being replayed.
+     */
+    RadixHistogram histogram;
+    /**
+     * @brief End of every bucket of the current pass as an array index.
+     */
+    RadixHistogram bucketEnd;
+    /**
+     * @brief Elements of every bucket of the current pass written so far.
+     */
+    RadixHistogram placed;
+    BarRenderer bars;
+    DataSpec dataSpec;
+    PerfRun run;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_RADIXSORTVIEW_H
@@ -0,0 +1,277 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SELECTION_H
+#define ALGOVISUALIZER_SELECTION_H
+#include "SortAlgorithms.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Selection: putting the nth smallest element in its sorted position, or keeping the k smallest, without
+ * sorting everything.
+ *
+ * Like the sorts in SortAlgorithms.h they take any random-access range and comparator and swap through an
+ * unqualified swap. The selections report every narrowing of the range that must hold the nth element through
+ * events.window(begin, end); SortTracer forwards it as a Window op.
+ */
+
+namespace selection_detail {
+    /**
+     * @brief Three-way partition around a copy of *pivot.
+     * @return The range of elements equivalent to the pivot; everything before it is smaller, everything after larger.
+     */
+    template<typename Iterator, typename Compare>
+    std::pair<Iterator, Iterator> partition3(Iterator first, Iterator last, Iterator pivot, Compare& compare) {
+        using std::swap;
+        const std::iter_value_t<Iterator> value = *pivot;
+        Iterator less = first;
+        Iterator i = first;
+        Iterator greater = last;
+        while (i < greater) {
+            if (compare(*i, value)) {
+                swap(*less++, *i++);
+            } else if (compare(value, *i)) {
+                swap(*i, *--greater);
+            } else {
+                ++i;
+            }
+        }
+        return {less, greater};
+    }
+
+    template<typename Iterator, typename Compare>
+    Iterator medianOf3(Iterator a, Iterator b, Iterator c, Compare& compare) {
+        if (compare(*a, *b)) {
+            if (compare(*b, *c)) return b;
+            return compare(*a, *c) ? c : a;
+        }
+        if (compare(*a, *c)) return a;
+        return compare(*b, *c) ? c : b;
+    }
+
+    template<typename Iterator, typename Compare, typename Events>
+    void introSelectLoop(Iterator origin, Iterator first, Iterator nth, Iterator last, Compare& compare, Events& events,
+                         std::iter_difference_t<Iterator> budget);
+
+    /**
+     * @brief Median of the medians of groups of five, moved to the front of the range; a pivot that leaves at least
+     * 30% of the range on either side, which bounds introselect at linear time.
+     */
+    template<typename Iterator, typename Compare>
+    Iterator medianOfMedians(Iterator first, Iterator last, Compare& compare) {
+        using std::swap;
+        Iterator medians = first;
+        for (Iterator group = first; group < last; group += std::min<std::iter_difference_t<Iterator>>(5, last - group)) {
+            const Iterator groupEnd = group + std::min<std::iter_difference_t<Iterator>>(5, last - group);
+            insertionSort(group, groupEnd, compare);
+            swap(*medians++, group[(groupEnd - group) / 2]);
+        }
+        const Iterator median = first + (medians - first) / 2;
+        NoSortEvents quiet;
+        introSelectLoop(first, first, median, medians, compare, quiet, 0);
+        return median;
+    }
+
+    /**
+     * @brief Quickselect on the median of three while the elements partitioned so far stay within budget, then on
+     * the median of medians.
+     */
+    template<typename Iterator, typename Compare, typename Events>
+    void introSelectLoop(Iterator origin, Iterator first, Iterator nth, Iterator last, Compare& compare, Events& events,
+                         std::iter_difference_t<Iterator> budget) {
+        constexpr std::iter_difference_t<Iterator> INSERTION_SORT_THRESHOLD = 16;
+        auto index = [origin](Iterator it) { return static_cast<std::size_t>(it - origin); };
+        while (last - first > INSERTION_SORT_THRESHOLD) {
+            events.window(index(first), index(last));
+            const Iterator pivot = budget > 0
+                    ? medianOf3(first, first + (last - first) / 2, last - 1, compare)
+                    : medianOfMedians(first, last, compare);
+            budget -= last - first;
+            const auto [equalBegin, equalEnd] = partition3(first, last, pivot, compare);
+            if (nth < equalBegin) {
+                last = equalBegin;
+            } else if (nth >= equalEnd) {
+                first = equalEnd;
+            } else {
+                return;
+            }
+        }
+        insertionSort(first, last, compare);
+    }
+
+    template<typename Iterator, typename Compare, typename Events>
+    void floydRivestLoop(Iterator origin, Iterator first, Iterator nth, Iterator last, Compare& compare, Events& events) {
+        using std::swap;
+        constexpr std::size_t SAMPLE_THRESHOLD = 600;
+        // Unsigned indices from origin; right only moves to j - 1 for a j above k, so it never wraps.
+        std::size_t left = static_cast<std::size_t>(first - origin);
+        std::size_t right = static_cast<std::size_t>(last - origin) - 1;
+        const auto k = static_cast<std::size_t>(nth - origin);
+        auto at = [origin](std::size_t index) -> std::iter_reference_t<Iterator> {
+            return origin[static_cast<std::iter_difference_t<Iterator>>(index)];
+        };
+        while (right > left) {
+            events.window(left, right + 1);
+            if (right - left > SAMPLE_THRESHOLD) {
+                // Select from a sample first, so that k's neighbours land close to k and the partition below
+                // leaves only a sliver of the range around it.
+                const auto n = static_cast<double>(right - left + 1);
+                const auto i = static_cast<double>(k - left + 1);
+                const double z = std::log(n);
+                const double s = 0.5 * std::exp(2.0 * z / 3.0);
+                const double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2.0 ? -1.0 : 1.0);
+                const auto sampleLeft = static_cast<std::size_t>(
+                        std::max(static_cast<double>(left), static_cast<double>(k) - i * s / n + sd));
+                const auto sampleRight = static_cast<std::size_t>(
+                        std::min(static_cast<double>(right), static_cast<double>(k) + (n - i) * s / n + sd));
+                NoSortEvents quiet;
+                floydRivestLoop(origin, origin + static_cast<std::iter_difference_t<Iterator>>(sampleLeft), nth,
+                                origin + static_cast<std::iter_difference_t<Iterator>>(sampleRight + 1), compare, quiet);
+            }
+            const std::iter_value_t<Iterator> pivot = at(k);
+            std::size_t i = left;
+            std::size_t j = right;
+            swap(at(left), at(k));
+            if (compare(pivot, at(right))) swap(at(right), at(left));
+            while (i < j) {
+                swap(at(i), at(j));
+                ++i;
+                --j;
+                while (compare(at(i), pivot)) ++i;
+                while (compare(pivot, at(j))) --j;
+            }
+            if (!compare(at(left), pivot) && !compare(pivot, at(left))) {
+                swap(at(left), at(j));
+            } else {
+                ++j;
+                swap(at(j), at(right));
+            }
+            // The pivot is now at j, with nothing larger before it and nothing smaller after it.
+            if (j == k) return;
+            if (j < k) {
+                left = j + 1;
+            } else {
+                right = j - 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Introselect: rearranges [first, last) like std::nth_element, so *nth is the element a sort would put there,
+ * nothing after it is smaller and nothing before it larger.
+ *
+ * Quickselect on a median-of-three pivot with a three-way partition, so runs of equal keys end the search at once.
+ * Good pivots halve the range each round, so all rounds together partition about 2n elements; once they have
+ * partitioned 4n without finding nth it switches to median-of-medians pivots, so the worst case stays linear.
+ */
+template<std::random_access_iterator Iterator, typename Compare, typename Events>
+void introSelect(Iterator first, Iterator nth, Iterator last, Compare compare, Events& events) {
+    if (nth == last) return;
+    selection_detail::introSelectLoop(first, first, nth, last, compare, events, 4 * (last - first));
+    events.window(static_cast<std::size_t>(nth - first), static_cast<std::size_t>(nth - first) + 1);
+}
+
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void introSelect(Iterator first, Iterator nth, Iterator last, Compare compare = {}) {
+    NoSortEvents events;
+    introSelect(first, nth, last, compare, events);
+}
+
+/**
+ * @brief Floyd and Rivest's SELECT, with the same result as introSelect.
+ *
+ * Before partitioning a large range it recursively selects within a sample of about n^(2/3) elements around where
+ * the nth element should fall, then partitions around that. The pivot lands so close to nth that each round
+ * discards almost the whole range, for about n + min(k, n - k) comparisons in expectation against 2n to 3n for
+ * quickselect. There is no worst-case guarantee.
+ */
+template<std::random_access_iterator Iterator, typename Compare, typename Events>
+void floydRivestSelect(Iterator first, Iterator nth, Iterator last, Compare compare, Events& events) {
+    if (nth == last) return;
+    selection_detail::floydRivestLoop(first, first, nth, last, compare, events);
+    events.window(static_cast<std::size_t>(nth - first), static_cast<std::size_t>(nth - first) + 1);
+}
+
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void floydRivestSelect(Iterator first, Iterator nth, Iterator last, Compare compare = {}) {
+    NoSortEvents events;
+    floydRivestSelect(first, nth, last, compare, events);
+}
+
+/**
+ * @brief Keeps the k smallest values of a stream that arrives in chunks, holding at most 2k of them.
+ *
+ * Values that are not below the largest of the k kept so far are rejected with a single comparison, which is
+ * what almost every value of a long stream is. Accepted values collect in a buffer; when it reaches 2k, introselect
+ * cuts it back to the k smallest and tightens the threshold. So the stream costs about one comparison per value,
+ * plus amortized O(k) per k accepted values.
+ */
+template<typename T, typename Compare = std::less<>>
+class TopK {
+public:
+    explicit TopK(std::size_t k, Compare compare = {}) :
+        k_(k), compare_(compare), buffer_(), threshold_(), full_(false), seen_(0) {
+        buffer_.reserve(2 * k_);
+    }
+
+    void push(std::span<const T> chunk) {
+        seen_ += chunk.size();
+        if (k_ == 0) return;
+        for (const T& value : chunk) {
+            if (full_ && !compare_(value, threshold_)) continue;
+            buffer_.push_back(value);
+            if (buffer_.size() == 2 * k_) shrink();
+        }
+    }
+
+    /**
+     * @brief The k smallest values seen so far, or all of them if fewer, in ascending order.
+     */
+    [[nodiscard]] std::vector<T> sorted() const {
+        std::vector<T> values = buffer_;
+        if (values.size() > k_) {
+            introSelect(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k_ - 1), values.end(), compare_);
+            values.resize(k_);
+        }
+        pdqSort(values.begin(), values.end(), compare_);
+        return values;
+    }
+
+    [[nodiscard]] std::size_t k() const { return k_; }
+    /**
+     * @brief Number of values pushed so far.
+     */
+    [[nodiscard]] std::uint64_t seen() const { return seen_; }
+
+private:
+    void shrink() {
+        const auto kth = buffer_.begin() + static_cast<std::ptrdiff_t>(k_ - 1);
+        introSelect(buffer_.begin(), kth, buffer_.end(), compare_);
+        threshold_ = *kth;
+        full_ = true;
+        buffer_.resize(k_);
+    }
+
+    std::size_t k_;
+    Compare compare_;
+    std::vector<T> buffer_;
+    /**
+     * @brief Largest of the k smallest values once full_; only values below it can still make the cut.
+     */
+    T threshold_;
+    bool full_;
+    std::uint64_t seen_;
+};
+
+
+#endif //ALGOVISUALIZER_SELECTION_H
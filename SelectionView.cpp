@@ -0,0 +1,220 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SelectionView.h"
+#include "Constants.hpp"
+#include "Selection.h"
+#include <algorithm>
+#include <fmt/core.h>
+#include <functional>
+#include <string>
+
+namespace {
+    /**
+     * @brief Roughly how many frames one selection should take, guessing a few operations per element.
+     */
+    constexpr std::size_t REPLAY_FRAMES = 600;
+    constexpr std::size_t BUFFER_CAPACITY = std::size_t{1} << 16;
+    constexpr int LABEL_FONT_SIZE = 14;
+
+    const std::vector<SDL_Color> DISCARDED_PALETTE = {SDL_Color{50, 50, 60, 255}};
+    constexpr std::uint8_t DISCARDED = 0;
+
+    const char* algorithmName(SelectionView::Algorithm algorithm) {
+        switch (algorithm) {
+            case SelectionView::Algorithm::IntroSelect: return "introselect";
+            case SelectionView::Algorithm::FloydRivest: return "Floyd-Rivest";
+            case SelectionView::Algorithm::NthElement: return "std::nth_element";
+            default: return "";
+        }
+    }
+
+    void runTraced(SelectionView::Algorithm algorithm, const std::vector<int>& input, SortOpBuffer& buffer) {
+        std::vector<counted<int>> values(input.begin(), input.end());
+        const std::size_t size = values.size();
+        const auto median = values.begin() + static_cast<std::ptrdiff_t>(size / 2);
+        try {
+            SortTracer tracer(values.data(), size, sizeof(counted<int>), buffer);
+            switch (algorithm) {
+                case SelectionView::Algorithm::IntroSelect:
+                    introSelect(values.begin(), median, values.end(), std::less<>{}, tracer);
+                    break;
+                case SelectionView::Algorithm::FloydRivest:
+                    floydRivestSelect(values.begin(), median, values.end(), std::less<>{}, tracer);
+                    break;
+                case SelectionView::Algorithm::NthElement:
+                default:
+                    std::nth_element(values.begin(), median, values.end());
+                    break;
+            }
+            tracer.sorted(size / 2, size / 2 + 1);
+        } catch (const SortTraceCancelled&) {
+            // The view restarted or closed; the partly partitioned values are simply dropped.
+        }
+        buffer.finish();
+    }
+}
+
+SelectionView::SelectionView(const DataSpec& spec) :
+    algorithm(Algorithm::IntroSelect),
+    data(),
+    owners(),
+    windowBegin(0),
+    windowEnd(0),
+    rounds(0),
+    buffer(),
+    worker(),
+    frameOps(),
+    opsPerFrame(1),
+    bars(),
+    dataSpec(spec),
+    font(TTF_OpenFont(Constants::FONT_PATH, LABEL_FONT_SIZE)),
+    screenWidth(0) {
+    bars.setMaxValue(spec.maxValue);
+    bars.setColors(SDL_Color{200, 200, 200, 255},  // Light gray inside the window
+                   SDL_Color{0, 255, 0, 255},      // Green for the median once it is in place
+                   SDL_Color{255, 60, 60, 255});   // Red for elements compared or moved this frame
+    bars.setOwners(&owners, DISCARDED_PALETTE);
+    start(algorithm);
+}
+
+SelectionView::~SelectionView() {
+    stop();
+    bars.setOwners(nullptr, {});
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+void SelectionView::stop() {
+    if (buffer) {
+        buffer->cancel();
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SelectionView::start(Algorithm newAlgorithm) {
+    stop();
+    algorithm = newAlgorithm;
+    data = generateData(dataSpec);
+    owners.assign(data.size(), BarRenderer::NO_OWNER);
+    windowBegin = 0;
+    windowEnd = data.size();
+    rounds = 0;
+    // A selection touches about 2n to 3n elements in all, wherever it is.
+    opsPerFrame = std::max<std::size_t>(1, 3 * data.size() / REPLAY_FRAMES);
+    buffer = std::make_unique<SortOpBuffer>(BUFFER_CAPACITY);
+    worker = std::jthread(runTraced, algorithm, data, std::ref(*buffer));
+    bars.setSortedRange(0, 0);
+    bars.invalidate();
+}
+
+void SelectionView::narrow(std::size_t begin, std::size_t end) {
+    const auto dim = [this](std::size_t from, std::size_t to) {
+        if (from >= to) return;
+        std::fill(owners.begin() + static_cast<std::ptrdiff_t>(from), owners.begin() + static_cast<std::ptrdiff_t>(to),
+                  DISCARDED);
+        bars.invalidate(from, to);
+    };
+    dim(windowBegin, begin);
+    dim(end, windowEnd);
+    windowBegin = begin;
+    windowEnd = end;
+    ++rounds;
+}
+
+void SelectionView::update() {
+    frameOps.resize(opsPerFrame);
+    const std::size_t count = buffer->pop(frameOps.data(), frameOps.size());
+    for (std::size_t k = 0; k < count; ++k) {
+        const SortOp& op = frameOps[k];
+        switch (op.kind) {
+            case SortOp::Kind::Compare:
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Swap:
+                std::swap(data[op.i], data[op.j]);
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Write:
+                data[op.i] = op.value;
+                bars.touch(op.i);
+                break;
+            case SortOp::Kind::Sorted:
+                bars.setSortedRange(op.i, op.j);
+                break;
+            case SortOp::Kind::Window:
+                narrow(op.i, op.j);
+                break;
+            case SortOp::Kind::Run:
+            case SortOp::Kind::Fallback:
+            default:
+                break;
+        }
+    }
+}
+
+void SelectionView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    drawLabel(renderer);
+    SDL_RenderPresent(renderer);
+}
+
+void SelectionView::drawLabel(SDL_Renderer* renderer) const {
+    if (!font) return;
+    const std::string text = fmt::format("{}  {}  median of {}  window [{}, {})  rounds {}", algorithmName(algorithm),
+                                         distributionName(dataSpec.distribution), data.size(), windowBegin, windowEnd,
+                                         rounds);
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), SDL_Color{255, 255, 255, 255});
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    // Right-aligned, clear of the FPS counter and perf overlay in the top left.
+    const SDL_Rect rect = {screenWidth - surface->w - 6, 6, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
+}
+
+void SelectionView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_i:
+            start(Algorithm::IntroSelect);
+            break;
+        case SDLK_f:
+            start(Algorithm::FloydRivest);
+            break;
+        case SDLK_n:
+            start(Algorithm::NthElement);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(algorithm);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(algorithm);
+            break;
+        }
+        case SDLK_UP:
+            opsPerFrame = std::min<std::size_t>(opsPerFrame * 2, BUFFER_CAPACITY);
+            break;
+        case SDLK_DOWN:
+            opsPerFrame = std::max<std::size_t>(opsPerFrame / 2, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void SelectionView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    bars.setScreenDimensions(width, height);
+}
@@ -0,0 +1,73 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SELECTIONVIEW_H
+#define ALGOVISUALIZER_SELECTIONVIEW_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "SortInstrumentation.h"
+#include <SDL2/SDL_ttf.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Plays back a selection of the median, traced on a worker thread like AdaptiveSortView, with the range that
+ * can still hold the median drawn bright and everything already ruled out dimmed.
+ *
+ * The bright window shrinks with every partition, by about half per round for introselect and down to a sliver
+ * after the first round for Floyd–Rivest; the median turns green once it is in place. Keys: i introselect, f
+ * Floyd–Rivest, n std::nth_element (which reports no windows, only its compares and swaps); r restarts on new data,
+ * d switches to the next input distribution and up/down double or halve the speed.
+ */
+class SelectionView : public IRenderable {
+public:
+    enum class Algorithm { IntroSelect, FloydRivest, NthElement };
+
+    explicit SelectionView(const DataSpec& spec);
+    SelectionView(const SelectionView&) = delete;
+    SelectionView& operator=(const SelectionView&) = delete;
+    ~SelectionView() override;
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Cancels the running selection, generates its input and starts algorithm on it.
+     */
+    void start(Algorithm algorithm);
+
+private:
+    void stop();
+    /**
+     * @brief Dims everything outside [begin, end), which lies inside the previous window.
+     */
+    void narrow(std::size_t begin, std::size_t end);
+    void drawLabel(SDL_Renderer* renderer) const;
+
+    Algorithm algorithm;
+    std::vector<int> data;
+    /**
+     * @brief DISCARDED for elements outside the current window, BarRenderer::NO_OWNER inside it.
+     */
+    std::vector<std::uint8_t> owners;
+    std::size_t windowBegin;
+    std::size_t windowEnd;
+    std::size_t rounds;
+    std::unique_ptr<SortOpBuffer> buffer;
+    /**
+     * @brief Declared after buffer so it is joined before the buffer it pushes into is freed.
+     */
+    std::jthread worker;
+    std::vector<SortOp> frameOps;
+    std::size_t opsPerFrame;
+    BarRenderer bars;
+    DataSpec dataSpec;
+    TTF_Font* font;
+    int screenWidth;
+};
+
+
+#endif //ALGOVISUALIZER_SELECTIONVIEW_H
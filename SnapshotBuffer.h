@@ -0,0 +1,64 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SNAPSHOTBUFFER_H
+#define ALGOVISUALIZER_SNAPSHOTBUFFER_H
+#include <array>
+#include <atomic>
+
+/**
+ * @brief Lock-free triple buffer handing the latest snapshot of some state from one writer thread to one reader.
+ *
+ * The writer fills back() and publish()es it; the reader calls update() and then reads front(). Besides the two
+ * buffers the sides work in there is a third, spare one, and publishing or updating swaps a side's buffer with the
+ * spare in a single atomic exchange. Neither side ever waits for the other or sees a buffer the other is using;
+ * snapshots the reader has no time for are simply overwritten. Buffers are reused, so a snapshot holding vectors
+ * stops allocating once they have grown to size.
+ */
+template<typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer() = default;
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    /**
+     * @brief Writer side: the buffer to fill next. It still holds the snapshot published two rounds ago.
+     */
+    T& back() { return buffers_[back_]; }
+    /**
+     * @brief Writer side: makes back() the latest snapshot and takes the spare buffer as the new back().
+     */
+    void publish() {
+        back_ = spare_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+    /**
+     * @brief Reader side: switches front() to the latest snapshot, if one was published since the last call.
+     * @return Whether front() changed.
+     */
+    bool update() {
+        if (!(spare_.load(std::memory_order_relaxed) & FRESH)) return false;
+        front_ = spare_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    /**
+     * @brief Reader side: the snapshot taken by the last update().
+     */
+    const T& front() const { return buffers_[front_]; }
+
+private:
+    static constexpr unsigned INDEX = 3;
+    /**
+     * @brief Set in spare_ while it holds a snapshot the reader has not taken yet.
+     */
+    static constexpr unsigned FRESH = 4;
+
+    std::array<T, 3> buffers_{};
+    unsigned back_ = 0;
+    alignas(64) std::atomic<unsigned> spare_{1};
+    alignas(64) unsigned front_ = 2;
+};
+
+
+#endif //ALGOVISUALIZER_SNAPSHOTBUFFER_H
@@ -0,0 +1,666 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTALGORITHMS_H
+#define ALGOVISUALIZER_SORTALGORITHMS_H
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Native versions of the sorts the views animate, for benchmarking at full speed.
+ *
+ * They follow the same steps as the routines in SortRoutines.h but take any random-access range and comparator.
+ * Elements are exchanged through an unqualified swap so element types can observe it.
+ */
+
+/**
+ * @brief Receives the structure the adaptive sorts find, as index ranges into the sorted range: run() for a range
+ * that is ascending and will be handled as one piece, fallback() for a range about to be heapsorted. The selections
+ * in Selection.h add window() for the range still holding the element they look for. SortTracer has the same
+ * functions, so traced sorts pass it straight through.
+ */
+struct NoSortEvents {
+    void run(std::size_t, std::size_t) const {}
+    void fallback(std::size_t, std::size_t) const {}
+    void window(std::size_t, std::size_t) const {}
+};
+
+/**
+ * @brief Bubble sort that stops each pass at the last swap of the previous one.
+ */
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void bubbleSort(Iterator first, Iterator last, Compare compare = {}) {
+    using std::swap;
+    auto end = last - first;
+    while (end > 1) {
+        decltype(end) lastSwap = 0;
+        for (decltype(end) j = 0; j + 1 < end; ++j) {
+            if (compare(first[j + 1], first[j])) {
+                swap(first[j], first[j + 1]);
+                lastSwap = j + 1;
+            }
+        }
+        end = lastSwap;
+    }
+}
+
+/**
+ * @brief Insertion sort that shifts larger elements right one move at a time.
+ */
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void insertionSort(Iterator first, Iterator last, Compare compare = {}) {
+    if (first == last) return;
+    for (Iterator i = first + 1; i != last; ++i) {
+        auto key = std::move(*i);
+        Iterator j = i;
+        for (; j != first && compare(key, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(key);
+    }
+}
+
+namespace sort_algorithms_detail {
+    /**
+     * @brief Exponential search from first for the first element that key sorts before: the upper bound of key.
+     * Costs about 2 log k comparisons when the answer is k elements in, instead of log n for a binary search.
+     */
+    template<typename Iterator, typename T, typename Compare>
+    Iterator gallopUpper(Iterator first, Iterator last, const T& key, Compare& compare) {
+        const auto size = last - first;
+        decltype(last - first) low = 0;
+        decltype(last - first) high = 1;
+        while (high < size && !compare(key, first[high - 1])) {
+            low = high;
+            high = 2 * high + 1;
+        }
+        return std::upper_bound(first + low, first + std::min(high, size), key, compare);
+    }
+
+    /**
+     * @brief Exponential search from first for the first element that does not sort before key: its lower bound.
+     */
+    template<typename Iterator, typename T, typename Compare>
+    Iterator gallopLower(Iterator first, Iterator last, const T& key, Compare& compare) {
+        const auto size = last - first;
+        decltype(last - first) low = 0;
+        decltype(last - first) high = 1;
+        while (high < size && compare(first[high - 1], key)) {
+            low = high;
+            high = 2 * high + 1;
+        }
+        return std::lower_bound(first + low, first + std::min(high, size), key, compare);
+    }
+
+    /**
+     * @brief TimSort's merge of a buffered left run [a, aEnd) with the right run [b, bEnd) that follows the
+     * destination out in place; ties go to the left run.
+     *
+     * Elements are taken one at a time until one run wins minGallop times in a row, then the merge gallops: it
+     * searches how many elements in a row each run wins and moves them as a block, until both blocks are short
+     * again. minGallop drops while galloping pays off and rises when it does not. Merging towards the left, as
+     * TimSort's mergeHi does, is this merge over reverse iterators with the comparison flipped.
+     */
+    template<typename BufferIterator, typename Iterator, typename Compare>
+    void gallopingMerge(BufferIterator a, BufferIterator aEnd, Iterator b, Iterator bEnd, Iterator out,
+                        Compare& compare, std::ptrdiff_t& minGallop) {
+        constexpr std::ptrdiff_t MIN_GALLOP = 7;
+        while (a != aEnd && b != bEnd) {
+            std::ptrdiff_t aWins = 0;
+            std::ptrdiff_t bWins = 0;
+            while (a != aEnd && b != bEnd && aWins < minGallop && bWins < minGallop) {
+                if (compare(*b, *a)) {
+                    *out++ = std::move(*b++);
+                    ++bWins;
+                    aWins = 0;
+                } else {
+                    *out++ = std::move(*a++);
+                    ++aWins;
+                    bWins = 0;
+                }
+            }
+            while (a != aEnd && b != bEnd) {
+                const BufferIterator aRun = gallopUpper(a, aEnd, *b, compare);
+                aWins = aRun - a;
+                out = std::move(a, aRun, out);
+                a = aRun;
+                if (a == aEnd) break;
+                *out++ = std::move(*b++);
+                if (b == bEnd) break;
+                const Iterator bRun = gallopLower(b, bEnd, *a, compare);
+                bWins = bRun - b;
+                // out is behind b, so the block moves down without overlapping its own destination.
+                out = std::move(b, bRun, out);
+                b = bRun;
+                if (b == bEnd) break;
+                *out++ = std::move(*a++);
+                if (minGallop > 1) --minGallop;
+                if (aWins < MIN_GALLOP && bWins < MIN_GALLOP) {
+                    minGallop += 2;
+                    break;
+                }
+            }
+        }
+        // Whatever is left of the right run is already in place.
+        std::move(a, aEnd, out);
+    }
+
+    template<typename Iterator, typename Compare, typename Events>
+    class TimSort {
+    public:
+        using value_type = std::iter_value_t<Iterator>;
+        using difference_type = std::iter_difference_t<Iterator>;
+
+        TimSort(Iterator first, Compare& compare, Events& events) :
+            first_(first), compare_(compare), events_(events), runs_(), buffer_(), minGallop_(7) {}
+
+        void sort(difference_type size) {
+            const difference_type minRun = minRunLength(size);
+            for (difference_type base = 0; base < size;) {
+                difference_type length = countRunAndMakeAscending(first_ + base, first_ + size);
+                events_.run(index(base), index(base + length));
+                if (length < minRun) {
+                    // Short runs are extended to minRun by binary insertion so merges stay balanced.
+                    const difference_type forced = std::min(minRun, size - base);
+                    binaryInsertionSort(first_ + base, first_ + base + length, first_ + base + forced);
+                    length = forced;
+                    events_.run(index(base), index(base + length));
+                }
+                runs_.push_back({base, length});
+                mergeCollapse();
+                base += length;
+            }
+            while (runs_.size() > 1) {
+                std::size_t n = runs_.size() - 2;
+                if (n > 0 && runs_[n - 1].length < runs_[n + 1].length) --n;
+                mergeAt(n);
+            }
+        }
+
+    private:
+        struct Run {
+            difference_type base;
+            difference_type length;
+        };
+
+        static std::size_t index(difference_type offset) { return static_cast<std::size_t>(offset); }
+
+        /**
+         * @brief A run length between 32 and 64 such that size / minRun is a power of two or just below one.
+         */
+        static difference_type minRunLength(difference_type size) {
+            difference_type odd = 0;
+            while (size >= 64) {
+                odd |= size & 1;
+                size >>= 1;
+            }
+            return size + odd;
+        }
+
+        /**
+         * @brief Length of the run starting at first; a strictly descending run is reversed, which keeps the sort
+         * stable because none of its elements are equal.
+         */
+        difference_type countRunAndMakeAscending(Iterator first, Iterator last) {
+            Iterator end = first + 1;
+            if (end == last) return 1;
+            if (compare_(*end, *first)) {
+                while (++end != last && compare_(*end, *(end - 1))) {}
+                std::reverse(first, end);
+            } else {
+                while (++end != last && !compare_(*end, *(end - 1))) {}
+            }
+            return end - first;
+        }
+
+        void binaryInsertionSort(Iterator first, Iterator sortedEnd, Iterator last) {
+            for (Iterator i = sortedEnd; i != last; ++i) {
+                value_type key = std::move(*i);
+                const Iterator position = std::upper_bound(first, i, key, compare_);
+                std::move_backward(position, i, i + 1);
+                *position = std::move(key);
+            }
+        }
+
+        /**
+         * @brief Merges runs until the lengths on the stack shrink faster than the Fibonacci numbers, checking the
+         * top four runs, not three, so the invariant really holds for the whole stack.
+         */
+        void mergeCollapse() {
+            while (runs_.size() > 1) {
+                std::size_t n = runs_.size() - 2;
+                const bool topThree = n > 0 && runs_[n - 1].length <= runs_[n].length + runs_[n + 1].length;
+                const bool topFour = n > 1 && runs_[n - 2].length <= runs_[n - 1].length + runs_[n].length;
+                if (topThree || topFour) {
+                    if (runs_[n - 1].length < runs_[n + 1].length) --n;
+                } else if (runs_[n].length > runs_[n + 1].length) {
+                    break;
+                }
+                mergeAt(n);
+            }
+        }
+
+        /**
+         * @brief Merges runs n and n + 1 of the stack.
+         */
+        void mergeAt(std::size_t n) {
+            const Run left = runs_[n];
+            const Run right = runs_[n + 1];
+            runs_[n].length = left.length + right.length;
+            runs_.erase(runs_.begin() + static_cast<std::ptrdiff_t>(n) + 1);
+
+            const Iterator middle = first_ + right.base;
+            // Elements of the left run not above the right run's first, and of the right run not below the left
+            // run's last, are already in place.
+            const Iterator begin = gallopUpper(first_ + left.base, middle, *middle, compare_);
+            if (begin != middle) {
+                const Iterator end = gallopLower(middle, middle + right.length, *(middle - 1), compare_);
+                if (middle - begin <= end - middle) {
+                    buffer_.assign(std::make_move_iterator(begin), std::make_move_iterator(middle));
+                    gallopingMerge(buffer_.begin(), buffer_.end(), middle, end, begin, compare_, minGallop_);
+                } else {
+                    buffer_.assign(std::make_move_iterator(middle), std::make_move_iterator(end));
+                    auto flipped = [this](const value_type& x, const value_type& y) { return compare_(y, x); };
+                    gallopingMerge(buffer_.rbegin(), buffer_.rend(), std::make_reverse_iterator(middle),
+                                   std::make_reverse_iterator(begin), std::make_reverse_iterator(end), flipped,
+                                   minGallop_);
+                }
+            }
+            events_.run(index(left.base), index(left.base + left.length + right.length));
+        }
+
+        Iterator first_;
+        Compare& compare_;
+        Events& events_;
+        std::vector<Run> runs_;
+        std::vector<value_type> buffer_;
+        std::ptrdiff_t minGallop_;
+    };
+
+    template<typename Iterator, typename Compare>
+    void sort2(Iterator a, Iterator b, Compare& compare) {
+        using std::swap;
+        if (compare(*b, *a)) swap(*a, *b);
+    }
+
+    template<typename Iterator, typename Compare>
+    void sort3(Iterator a, Iterator b, Iterator c, Compare& compare) {
+        sort2(a, b, compare);
+        sort2(b, c, compare);
+        sort2(a, b, compare);
+    }
+
+    /**
+     * @brief Insertion sort that relies on the element before first being no larger than any in the range.
+     */
+    template<typename Iterator, typename Compare>
+    void unguardedInsertionSort(Iterator first, Iterator last, Compare& compare) {
+        if (first == last) return;
+        for (Iterator i = first + 1; i != last; ++i) {
+            if (!compare(*i, *(i - 1))) continue;
+            auto key = std::move(*i);
+            Iterator j = i;
+            do {
+                *j = std::move(*(j - 1));
+                --j;
+            } while (compare(key, *(j - 1)));
+            *j = std::move(key);
+        }
+    }
+
+    /**
+     * @brief Insertion sort that gives up once it has moved more than a few elements.
+     * @return Whether the range is now sorted.
+     */
+    template<typename Iterator, typename Compare>
+    bool partialInsertionSort(Iterator first, Iterator last, Compare& compare) {
+        constexpr std::ptrdiff_t MOVE_LIMIT = 8;
+        if (first == last) return true;
+        std::ptrdiff_t moved = 0;
+        for (Iterator i = first + 1; i != last; ++i) {
+            if (moved > MOVE_LIMIT) return false;
+            if (!compare(*i, *(i - 1))) continue;
+            auto key = std::move(*i);
+            Iterator j = i;
+            do {
+                *j = std::move(*(j - 1));
+                --j;
+            } while (j != first && compare(key, *(j - 1)));
+            *j = std::move(key);
+            moved += i - j;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Partitions around the pivot in *first, putting elements equal to it on the right.
+     * @return The pivot's final position, and whether the range was already partitioned: then no swap was made.
+     */
+    template<typename Iterator, typename Compare>
+    std::pair<Iterator, bool> partitionRight(Iterator first, Iterator last, Compare& compare) {
+        using std::swap;
+        auto pivot = std::move(*first);
+        Iterator left = first;
+        Iterator right = last;
+        while (compare(*++left, pivot)) {}
+        // Without an element left of right that is not below the pivot, the scan needs a bound.
+        if (left - 1 == first) {
+            while (left < right && !compare(*--right, pivot)) {}
+        } else {
+            while (!compare(*--right, pivot)) {}
+        }
+        const bool alreadyPartitioned = left >= right;
+        while (left < right) {
+            swap(*left, *right);
+            while (compare(*++left, pivot)) {}
+            while (!compare(*--right, pivot)) {}
+        }
+        const Iterator pivotPosition = left - 1;
+        *first = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return {pivotPosition, alreadyPartitioned};
+    }
+
+    /**
+     * @brief Partitions around the pivot in *first, putting elements equal to it on the left. Used when the pivot
+     * equals the element before the range, so the whole left side equals it and needs no further sorting.
+     */
+    template<typename Iterator, typename Compare>
+    Iterator partitionLeft(Iterator first, Iterator last, Compare& compare) {
+        using std::swap;
+        auto pivot = std::move(*first);
+        Iterator left = first;
+        Iterator right = last;
+        while (compare(pivot, *--right)) {}
+        if (right + 1 == last) {
+            while (left < right && !compare(pivot, *++left)) {}
+        } else {
+            while (!compare(pivot, *++left)) {}
+        }
+        while (left < right) {
+            swap(*left, *right);
+            while (compare(pivot, *--right)) {}
+            while (!compare(pivot, *++left)) {}
+        }
+        *first = std::move(*right);
+        *right = std::move(pivot);
+        return right;
+    }
+
+    /**
+     * @brief Swaps a few elements a quarter in from either end of a badly split partition, to break up the
+     * pattern that made the pivot choice fail.
+     */
+    template<typename Iterator>
+    void breakPatterns(Iterator first, Iterator last) {
+        using std::swap;
+        const auto size = last - first;
+        const auto quarter = size / 4;
+        swap(first[0], first[quarter]);
+        swap(last[-1], last[-quarter]);
+        if (size > 128) {
+            swap(first[1], first[quarter + 1]);
+            swap(first[2], first[quarter + 2]);
+            swap(last[-2], last[-quarter - 1]);
+            swap(last[-3], last[-quarter - 2]);
+        }
+    }
+
+    template<typename Iterator, typename Compare, typename Events>
+    void pdqSortLoop(Iterator origin, Iterator first, Iterator last, Compare& compare, Events& events, int badAllowed,
+                     bool leftmost) {
+        using std::swap;
+        constexpr std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+        constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+        auto index = [origin](Iterator it) { return static_cast<std::size_t>(it - origin); };
+        while (true) {
+            const auto size = last - first;
+            if (size < INSERTION_SORT_THRESHOLD) {
+                if (leftmost) {
+                    insertionSort(first, last, compare);
+                } else {
+                    unguardedInsertionSort(first, last, compare);
+                }
+                return;
+            }
+
+            // The pivot is the median of three, or for large ranges the median of three medians, moved to first.
+            const auto half = size / 2;
+            if (size > NINTHER_THRESHOLD) {
+                sort3(first, first + half, last - 1, compare);
+                sort3(first + 1, first + (half - 1), last - 2, compare);
+                sort3(first + 2, first + (half + 1), last - 3, compare);
+                sort3(first + (half - 1), first + half, first + (half + 1), compare);
+                swap(*first, first[half]);
+            } else {
+                sort3(first + half, first, last - 1, compare);
+            }
+
+            // A pivot equal to the previous partition's pivot means many equal elements: put them all on the left.
+            if (!leftmost && !compare(*(first - 1), *first)) {
+                first = partitionLeft(first, last, compare) + 1;
+                continue;
+            }
+
+            const auto [pivot, alreadyPartitioned] = partitionRight(first, last, compare);
+            const auto leftSize = pivot - first;
+            const auto rightSize = last - (pivot + 1);
+            if (leftSize < size / 8 || rightSize < size / 8) {
+                // Too many bad pivots would make the sort quadratic; heapsort bounds it at n log n.
+                if (--badAllowed == 0) {
+                    events.fallback(index(first), index(last));
+                    std::make_heap(first, last, compare);
+                    std::sort_heap(first, last, compare);
+                    return;
+                }
+                if (leftSize >= INSERTION_SORT_THRESHOLD) breakPatterns(first, pivot);
+                if (rightSize >= INSERTION_SORT_THRESHOLD) breakPatterns(pivot + 1, last);
+            } else if (alreadyPartitioned && partialInsertionSort(first, pivot, compare) &&
+                       partialInsertionSort(pivot + 1, last, compare)) {
+                // Both sides were all but sorted already.
+                events.run(index(first), index(last));
+                return;
+            }
+
+            pdqSortLoop(origin, first, pivot, compare, events, badAllowed, leftmost);
+            first = pivot + 1;
+            leftmost = false;
+        }
+    }
+}
+
+/**
+ * @brief TimSort: a stable merge sort over the ascending runs already present in the data.
+ *
+ * Runs are found left to right, descending ones reversed, and runs shorter than a minimum of 32 to 64 extended by
+ * binary insertion sort. The runs wait on a stack whose lengths are kept shrinking like the Fibonacci numbers, so
+ * merges stay balanced, and every merge buffers only the shorter run and gallops through stretches one run wins.
+ * Sorted and reversed input costs n - 1 comparisons and a handful of runs costs O(n log runs). events hears of
+ * every run found and of every merged run.
+ */
+template<std::random_access_iterator Iterator, typename Compare, typename Events>
+void timSort(Iterator first, Iterator last, Compare compare, Events& events) {
+    if (last - first < 2) return;
+    sort_algorithms_detail::TimSort<Iterator, Compare, Events>(first, compare, events).sort(last - first);
+}
+
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void timSort(Iterator first, Iterator last, Compare compare = {}) {
+    NoSortEvents events;
+    timSort(first, last, compare, events);
+}
+
+/**
+ * @brief Pattern-defeating quicksort, after Orson Peters: introsort that detects and exploits patterns.
+ *
+ * The pivot is a median of three or of three medians. A partition that needed no swap is finished with an insertion
+ * sort that gives up after a few moves, so sorted and nearly sorted runs take linear time; a pivot equal to its
+ * predecessor's sends every equal element left at once, so few distinct values take linear time too. A badly
+ * unbalanced split shuffles a few elements to break the pattern, and after log2 n of them the range is heapsorted,
+ * which keeps the worst case at O(n log n). Not stable. events hears of every range found sorted and of every
+ * heapsort fallback.
+ */
+template<std::random_access_iterator Iterator, typename Compare, typename Events>
+void pdqSort(Iterator first, Iterator last, Compare compare, Events& events) {
+    const auto size = last - first;
+    if (size < 2) return;
+    const auto badAllowed = static_cast<int>(std::bit_width(static_cast<std::size_t>(size)));
+    sort_algorithms_detail::pdqSortLoop(first, first, last, compare, events, badAllowed, true);
+}
+
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void pdqSort(Iterator first, Iterator last, Compare compare = {}) {
+    NoSortEvents events;
+    pdqSort(first, last, compare, events);
+}
+
+namespace sort_algorithms_detail {
+    /**
+     * @brief Stable merge of the ascending runs [first, middle) and [middle, last) in place, through a cache of a
+     * fixed number of elements that may be empty.
+     *
+     * As long as both runs are longer than the cache, the longer one is cut in half, the matching cut in the other
+     * is found by binary search and the two middle pieces are swapped with a rotation; that leaves two independent
+     * merges of about half the size, the smaller of which recurses while the larger continues the loop, so the
+     * stack stays O(log n) deep. Once the shorter run fits the cache it is merged like in TimSort.
+     */
+    template<typename Iterator, typename Compare, typename Cache>
+    void mergeInPlace(Iterator first, Iterator middle, Iterator last, Compare& compare, Cache cache) {
+        using value_type = std::iter_value_t<Iterator>;
+        const auto cacheSize = static_cast<std::iter_difference_t<Iterator>>(cache.size());
+        std::ptrdiff_t minGallop = 7;
+        while (first != middle && middle != last) {
+            // Elements of the left run not above the right run's first, and of the right run not below the left
+            // run's last, are already in place.
+            first = gallopUpper(first, middle, *middle, compare);
+            if (first == middle) return;
+            last = gallopLower(middle, last, *(middle - 1), compare);
+            const auto left = middle - first;
+            const auto right = last - middle;
+            if (left <= cacheSize && left <= right) {
+                const auto cacheEnd = std::move(first, middle, cache.begin());
+                gallopingMerge(cache.begin(), cacheEnd, middle, last, first, compare, minGallop);
+                return;
+            }
+            if (right <= cacheSize) {
+                const auto cacheEnd = std::move(middle, last, cache.begin());
+                auto flipped = [&compare](const value_type& x, const value_type& y) { return compare(y, x); };
+                gallopingMerge(std::make_reverse_iterator(cacheEnd), std::make_reverse_iterator(cache.begin()),
+                               std::make_reverse_iterator(middle), std::make_reverse_iterator(first),
+                               std::make_reverse_iterator(last), flipped, minGallop);
+                return;
+            }
+            // Ties stay on the left: left elements equal to a right cut stay before it, right elements equal to a
+            // left cut stay after it.
+            Iterator leftCut;
+            Iterator rightCut;
+            if (left >= right) {
+                leftCut = first + left / 2;
+                rightCut = std::lower_bound(middle, last, *leftCut, compare);
+            } else {
+                rightCut = middle + right / 2;
+                leftCut = std::upper_bound(first, middle, *rightCut, compare);
+            }
+            const Iterator newMiddle = std::rotate(leftCut, middle, rightCut);
+            if ((newMiddle - first) <= (last - newMiddle)) {
+                mergeInPlace(first, leftCut, newMiddle, compare, cache);
+                first = newMiddle;
+                middle = rightCut;
+            } else {
+                mergeInPlace(newMiddle, rightCut, last, compare, cache);
+                last = newMiddle;
+                middle = leftCut;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stable merge sort in place: no allocation, and besides an O(log n) deep stack a fixed 2 KB cache of elements.
+ *
+ * Runs of 32 are insertion sorted and then merged bottom up with mergeInPlace, which rotates blocks of the two runs
+ * past each other until the pieces left to merge fit the cache. Merges whose runs already fit cost O(n) moves like
+ * any merge, the longer ones O(n log n), so the sort does O(n log n) comparisons and O(n log^2 n) moves where
+ * std::stable_sort does O(n log n) of both with an O(n) buffer, and std::stable_sort's fallback without a
+ * buffer is the same rotation scheme with no cache at all. events hears of every sorted run and every merged run.
+ */
+template<std::random_access_iterator Iterator, typename Compare, typename Events>
+void inPlaceMergeSort(Iterator first, Iterator last, Compare compare, Events& events) {
+    using value_type = std::iter_value_t<Iterator>;
+    using difference_type = std::iter_difference_t<Iterator>;
+    constexpr difference_type RUN = 32;
+    constexpr std::size_t CACHE_BYTES = 2048;
+    constexpr std::size_t CACHE_ELEMENTS = std::default_initializable<value_type>
+            ? std::max<std::size_t>(1, CACHE_BYTES / sizeof(value_type)) : 0;
+    std::array<value_type, CACHE_ELEMENTS> cache{};
+
+    const difference_type size = last - first;
+    auto index = [](difference_type offset) { return static_cast<std::size_t>(offset); };
+    for (difference_type base = 0; base < size; base += RUN) {
+        const difference_type end = std::min(base + RUN, size);
+        insertionSort(first + base, first + end, compare);
+        events.run(index(base), index(end));
+    }
+    for (difference_type width = RUN; width < size; width *= 2) {
+        for (difference_type base = 0; base + width < size; base += 2 * width) {
+            const difference_type end = std::min(base + 2 * width, size);
+            sort_algorithms_detail::mergeInPlace(first + base, first + base + width, first + end, compare,
+                                                 std::span<value_type>(cache));
+            events.run(index(base), index(end));
+        }
+    }
+}
+
+template<std::random_access_iterator Iterator, typename Compare = std::less<>>
+void inPlaceMergeSort(Iterator first, Iterator last, Compare compare = {}) {
+    NoSortEvents events;
+    inPlaceMergeSort(first, last, compare, events);
+}
+
+/**
+ * @brief Builds McIlroy's "killer adversary" input of size elements for a comparison sort.
+ *
+ * The values are decided while sort runs over them: every element starts as "gas", larger than every decided value,
+ * and whenever two gas elements are compared the one that looks like the pivot candidate is frozen to the next
+ * smallest value. A quicksort then keeps picking the smallest remaining element as its pivot. The result is a
+ * permutation of 1 to size that drives a deterministic quicksort, or pdqSort, into its worst case.
+ * @param sort Called as sort(first, last, compare) on a vector of indices.
+ */
+template<typename Sort>
+std::vector<int> quicksortAdversary(std::size_t size, Sort sort) {
+    const int gas = static_cast<int>(size) + 1;
+    std::vector<int> values(size, gas);
+    std::vector<std::size_t> order(size);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    int frozen = 0;
+    std::size_t candidate = 0;
+    sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        if (values[x] == gas && values[y] == gas) {
+            values[x == candidate ? x : y] = ++frozen;
+        }
+        if (values[x] == gas) {
+            candidate = x;
+        } else if (values[y] == gas) {
+            candidate = y;
+        }
+        return values[x] < values[y];
+    });
+    // Elements never frozen only met decided values; any order among them is consistent with what sort saw.
+    for (const std::size_t i : order) {
+        if (values[i] == gas) values[i] = ++frozen;
+    }
+    return values;
+}
+
+
+#endif //ALGOVISUALIZER_SORTALGORITHMS_H
@@ -0,0 +1,86 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SortEngine.h"
+#include <algorithm>
+
+SortEngine::SortEngine() :
+    routine_(),
+    lastOp_(),
+    comparisons_(0),
+    swaps_(0),
+    writes_(0),
+    sortedBegin_(0),
+    sortedEnd_(0),
+    touched_() {
+}
+
+void SortEngine::start(SortRoutine routine) {
+    routine_ = std::move(routine);
+    lastOp_ = SortOp{};
+    comparisons_ = 0;
+    swaps_ = 0;
+    writes_ = 0;
+    sortedBegin_ = 0;
+    sortedEnd_ = 0;
+    touched_.clear();
+}
+
+bool SortEngine::step() {
+    if (!routine_.next()) {
+        return false;
+    }
+    lastOp_ = routine_.op();
+    switch (lastOp_.kind) {
+        case SortOp::Kind::Compare:
+            comparisons_++;
+            touched_.push_back(lastOp_.i);
+            touched_.push_back(lastOp_.j);
+            break;
+        case SortOp::Kind::Swap:
+            swaps_++;
+            touched_.push_back(lastOp_.i);
+            touched_.push_back(lastOp_.j);
+            break;
+        case SortOp::Kind::Write:
+            writes_++;
+            touched_.push_back(lastOp_.i);
+            break;
+        case SortOp::Kind::Sorted:
+            sortedBegin_ = lastOp_.i;
+            sortedEnd_ = lastOp_.j;
+            break;
+        case SortOp::Kind::Run:
+        case SortOp::Kind::Fallback:
+        case SortOp::Kind::Window:
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+std::size_t SortEngine::run(std::size_t maxOps, std::chrono::nanoseconds budget) {
+    // Reading the clock costs about as much as a step, so it is read after the first step and then after twice as
+    // many steps as before, up to every MAX_CLOCK_INTERVAL steps.
+    constexpr std::size_t MAX_CLOCK_INTERVAL = 256;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    touched_.clear();
+    std::size_t ops = 0;
+    std::size_t nextClock = 1;
+    while (ops < maxOps && step()) {
+        ++ops;
+        if (ops == nextClock) {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            nextClock = ops + std::min(ops, MAX_CLOCK_INTERVAL);
+        }
+    }
+    return ops;
+}
+
+void SortEngine::finish() {
+    // Nothing is tracked here: the whole array may have changed, so callers redraw everything anyway.
+    while (step()) {
+        touched_.clear();
+    }
+}
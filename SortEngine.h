@@ -0,0 +1,64 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTENGINE_H
+#define ALGOVISUALIZER_SORTENGINE_H
+#include "SortRoutine.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Drives a SortRoutine a bounded number of steps at a time and keeps the counters the views display.
+ *
+ * Each frame the views call run() with an op limit and a time budget; the engine resumes the routine until
+ * either is used up, so the sort speed no longer depends on how much work one update() used to do. Views leave the
+ * limit unbounded unless they want a fixed pace, and the budget decides.
+ */
+class SortEngine {
+public:
+    SortEngine();
+
+    void start(SortRoutine routine);
+    /**
+     * @brief Runs up to maxOps steps, stopping early once budget has elapsed. At least one step is run.
+     * @return Number of steps run.
+     */
+    std::size_t run(std::size_t maxOps, std::chrono::nanoseconds budget);
+    /**
+     * @brief Runs the routine to completion.
+     */
+    void finish();
+
+    [[nodiscard]] bool running() const { return !routine_.done(); }
+    [[nodiscard]] const SortOp& lastOp() const { return lastOp_; }
+    [[nodiscard]] unsigned long long comparisons() const { return comparisons_; }
+    [[nodiscard]] unsigned long long swaps() const { return swaps_; }
+    [[nodiscard]] unsigned long long writes() const { return writes_; }
+    /**
+     * @brief Range most recently reported as holding final values.
+     */
+    [[nodiscard]] std::size_t sortedBegin() const { return sortedBegin_; }
+    [[nodiscard]] std::size_t sortedEnd() const { return sortedEnd_; }
+    /**
+     * @brief Indices compared, swapped or written during the last run(), in order and with repeats.
+     */
+    [[nodiscard]] const std::vector<std::uint32_t>& touched() const { return touched_; }
+
+private:
+    bool step();
+
+    SortRoutine routine_;
+    SortOp lastOp_;
+    unsigned long long comparisons_;
+    unsigned long long swaps_;
+    unsigned long long writes_;
+    std::size_t sortedBegin_;
+    std::size_t sortedEnd_;
+    std::vector<std::uint32_t> touched_;
+};
+
+
+#endif //ALGOVISUALIZER_SORTENGINE_H
@@ -0,0 +1,114 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SortInstrumentation.h"
+#include <bit>
+#include <thread>
+
+thread_local SortTracer* SortTracer::active_ = nullptr;
+
+SortOpBuffer::SortOpBuffer(std::size_t capacity) :
+    capacity_(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+    ops_(std::make_unique<SortOp[]>(capacity_)),
+    finished_(false),
+    cancelled_(false),
+    head_(0),
+    cachedTail_(0),
+    tail_(0),
+    cachedHead_(0) {
+}
+
+bool SortOpBuffer::tryPush(const SortOp& op) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head - cachedTail_ == capacity_) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        if (head - cachedTail_ == capacity_) return false;
+    }
+    ops_[head & (capacity_ - 1)] = op;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void SortOpBuffer::push(const SortOp& op) {
+    while (!tryPush(op)) {
+        if (cancelled_.load(std::memory_order_acquire)) {
+            throw SortTraceCancelled();
+        }
+        std::this_thread::yield();
+    }
+}
+
+std::size_t SortOpBuffer::pop(SortOp* out, std::size_t max) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (cachedHead_ - tail < max) {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+    }
+    const std::size_t count = std::min(max, cachedHead_ - tail);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = ops_[(tail + i) & (capacity_ - 1)];
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+bool SortOpBuffer::drained() const {
+    // Read finished_ first: once it is set, head_ no longer moves.
+    return finished_.load(std::memory_order_acquire) &&
+           head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+}
+
+SortTracer::SortTracer(const void* begin, std::size_t count, std::size_t elementSize, SortOpSink& sink) :
+    begin_(static_cast<const unsigned char*>(begin)),
+    count_(count),
+    elementSize_(elementSize),
+    sink_(sink),
+    previous_(std::exchange(active_, this)) {
+}
+
+SortTracer::~SortTracer() {
+    active_ = previous_;
+}
+
+std::uint32_t SortTracer::indexOf(const void* element) const {
+    const auto* address = static_cast<const unsigned char*>(element);
+    // Compare as integers: ordering pointers into different objects is unspecified.
+    const auto offset = reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(begin_);
+    if (offset >= count_ * elementSize_) return NO_INDEX;
+    return static_cast<std::uint32_t>(offset / elementSize_);
+}
+
+void SortTracer::compare(const void* a, const void* b) {
+    const std::uint32_t i = indexOf(a);
+    const std::uint32_t j = indexOf(b);
+    // A comparison against a temporary, such as a pivot or the element being inserted, is shown on the array side.
+    if (i != NO_INDEX || j != NO_INDEX) {
+        sink_.push(SortOp::compare(i != NO_INDEX ? i : j, j != NO_INDEX ? j : i));
+    }
+}
+
+void SortTracer::write(const void* element, int value) {
+    const std::uint32_t i = indexOf(element);
+    if (i != NO_INDEX) {
+        sink_.push(SortOp::write(i, value));
+    }
+}
+
+void SortTracer::swap(std::uint32_t a, std::uint32_t b) {
+    sink_.push(SortOp::swap(a, b));
+}
+
+void SortTracer::sorted(std::size_t begin, std::size_t end) {
+    sink_.push(SortOp::sorted(begin, end));
+}
+
+void SortTracer::run(std::size_t begin, std::size_t end) {
+    sink_.push(SortOp::run(begin, end));
+}
+
+void SortTracer::fallback(std::size_t begin, std::size_t end) {
+    sink_.push(SortOp::fallback(begin, end));
+}
+
+void SortTracer::window(std::size_t begin, std::size_t end) {
+    sink_.push(SortOp::window(begin, end));
+}
@@ -0,0 +1,334 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTINSTRUMENTATION_H
+#define ALGOVISUALIZER_SORTINSTRUMENTATION_H
+#include "SortRoutine.h"
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Thrown out of a traced algorithm when its op buffer is cancelled, to unwind it early.
+ */
+class SortTraceCancelled : public std::runtime_error {
+public:
+    SortTraceCancelled() : std::runtime_error("Sort trace cancelled") {}
+};
+
+/**
+ * @brief Where a SortTracer sends the operations it records.
+ */
+class SortOpSink {
+public:
+    virtual ~SortOpSink() = default;
+    /**
+     * @brief May throw SortTraceCancelled to abandon the traced algorithm.
+     */
+    virtual void push(const SortOp& op) = 0;
+};
+
+/**
+ * @brief Lock-free single-producer single-consumer ring of SortOps.
+ *
+ * The thread running a traced algorithm pushes; the visualizer pops a frame's worth at a time. Each side keeps a
+ * cached copy of the other's position and only reloads it when the ring looks full or empty, so in the common case
+ * a push or pop touches no cache line the other thread writes. A full ring blocks the producer, which throttles the
+ * algorithm to the playback speed without buffering the whole trace.
+ */
+class SortOpBuffer : public SortOpSink {
+public:
+    explicit SortOpBuffer(std::size_t capacity);
+    SortOpBuffer(const SortOpBuffer&) = delete;
+    SortOpBuffer& operator=(const SortOpBuffer&) = delete;
+
+    bool tryPush(const SortOp& op);
+    /**
+     * @brief Pushes op, yielding while the ring is full.
+     * @throws SortTraceCancelled once cancel() has been called.
+     */
+    void push(const SortOp& op) override;
+    /**
+     * @brief Pops up to max ops into out.
+     * @return Number of ops popped.
+     */
+    std::size_t pop(SortOp* out, std::size_t max);
+
+    /**
+     * @brief Producer side: no more ops will follow.
+     */
+    void finish() { finished_.store(true, std::memory_order_release); }
+    /**
+     * @brief Whether the producer finished and every op has been popped.
+     */
+    [[nodiscard]] bool drained() const;
+    /**
+     * @brief Consumer side: makes a blocked or future push throw SortTraceCancelled.
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_release); }
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+    std::size_t capacity_;
+    std::unique_ptr<SortOp[]> ops_;
+    std::atomic<bool> finished_;
+    std::atomic<bool> cancelled_;
+    alignas(64) std::atomic<std::size_t> head_;
+    std::size_t cachedTail_;
+    alignas(64) std::atomic<std::size_t> tail_;
+    std::size_t cachedHead_;
+};
+
+/**
+ * @brief Maps the elements of one contiguous traced array to indices and sends their ops to a sink.
+ *
+ * Constructing a tracer makes it the active one on the calling thread until it is destroyed. counted elements
+ * report to the active tracer; elements outside its array, such as an algorithm's temporaries or scratch buffers,
+ * are not recorded themselves, but moving them back into the array is.
+ */
+class SortTracer {
+public:
+    static constexpr std::uint32_t NO_INDEX = UINT32_MAX;
+
+    SortTracer(const void* begin, std::size_t count, std::size_t elementSize, SortOpSink& sink);
+    SortTracer(const SortTracer&) = delete;
+    SortTracer& operator=(const SortTracer&) = delete;
+    ~SortTracer();
+
+    static SortTracer* active() { return active_; }
+
+    [[nodiscard]] std::uint32_t indexOf(const void* element) const;
+    void compare(const void* a, const void* b);
+    void write(const void* element, int value);
+    void swap(std::uint32_t a, std::uint32_t b);
+    void sorted(std::size_t begin, std::size_t end);
+    /**
+     * @brief Run, Fallback and Window ops, so a tracer can be handed to the adaptive sorts in SortAlgorithms.h and
+     * the selections in Selection.h as their events.
+     */
+    void run(std::size_t begin, std::size_t end);
+    void fallback(std::size_t begin, std::size_t end);
+    void window(std::size_t begin, std::size_t end);
+    [[nodiscard]] std::size_t size() const { return count_; }
+
+private:
+    static thread_local SortTracer* active_;
+
+    const unsigned char* begin_;
+    std::size_t count_;
+    std::size_t elementSize_;
+    SortOpSink& sink_;
+    SortTracer* previous_;
+};
+
+/**
+ * @brief Value recorded in a Write op; overload it next to a type to trace counted elements of that type.
+ */
+template<typename T>
+    requires std::is_arithmetic_v<T>
+int traceValue(const T& value) {
+    if constexpr (std::is_same_v<T, int>) {
+        return value;
+    } else {
+        return static_cast<int>(value);
+    }
+}
+
+template<typename T, bool Traced = true>
+class counted;
+
+namespace sort_instrumentation_detail {
+    template<typename T>
+    struct IsCounted : std::false_type {};
+    template<typename T, bool Traced>
+    struct IsCounted<counted<T, Traced>> : std::true_type {
+        static constexpr bool traced = Traced;
+    };
+}
+
+/**
+ * @brief Value wrapper that reports every comparison, every copy or move into the traced array and every swap to
+ * the active SortTracer, so any standard algorithm run over counted elements can be replayed.
+ *
+ * With Traced false every operation is the plain operation on T and the special members are defaulted, so a
+ * counted<T, false> is exactly as trivial as T and the same algorithm code can be benchmarked without tracing.
+ */
+template<typename T, bool Traced>
+class counted {
+public:
+    counted() = default;
+    counted(T value) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::move(value)) {}
+
+    counted(const counted&) requires (!Traced) = default;
+    counted(counted&&) requires (!Traced) = default;
+    counted& operator=(const counted&) requires (!Traced) = default;
+    counted& operator=(counted&&) requires (!Traced) = default;
+
+    // The traced members are not noexcept: recording throws SortTraceCancelled out of a cancelled trace.
+    counted(const counted& other) requires Traced : value_(other.value_) { recordWrite(); }
+    counted(counted&& other) requires Traced : value_(std::move(other.value_)) { recordWrite(); }
+    counted& operator=(const counted& other) requires Traced {
+        value_ = other.value_;
+        recordWrite();
+        return *this;
+    }
+    counted& operator=(counted&& other) requires Traced {
+        value_ = std::move(other.value_);
+        recordWrite();
+        return *this;
+    }
+    ~counted() = default;
+
+    [[nodiscard]] const T& value() const { return value_; }
+
+    friend bool operator==(const counted& a, const counted& b) {
+        recordCompare(a, b);
+        return a.value_ == b.value_;
+    }
+    friend auto operator<=>(const counted& a, const counted& b) {
+        recordCompare(a, b);
+        return a.value_ <=> b.value_;
+    }
+    friend void swap(counted& a, counted& b) noexcept(!Traced) {
+        using std::swap;
+        swap(a.value_, b.value_);
+        if constexpr (Traced) {
+            if (SortTracer* tracer = SortTracer::active()) {
+                recordSwap(*tracer, a, b, tracer->indexOf(&a), tracer->indexOf(&b));
+            }
+        }
+    }
+
+    /**
+     * @brief Swaps without recording, for callers that record the swap themselves.
+     */
+    static void swapUntraced(counted& a, counted& b) noexcept {
+        using std::swap;
+        swap(a.value_, b.value_);
+    }
+    /**
+     * @brief Records a swap of a and b, which already happened, as one Swap op if both are in the traced array.
+     */
+    static void recordSwap(SortTracer& tracer, const counted& a, const counted& b, std::uint32_t aIndex,
+                           std::uint32_t bIndex) {
+        if (aIndex != SortTracer::NO_INDEX && bIndex != SortTracer::NO_INDEX) {
+            tracer.swap(aIndex, bIndex);
+        } else if (aIndex != SortTracer::NO_INDEX) {
+            tracer.write(&a, traceValue(a.value_));
+        } else if (bIndex != SortTracer::NO_INDEX) {
+            tracer.write(&b, traceValue(b.value_));
+        }
+    }
+
+private:
+    void recordWrite() const {
+        if (SortTracer* tracer = SortTracer::active()) {
+            tracer->write(this, traceValue(value_));
+        }
+    }
+    static void recordCompare(const counted& a, const counted& b) {
+        if constexpr (Traced) {
+            if (SortTracer* tracer = SortTracer::active()) {
+                tracer->compare(&a, &b);
+            }
+        }
+    }
+
+    T value_{};
+};
+
+/**
+ * @brief Random-access iterator adaptor over counted elements that records iter_swap by position.
+ *
+ * std::ranges algorithms exchange elements through iter_swap; this one swaps the values without going through
+ * three recorded moves and reports a single Swap op whose indices come from the iterators themselves, measured from
+ * the iterator the range was instrumented with. With untraced elements it is a plain wrapper that inlines away.
+ */
+template<std::random_access_iterator Iterator>
+    requires sort_instrumentation_detail::IsCounted<std::iter_value_t<Iterator>>::value
+class instrumented_iterator {
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::iter_value_t<Iterator>;
+    using difference_type = std::iter_difference_t<Iterator>;
+    using reference = std::iter_reference_t<Iterator>;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+
+    instrumented_iterator() = default;
+    instrumented_iterator(Iterator it, Iterator origin) : it_(it), origin_(origin) {}
+
+    [[nodiscard]] Iterator base() const { return it_; }
+    [[nodiscard]] std::uint32_t index() const { return static_cast<std::uint32_t>(it_ - origin_); }
+
+    reference operator*() const { return *it_; }
+    pointer operator->() const { return std::to_address(it_); }
+    reference operator[](difference_type n) const { return it_[n]; }
+
+    instrumented_iterator& operator++() {
+        ++it_;
+        return *this;
+    }
+    instrumented_iterator operator++(int) {
+        instrumented_iterator previous = *this;
+        ++it_;
+        return previous;
+    }
+    instrumented_iterator& operator--() {
+        --it_;
+        return *this;
+    }
+    instrumented_iterator operator--(int) {
+        instrumented_iterator previous = *this;
+        --it_;
+        return previous;
+    }
+    instrumented_iterator& operator+=(difference_type n) {
+        it_ += n;
+        return *this;
+    }
+    instrumented_iterator& operator-=(difference_type n) {
+        it_ -= n;
+        return *this;
+    }
+    friend instrumented_iterator operator+(instrumented_iterator it, difference_type n) { return it += n; }
+    friend instrumented_iterator operator+(difference_type n, instrumented_iterator it) { return it += n; }
+    friend instrumented_iterator operator-(instrumented_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const instrumented_iterator& a, const instrumented_iterator& b) { return a.it_ - b.it_; }
+    friend bool operator==(const instrumented_iterator& a, const instrumented_iterator& b) { return a.it_ == b.it_; }
+    friend auto operator<=>(const instrumented_iterator& a, const instrumented_iterator& b) { return a.it_ <=> b.it_; }
+
+    friend void iter_swap(const instrumented_iterator& a, const instrumented_iterator& b) {
+        value_type::swapUntraced(*a, *b);
+        if constexpr (sort_instrumentation_detail::IsCounted<value_type>::traced) {
+            if (SortTracer* tracer = SortTracer::active()) {
+                value_type::recordSwap(*tracer, *a, *b, a.index(), b.index());
+            }
+        }
+    }
+
+private:
+    Iterator it_{};
+    Iterator origin_{};
+};
+
+/**
+ * @brief Begin and end instrumented iterators over a container of counted elements.
+ */
+template<typename Container>
+auto instrumented(Container& container) {
+    using Iterator = decltype(std::ranges::begin(container));
+    const Iterator begin = std::ranges::begin(container);
+    return std::pair{instrumented_iterator<Iterator>(begin, begin),
+                     instrumented_iterator<Iterator>(std::ranges::end(container), begin)};
+}
+
+
+#endif //ALGOVISUALIZER_SORTINSTRUMENTATION_H
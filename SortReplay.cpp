@@ -0,0 +1,97 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SortReplay.h"
+#include <algorithm>
+
+SortReplay::SortReplay(const DataSpec& spec, SortRoutine (*routine)(std::vector<int>&)) :
+    trace(std::make_unique<SortTrace>(SortTrace::record(generateData(spec), routine))),
+    player(*trace),
+    opsPerFrame(1),
+    reverse(false),
+    paused(false),
+    bars(),
+    drawnPosition(0),
+    screenWidth(0),
+    screenHeight(0) {
+    const auto& initial = trace->initial();
+    bars.setMaxValue(initial.empty() ? 1 : *std::max_element(initial.begin(), initial.end()));
+}
+
+void SortReplay::update() {
+    if (paused) return;
+    if (reverse) {
+        player.rewind(opsPerFrame);
+    } else {
+        player.advance(opsPerFrame);
+    }
+}
+
+void SortReplay::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    if (player.position() != drawnPosition) {
+        drawnPosition = player.position();
+        bars.invalidate();
+        const SortOp& op = player.lastOp();
+        if (drawnPosition > 0 && !op.isRange()) {
+            bars.touch(op.i);
+            if (op.kind != SortOp::Kind::Write) {
+                bars.touch(op.j);
+            }
+        }
+    }
+    bars.setSortedRange(player.state().sortedBegin, player.state().sortedEnd);
+    bars.render(renderer, player.values());
+
+    // Progress through the trace along the top edge.
+    const double progress = player.size() ? static_cast<double>(player.position()) / static_cast<double>(player.size()) : 1.0;
+    SDL_SetRenderDrawColor(renderer, reverse ? 255 : 0, 128, reverse ? 0 : 255, 255);
+    SDL_Rect bar = {0, 0, static_cast<int>(progress * screenWidth), 6};
+    SDL_RenderFillRect(renderer, &bar);
+    SDL_RenderPresent(renderer);
+}
+
+void SortReplay::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    const auto key = event.key.keysym.sym;
+    switch (key) {
+        case SDLK_SPACE:
+            paused = !paused;
+            break;
+        case SDLK_LEFT:
+            reverse = true;
+            break;
+        case SDLK_RIGHT:
+            reverse = false;
+            break;
+        case SDLK_UP:
+            opsPerFrame = std::min<std::size_t>(opsPerFrame * 2, std::size_t{1} << 30);
+            break;
+        case SDLK_DOWN:
+            opsPerFrame = std::max<std::size_t>(opsPerFrame / 2, 1);
+            break;
+        case SDLK_HOME:
+            player.seek(0);
+            break;
+        case SDLK_END:
+            player.seek(player.size());
+            break;
+        default:
+            if (key >= SDLK_0 && key <= SDLK_9) {
+                player.seek(player.size() * static_cast<std::size_t>(key - SDLK_0) / 10);
+            }
+            break;
+    }
+}
+
+void SortReplay::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    bars.setScreenDimensions(width, height);
+}
+
+void SortReplay::setOpsPerFrame(std::size_t ops) {
+    opsPerFrame = ops;
+}
@@ -0,0 +1,45 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTREPLAY_H
+#define ALGOVISUALIZER_SORTREPLAY_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "SortTrace.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Records a sort at native speed, then plays the trace back at any speed and in either direction.
+ *
+ * Keys: space pauses, left/right pick the direction, up/down double or halve the speed, home/end jump to the
+ * ends and 0-9 seek to that tenth of the trace.
+ */
+class SortReplay : public IRenderable{
+public:
+    SortReplay(const DataSpec& spec, SortRoutine (*routine)(std::vector<int>&));
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    void setOpsPerFrame(std::size_t ops);
+
+private:
+    std::unique_ptr<SortTrace> trace;
+    SortTracePlayer player;
+    std::size_t opsPerFrame;
+    bool reverse;
+    bool paused;
+    BarRenderer bars;
+    /**
+     * @brief Trace position the bars were last drawn at; seeking can change any element, so a move redraws all.
+     */
+    std::size_t drawnPosition;
+    int screenWidth;
+    int screenHeight;
+};
+
+
+#endif //ALGOVISUALIZER_SORTREPLAY_H
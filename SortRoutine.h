@@ -0,0 +1,123 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTROUTINE_H
+#define ALGOVISUALIZER_SORTROUTINE_H
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+/**
+ * @brief One observable step of a sort: what the algorithm just did to the array.
+ *
+ * Compare and Swap name two indices, Write names one index and the value stored there, and Sorted reports that
+ * the range [i, j) holds its final values. Run and Fallback describe the structure an adaptive sort works with:
+ * Run reports [i, j) as one ascending run, found in the input or formed by a merge, and Fallback reports that
+ * [i, j) is about to be heapsorted because partitioning it kept failing. Window reports that a selection has narrowed
+ * the range that must hold the element it is looking for down to [i, j).
+ */
+struct SortOp {
+    enum class Kind : std::uint8_t { Compare, Swap, Write, Sorted, Run, Fallback, Window };
+
+    Kind kind = Kind::Compare;
+    std::uint32_t i = 0;
+    std::uint32_t j = 0;
+    int value = 0;
+
+    static SortOp compare(std::size_t a, std::size_t b) {
+        return {Kind::Compare, static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b), 0};
+    }
+    static SortOp swap(std::size_t a, std::size_t b) {
+        return {Kind::Swap, static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b), 0};
+    }
+    static SortOp write(std::size_t index, int newValue) {
+        return {Kind::Write, static_cast<std::uint32_t>(index), 0, newValue};
+    }
+    static SortOp sorted(std::size_t begin, std::size_t end) {
+        return {Kind::Sorted, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end), 0};
+    }
+    static SortOp run(std::size_t begin, std::size_t end) {
+        return {Kind::Run, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end), 0};
+    }
+    static SortOp fallback(std::size_t begin, std::size_t end) {
+        return {Kind::Fallback, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end), 0};
+    }
+    static SortOp window(std::size_t begin, std::size_t end) {
+        return {Kind::Window, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end), 0};
+    }
+    /**
+     * @brief Whether j is the end of a range rather than a second element.
+     */
+    [[nodiscard]] bool isRange() const {
+        return kind == Kind::Sorted || kind == Kind::Run || kind == Kind::Fallback || kind == Kind::Window;
+    }
+};
+
+/**
+ * @brief Coroutine that runs a sort as straight-line code and suspends after every SortOp it yields.
+ *
+ * The coroutine frame is allocated once when the routine is created; resuming and yielding do not allocate,
+ * so a driver can run millions of steps per frame. The routine only starts when it is first resumed.
+ */
+class SortRoutine {
+public:
+    struct promise_type {
+        SortOp current{};
+
+        SortRoutine get_return_object() {
+            return SortRoutine(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(SortOp op) noexcept {
+            current = op;
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::rethrow_exception(std::current_exception()); }
+    };
+
+    SortRoutine() : handle_(nullptr) {}
+    SortRoutine(const SortRoutine&) = delete;
+    SortRoutine& operator=(const SortRoutine&) = delete;
+    SortRoutine(SortRoutine&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    SortRoutine& operator=(SortRoutine&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~SortRoutine() { reset(); }
+
+    /**
+     * @brief Runs the sort up to its next step.
+     * @return false once the sort has finished; op() is then no longer meaningful.
+     */
+    bool next() {
+        if (!handle_ || handle_.done()) {
+            return false;
+        }
+        handle_.resume();
+        return !handle_.done();
+    }
+    [[nodiscard]] const SortOp& op() const { return handle_.promise().current; }
+    [[nodiscard]] bool done() const { return !handle_ || handle_.done(); }
+
+private:
+    explicit SortRoutine(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    void reset() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+
+#endif //ALGOVISUALIZER_SORTROUTINE_H
@@ -0,0 +1,77 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SortRoutines.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+// GCC lowers every coroutine into a switch over its suspend points without a default label.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wswitch-default"
+#endif
+
+SortRoutine bubbleSortRoutine(std::vector<int>& data) {
+    std::size_t end = data.size();
+    while (end > 1) {
+        std::size_t lastSwap = 0;
+        for (std::size_t j = 0; j + 1 < end; ++j) {
+            co_yield SortOp::compare(j, j + 1);
+            if (data[j + 1] < data[j]) {
+                std::swap(data[j], data[j + 1]);
+                co_yield SortOp::swap(j, j + 1);
+                lastSwap = j + 1;
+            }
+        }
+        // Nothing was swapped past lastSwap, so everything from there on is already in place.
+        end = lastSwap;
+        co_yield SortOp::sorted(end, data.size());
+    }
+    co_yield SortOp::sorted(0, data.size());
+}
+
+SortRoutine insertionSortRoutine(std::vector<int>& data) {
+    for (std::size_t i = 1; i < data.size(); ++i) {
+        const int key = data[i];
+        std::size_t j = i;
+        while (j > 0) {
+            co_yield SortOp::compare(j - 1, j);
+            if (data[j - 1] <= key) {
+                break;
+            }
+            data[j] = data[j - 1];
+            co_yield SortOp::write(j, data[j]);
+            --j;
+        }
+        if (j != i) {
+            data[j] = key;
+            co_yield SortOp::write(j, key);
+        }
+        co_yield SortOp::sorted(0, i + 1);
+    }
+    co_yield SortOp::sorted(0, data.size());
+}
+
+SortRoutine bitonicSortRoutine(std::vector<int>& data) {
+    const std::size_t size = data.size();
+    const std::size_t padded = std::bit_ceil(std::max<std::size_t>(size, 1));
+    for (std::size_t block = 2; block <= padded; block <<= 1) {
+        for (std::size_t distance = block >> 1; distance > 0; distance >>= 1) {
+            // The first stage of each merge compares mirrored positions, which makes the two halves one bitonic
+            // sequence without reversing either; the remaining stages are plain half-cleaners.
+            const std::size_t mask = distance == block >> 1 ? block - 1 : distance;
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::size_t partner = i ^ mask;
+                if (partner <= i || partner >= size) {
+                    continue;
+                }
+                co_yield SortOp::compare(i, partner);
+                if (data[partner] < data[i]) {
+                    std::swap(data[i], data[partner]);
+                    co_yield SortOp::swap(i, partner);
+                }
+            }
+        }
+    }
+    co_yield SortOp::sorted(0, size);
+}
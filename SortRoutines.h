@@ -0,0 +1,28 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTROUTINES_H
+#define ALGOVISUALIZER_SORTROUTINES_H
+#include "SortRoutine.h"
+#include <vector>
+
+/**
+ * @brief Bubble sort that stops each pass at the last swap of the previous one.
+ */
+SortRoutine bubbleSortRoutine(std::vector<int>& data);
+/**
+ * @brief Insertion sort that shifts larger elements right one write at a time.
+ */
+SortRoutine insertionSortRoutine(std::vector<int>& data);
+/**
+ * @brief Bitonic sorting network, emitted one parallel stage of compare-exchanges after another.
+ *
+ * The array is treated as padded with +infinity up to a power of two; every comparator puts the smaller value at
+ * the lower index, so comparators that reach into the padding never fire and are skipped. This is the network the
+ * vectorized kernel in VectorSort.h applies inside its registers.
+ */
+SortRoutine bitonicSortRoutine(std::vector<int>& data);
+
+
+#endif //ALGOVISUALIZER_SORTROUTINES_H
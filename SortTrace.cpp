@@ -0,0 +1,184 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "SortTrace.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    void putVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    std::uint64_t getVarint(const std::vector<std::uint8_t>& bytes, std::size_t& offset) {
+        std::uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            const std::uint8_t byte = bytes[offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+    }
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    /**
+     * @brief Low bits of an op's first varint that hold its kind.
+     */
+    constexpr int KIND_BITS = 3;
+    static_assert(static_cast<int>(SortOp::Kind::Window) < 1 << KIND_BITS);
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+}
+
+SortTrace::SortTrace(std::vector<int> initial, std::size_t keyframeInterval) :
+    keyframeInterval_(keyframeInterval ? keyframeInterval : std::max<std::size_t>(4096, initial.size() * 4)),
+    opCount_(0),
+    bytes_(),
+    keyframes_(),
+    values_(initial),
+    state_(),
+    previousIndex_(0) {
+    keyframes_.push_back({0, 0, SortTraceState{}, std::move(initial)});
+}
+
+SortTrace::~SortTrace() = default;
+SortTrace::SortTrace(SortTrace&& other) noexcept = default;
+SortTrace& SortTrace::operator=(SortTrace&& other) noexcept = default;
+
+SortTrace SortTrace::record(std::vector<int> data, SortRoutine (*routine)(std::vector<int>&)) {
+    SortTrace trace(data);
+    SortRoutine sort = routine(data);
+    while (sort.next()) {
+        trace.append(sort.op());
+    }
+    return trace;
+}
+
+void SortTrace::apply(const SortOp& op, std::vector<int>& values, SortTraceState& state) {
+    switch (op.kind) {
+        case SortOp::Kind::Compare:
+            state.comparisons++;
+            break;
+        case SortOp::Kind::Swap:
+            std::swap(values[op.i], values[op.j]);
+            state.swaps++;
+            break;
+        case SortOp::Kind::Write:
+            values[op.i] = op.value;
+            state.writes++;
+            break;
+        case SortOp::Kind::Sorted:
+            state.sortedBegin = op.i;
+            state.sortedEnd = op.j;
+            break;
+        case SortOp::Kind::Run:
+        case SortOp::Kind::Fallback:
+        case SortOp::Kind::Window:
+            break;
+        default:
+            break;
+    }
+}
+
+void SortTrace::append(const SortOp& op) {
+    // Ranges [i, j) may be empty and may end at the array's end; point ops name elements.
+    const bool inside = op.isRange() ? op.i <= op.j && op.j <= values_.size()
+                                     : op.i < values_.size() && (op.kind == SortOp::Kind::Write || op.j < values_.size());
+    if (!inside) {
+        throw std::out_of_range("SortTrace: op index outside the array");
+    }
+    if (opCount_ > 0 && opCount_ % keyframeInterval_ == 0) {
+        keyframes_.push_back({bytes_.size(), previousIndex_, state_, values_});
+    }
+    const auto kind = static_cast<std::uint64_t>(op.kind);
+    putVarint(bytes_, zigzag(static_cast<std::int64_t>(op.i) - previousIndex_) << KIND_BITS | kind);
+    if (op.kind == SortOp::Kind::Write) {
+        putVarint(bytes_, zigzag(static_cast<std::int64_t>(op.value) - values_[op.i]));
+    } else {
+        putVarint(bytes_, zigzag(static_cast<std::int64_t>(op.j) - op.i));
+    }
+    previousIndex_ = op.i;
+    apply(op, values_, state_);
+    ++opCount_;
+}
+
+std::size_t SortTrace::keyframeBytes() const {
+    std::size_t total = 0;
+    for (const auto& keyframe : keyframes_) {
+        total += keyframe.values.size() * sizeof(int);
+    }
+    return total;
+}
+
+SortTracePlayer::SortTracePlayer(const SortTrace& trace) :
+    trace_(trace),
+    position_(0),
+    byteOffset_(0),
+    previousIndex_(0),
+    values_(trace.initial()),
+    state_(),
+    lastOp_() {
+}
+
+void SortTracePlayer::restore(std::size_t keyframe) {
+    const auto& frame = trace_.keyframes_[keyframe];
+    position_ = keyframe * trace_.keyframeInterval_;
+    byteOffset_ = frame.byteOffset;
+    previousIndex_ = frame.previousIndex;
+    values_ = frame.values;
+    state_ = frame.state;
+    lastOp_ = SortOp{};
+}
+
+SortOp SortTracePlayer::decodeNext() {
+    const std::uint64_t head = getVarint(trace_.bytes_, byteOffset_);
+    SortOp op;
+    op.kind = static_cast<SortOp::Kind>(head & ((1u << KIND_BITS) - 1));
+    op.i = static_cast<std::uint32_t>(previousIndex_ + unzigzag(head >> KIND_BITS));
+    const std::int64_t second = unzigzag(getVarint(trace_.bytes_, byteOffset_));
+    if (op.kind == SortOp::Kind::Write) {
+        op.value = static_cast<int>(values_[op.i] + second);
+    } else {
+        op.j = static_cast<std::uint32_t>(op.i + second);
+    }
+    previousIndex_ = op.i;
+    return op;
+}
+
+std::size_t SortTracePlayer::advance(std::size_t ops) {
+    const std::size_t target = std::min(trace_.size(), position_ + ops);
+    const std::size_t played = target - position_;
+    while (position_ < target) {
+        lastOp_ = decodeNext();
+        SortTrace::apply(lastOp_, values_, state_);
+        ++position_;
+    }
+    return played;
+}
+
+void SortTracePlayer::seek(std::size_t position) {
+    position = std::min(position, trace_.size());
+    // The keyframe before the op that leads to position, so at least that op is decoded and becomes lastOp().
+    const std::size_t keyframe = position == 0 ? 0 : std::min((position - 1) / trace_.keyframeInterval_,
+                                                              trace_.keyframes_.size() - 1);
+    // Playing forward is cheaper than restoring as long as no keyframe lies in between.
+    if (position < position_ || keyframe * trace_.keyframeInterval_ > position_) {
+        restore(keyframe);
+    }
+    advance(position - position_);
+}
+
+void SortTracePlayer::rewind(std::size_t ops) {
+    seek(position_ > ops ? position_ - ops : 0);
+}
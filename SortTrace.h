@@ -0,0 +1,123 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTTRACE_H
+#define ALGOVISUALIZER_SORTTRACE_H
+#include "SortRoutine.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Counters and sorted range reached after a prefix of a trace.
+ */
+struct SortTraceState {
+    unsigned long long comparisons = 0;
+    unsigned long long swaps = 0;
+    unsigned long long writes = 0;
+    std::uint32_t sortedBegin = 0;
+    std::uint32_t sortedEnd = 0;
+};
+
+/**
+ * @brief Compact recording of every SortOp a sort produced, decoupled from the frame rate.
+ *
+ * Ops are stored as varints: the first index as a zigzag delta from the previous op's first index with the op
+ * kind in the low three bits, the second index as a delta from the first, and written values as a delta from the
+ * value they overwrite. Neighbouring compares and swaps therefore take two bytes. Every keyframeInterval ops the
+ * whole array is copied into a keyframe, so a player can seek anywhere by replaying at most one interval.
+ */
+class SortTrace {
+public:
+    /**
+     * @param initial Array before the first op.
+     * @param keyframeInterval Ops between keyframes; 0 picks one that keeps keyframes about as large as the ops.
+     */
+    explicit SortTrace(std::vector<int> initial, std::size_t keyframeInterval = 0);
+    ~SortTrace();
+    SortTrace(SortTrace&& other) noexcept;
+    SortTrace& operator=(SortTrace&& other) noexcept;
+
+    /**
+     * @brief Runs a sort routine on a copy of data to completion and records every op.
+     */
+    static SortTrace record(std::vector<int> data, SortRoutine (*routine)(std::vector<int>&));
+
+    void append(const SortOp& op);
+
+    [[nodiscard]] std::size_t size() const { return opCount_; }
+    [[nodiscard]] std::size_t encodedBytes() const { return bytes_.size(); }
+    [[nodiscard]] std::size_t keyframeBytes() const;
+    [[nodiscard]] const std::vector<int>& initial() const { return keyframes_.front().values; }
+    /**
+     * @brief Array after the last recorded op.
+     */
+    [[nodiscard]] const std::vector<int>& current() const { return values_; }
+
+private:
+    friend class SortTracePlayer;
+
+    struct Keyframe {
+        std::size_t byteOffset;
+        std::uint32_t previousIndex;
+        SortTraceState state;
+        std::vector<int> values;
+    };
+
+    static void apply(const SortOp& op, std::vector<int>& values, SortTraceState& state);
+
+    std::size_t keyframeInterval_;
+    std::size_t opCount_;
+    std::vector<std::uint8_t> bytes_;
+    std::vector<Keyframe> keyframes_;
+    /**
+     * @brief Array and counters after the last appended op; needed to encode writes as deltas.
+     */
+    std::vector<int> values_;
+    SortTraceState state_;
+    std::uint32_t previousIndex_;
+};
+
+/**
+ * @brief Replays a SortTrace forwards, backwards or from any position.
+ */
+class SortTracePlayer {
+public:
+    explicit SortTracePlayer(const SortTrace& trace);
+
+    /**
+     * @brief Moves to the state right after op number position (0 is the initial array).
+     */
+    void seek(std::size_t position);
+    /**
+     * @brief Plays up to ops ops forwards.
+     * @return Number of ops played.
+     */
+    std::size_t advance(std::size_t ops);
+    /**
+     * @brief Steps back by ops ops, restoring the nearest earlier keyframe and replaying from there.
+     */
+    void rewind(std::size_t ops);
+
+    [[nodiscard]] std::size_t position() const { return position_; }
+    [[nodiscard]] std::size_t size() const { return trace_.size(); }
+    [[nodiscard]] const std::vector<int>& values() const { return values_; }
+    [[nodiscard]] const SortTraceState& state() const { return state_; }
+    [[nodiscard]] const SortOp& lastOp() const { return lastOp_; }
+
+private:
+    void restore(std::size_t keyframe);
+    SortOp decodeNext();
+
+    const SortTrace& trace_;
+    std::size_t position_;
+    std::size_t byteOffset_;
+    std::uint32_t previousIndex_;
+    std::vector<int> values_;
+    SortTraceState state_;
+    SortOp lastOp_;
+};
+
+
+#endif //ALGOVISUALIZER_SORTTRACE_H
@@ -0,0 +1,331 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_SORTVISUALIZER_H
+#define ALGOVISUALIZER_SORTVISUALIZER_H
+#include "BarRenderer.h"
+#include "IRenderable.hpp"
+#include "SortEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Elements small and trivial enough for the sort to move them itself; anything else is sorted by index.
+ */
+template<typename T>
+concept DirectSortable = std::is_trivially_copyable_v<T> && sizeof(T) <= 16;
+
+/**
+ * @brief Projections bar heights can be taken from: they map an element to a number.
+ */
+template<typename Projection, typename T>
+concept BarProjection =
+        std::regular_invocable<const Projection&, const T&> &&
+        std::is_arithmetic_v<std::remove_cvref_t<std::invoke_result_t<const Projection&, const T&>>>;
+
+namespace sort_visualizer_detail {
+    /**
+     * @brief The array being sorted, as slots the sort routines compare and move.
+     *
+     * Direct storage: the slots are the elements themselves.
+     */
+    template<typename T, bool Direct = DirectSortable<T>>
+    class Storage {
+    public:
+        using Slot = T;
+
+        explicit Storage(std::vector<T> values) : values_(std::move(values)) {}
+
+        [[nodiscard]] std::size_t size() const { return values_.size(); }
+        Slot& slot(std::size_t i) { return values_[i]; }
+        [[nodiscard]] const T& value(const Slot& slot) const { return slot; }
+        [[nodiscard]] const T& operator[](std::size_t i) const { return values_[i]; }
+        /**
+         * @brief Stores the elements in slot order; they already are.
+         */
+        void settle() {}
+        [[nodiscard]] const std::vector<T>& values() const { return values_; }
+
+    private:
+        std::vector<T> values_;
+    };
+
+    /**
+     * @brief Indirect storage: elements stay where they are and the slots are 32-bit indices into them, so a swap
+     * exchanges two indices however large the elements are.
+     */
+    template<typename T>
+    class Storage<T, false> {
+    public:
+        using Slot = std::uint32_t;
+
+        explicit Storage(std::vector<T> values) : values_(std::move(values)), order_(values_.size()) {
+            std::iota(order_.begin(), order_.end(), Slot{0});
+        }
+
+        [[nodiscard]] std::size_t size() const { return values_.size(); }
+        Slot& slot(std::size_t i) { return order_[i]; }
+        [[nodiscard]] const T& value(Slot slot) const { return values_[slot]; }
+        [[nodiscard]] const T& operator[](std::size_t i) const { return values_[order_[i]]; }
+        /**
+         * @brief Moves every element to its slot's position, once, and resets the slots to the identity.
+         */
+        void settle() {
+            std::vector<T> ordered;
+            ordered.reserve(values_.size());
+            for (const Slot index : order_) {
+                ordered.push_back(std::move(values_[index]));
+            }
+            values_ = std::move(ordered);
+            std::iota(order_.begin(), order_.end(), Slot{0});
+        }
+        [[nodiscard]] const std::vector<T>& values() const { return values_; }
+
+    private:
+        std::vector<T> values_;
+        std::vector<Slot> order_;
+    };
+}
+
+// GCC lowers every coroutine into a switch over its suspend points without a default label.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-default"
+#endif
+
+/**
+ * @brief Animates a sort over any element type, ordered by compare on the projected elements like std::ranges::sort.
+ *
+ * Bars are drawn from the same projection: each frame the heights of the elements the sort touched are projected
+ * and scaled once into a buffer of ints the BarRenderer reads, whatever the element type. Small trivially copyable
+ * elements are sorted in place, and refreshing every height is then a straight loop over contiguous numbers the
+ * compiler vectorizes; heavier elements are sorted through an index array and moved into order once, when the sort
+ * finishes. NaN keys are not supported.
+ */
+template<typename T, typename Compare = std::ranges::less, typename Projection = std::identity>
+    requires BarProjection<Projection, T> &&
+             std::indirect_strict_weak_order<Compare, std::projected<const T*, Projection>>
+class SortVisualizer : public IRenderable {
+public:
+    enum class Algorithm { Bubble, Insertion };
+
+    /**
+     * @brief Whether the sort moves the elements themselves rather than indices to them.
+     */
+    static constexpr bool DIRECT = DirectSortable<T>;
+
+    SortVisualizer(std::vector<T> values, Algorithm kind, Compare comparison = {}, Projection proj = {}) :
+        storage(std::move(values)),
+        compare(std::move(comparison)),
+        projection(std::move(proj)),
+        algorithm(kind),
+        engine(),
+        bars(),
+        heights(storage.size()),
+        keyMin(0.0),
+        heightScale(0.0),
+        opsPerFrame(std::numeric_limits<std::size_t>::max()),
+        frameBudget(std::chrono::milliseconds(4)),
+        sorting(false) {
+        bars.setMaxValue(BAR_RESOLUTION);
+        measureKeys();
+        refreshHeights();
+    }
+    SortVisualizer(const SortVisualizer&) = delete;
+    SortVisualizer& operator=(const SortVisualizer&) = delete;
+
+    void update() override {
+        if (!sorting) return;
+        engine.run(opsPerFrame, frameBudget);
+        afterRun();
+    }
+
+    void render(SDL_Renderer* renderer) override {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        bars.render(renderer, heights);
+        SDL_RenderPresent(renderer);
+    }
+
+    void startSort() {
+        sorting = true;
+        engine.start(algorithm == Algorithm::Bubble ? bubbleSortRoutine() : insertionSortRoutine());
+        bars.setSortedRange(0, 0);
+    }
+    /**
+     * @brief Runs the started sort to completion at once.
+     */
+    void finishSort() {
+        if (!sorting) return;
+        engine.finish();
+        afterRun();
+        // finish() tracks no touched elements, so every height is stale.
+        refreshHeights();
+    }
+
+    void setScreenDimensions(int width, int height) { bars.setScreenDimensions(width, height); }
+    /**
+     * @brief Upper bound on sort steps per frame, unbounded by default; fewer are run once the frame budget runs out.
+     */
+    void setOpsPerFrame(std::size_t ops) { opsPerFrame = ops; }
+    void setFrameBudget(std::chrono::microseconds budget) { frameBudget = budget; }
+
+    [[nodiscard]] bool running() const { return sorting; }
+    [[nodiscard]] const SortEngine& getEngine() const { return engine; }
+    [[nodiscard]] std::size_t size() const { return storage.size(); }
+    /**
+     * @brief Element drawn at position i.
+     */
+    [[nodiscard]] const T& operator[](std::size_t i) const { return storage[i]; }
+    /**
+     * @brief The elements, in sorted order once the sort has finished.
+     */
+    [[nodiscard]] const std::vector<T>& values() const { return storage.values(); }
+    /**
+     * @brief Bar heights as drawn, in [1, BAR_RESOLUTION].
+     */
+    [[nodiscard]] const std::vector<int>& barHeights() const { return heights; }
+
+    static constexpr int BAR_RESOLUTION = 1 << 16;
+
+private:
+    using Storage = sort_visualizer_detail::Storage<T>;
+    using Slot = typename Storage::Slot;
+
+    [[nodiscard]] bool less(const Slot& a, const Slot& b) const {
+        return std::invoke(compare, std::invoke(projection, storage.value(a)),
+                           std::invoke(projection, storage.value(b)));
+    }
+
+    [[nodiscard]] double key(const T& value) const {
+        return static_cast<double>(std::invoke(projection, value));
+    }
+
+    [[nodiscard]] int heightOf(const T& value) const {
+        return 1 + static_cast<int>((key(value) - keyMin) * heightScale);
+    }
+
+    /**
+     * @brief Maps the key range onto [1, BAR_RESOLUTION]; sorting never changes it.
+     */
+    void measureKeys() {
+        if (storage.size() == 0) return;
+        double low = key(storage[0]);
+        double high = low;
+        for (std::size_t i = 1; i < storage.size(); ++i) {
+            const double k = key(storage[i]);
+            low = std::min(low, k);
+            high = std::max(high, k);
+        }
+        keyMin = low;
+        heightScale = high > low ? (BAR_RESOLUTION - 1) / (high - low) : 0.0;
+    }
+
+    void refreshHeights() {
+        if constexpr (DIRECT) {
+            // Locals rather than members, so the compiler need not assume the stores change them.
+            const double low = keyMin;
+            const double scale = heightScale;
+            const Projection& project = projection;
+            std::ranges::transform(storage.values(), heights.begin(), [low, scale, &project](const T& value) noexcept(
+                    std::is_nothrow_invocable_v<const Projection&, const T&>) {
+                return 1 + static_cast<int>((static_cast<double>(std::invoke(project, value)) - low) * scale);
+            });
+        } else {
+            for (std::size_t i = 0; i < heights.size(); ++i) {
+                heights[i] = heightOf(storage[i]);
+            }
+        }
+        bars.invalidate();
+    }
+
+    void afterRun() {
+        const auto& touched = engine.touched();
+        // Past a quarter of the array the contiguous pass is cheaper than chasing indices with repeats.
+        if (touched.size() > heights.size() / 4) {
+            refreshHeights();
+        } else {
+            for (const std::uint32_t i : touched) {
+                heights[i] = heightOf(storage[i]);
+            }
+        }
+        bars.touch(touched);
+        bars.setSortedRange(engine.sortedBegin(), engine.sortedEnd());
+        if (!engine.running()) {
+            sorting = false;
+            storage.settle();
+        }
+    }
+
+    SortRoutine bubbleSortRoutine() {
+        using std::swap;
+        std::size_t end = storage.size();
+        while (end > 1) {
+            std::size_t lastSwap = 0;
+            for (std::size_t j = 0; j + 1 < end; ++j) {
+                co_yield SortOp::compare(j, j + 1);
+                if (less(storage.slot(j + 1), storage.slot(j))) {
+                    swap(storage.slot(j), storage.slot(j + 1));
+                    co_yield SortOp::swap(j, j + 1);
+                    lastSwap = j + 1;
+                }
+            }
+            end = lastSwap;
+            co_yield SortOp::sorted(end, storage.size());
+        }
+        co_yield SortOp::sorted(0, storage.size());
+    }
+
+    SortRoutine insertionSortRoutine() {
+        for (std::size_t i = 1; i < storage.size(); ++i) {
+            Slot held = std::move(storage.slot(i));
+            std::size_t j = i;
+            while (j > 0) {
+                co_yield SortOp::compare(j - 1, j);
+                if (!less(held, storage.slot(j - 1))) {
+                    break;
+                }
+                storage.slot(j) = std::move(storage.slot(j - 1));
+                co_yield SortOp::write(j, heightOf(storage[j]));
+                --j;
+            }
+            storage.slot(j) = std::move(held);
+            if (j != i) {
+                co_yield SortOp::write(j, heightOf(storage[j]));
+            }
+            co_yield SortOp::sorted(0, i + 1);
+        }
+        co_yield SortOp::sorted(0, storage.size());
+    }
+
+    Storage storage;
+    Compare compare;
+    Projection projection;
+    Algorithm algorithm;
+    SortEngine engine;
+    BarRenderer bars;
+    std::vector<int> heights;
+    double keyMin;
+    double heightScale;
+    std::size_t opsPerFrame;
+    std::chrono::microseconds frameBudget;
+    bool sorting;
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+#endif //ALGOVISUALIZER_SORTVISUALIZER_H
@@ -0,0 +1,179 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "StdAlgorithmView.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+    /**
+     * @brief Roughly how many frames one run should take, guessing a few operations per element and level.
+     */
+    constexpr std::size_t REPLAY_FRAMES = 600;
+    constexpr std::size_t BUFFER_CAPACITY = std::size_t{1} << 16;
+
+    void runTraced(StdAlgorithmView::Algorithm algorithm, const std::vector<int>& input, SortOpBuffer& buffer) {
+        std::vector<counted<int>> values(input.begin(), input.end());
+        const std::size_t size = values.size();
+        try {
+            SortTracer tracer(values.data(), size, sizeof(counted<int>), buffer);
+            switch (algorithm) {
+                case StdAlgorithmView::Algorithm::Sort:
+                    std::sort(values.begin(), values.end());
+                    tracer.sorted(0, size);
+                    break;
+                case StdAlgorithmView::Algorithm::StableSort:
+                    std::stable_sort(values.begin(), values.end());
+                    tracer.sorted(0, size);
+                    break;
+                case StdAlgorithmView::Algorithm::HeapSort:
+                    std::make_heap(values.begin(), values.end());
+                    std::sort_heap(values.begin(), values.end());
+                    tracer.sorted(0, size);
+                    break;
+                case StdAlgorithmView::Algorithm::NthElement: {
+                    if (size == 0) break;
+                    const auto nth = values.begin() + static_cast<std::ptrdiff_t>(size / 2);
+                    std::nth_element(values.begin(), nth, values.end());
+                    tracer.sorted(size / 2, size / 2 + 1);
+                    break;
+                }
+                case StdAlgorithmView::Algorithm::RangesSort: {
+                    const auto [first, last] = instrumented(values);
+                    std::ranges::sort(first, last);
+                    tracer.sorted(0, size);
+                    break;
+                }
+                default:
+                    break;
+            }
+        } catch (const SortTraceCancelled&) {
+            // The view restarted or closed; the half-sorted values are simply dropped.
+        }
+        buffer.finish();
+    }
+}
+
+StdAlgorithmView::StdAlgorithmView(const DataSpec& spec) :
+    algorithm(Algorithm::Sort),
+    data(),
+    buffer(),
+    worker(),
+    frameOps(),
+    opsPerFrame(1),
+    bars(),
+    dataSpec(spec) {
+    bars.setMaxValue(spec.maxValue);
+    bars.setColors(SDL_Color{255, 255, 255, 255},  // White for bars not yet in their final place
+                   SDL_Color{0, 255, 0, 255},      // Green once the algorithm reports them final
+                   SDL_Color{255, 0, 0, 255});     // Red for elements compared or moved this frame
+    start(algorithm);
+}
+
+StdAlgorithmView::~StdAlgorithmView() {
+    stop();
+}
+
+void StdAlgorithmView::stop() {
+    if (buffer) {
+        buffer->cancel();
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void StdAlgorithmView::start(Algorithm newAlgorithm) {
+    stop();
+    algorithm = newAlgorithm;
+    data = generateData(dataSpec);
+    std::size_t levels = 1;
+    while (std::size_t{1} << levels < data.size()) ++levels;
+    opsPerFrame = std::max<std::size_t>(1, 2 * data.size() * levels / REPLAY_FRAMES);
+    buffer = std::make_unique<SortOpBuffer>(BUFFER_CAPACITY);
+    worker = std::jthread(runTraced, algorithm, data, std::ref(*buffer));
+    bars.setSortedRange(0, 0);
+    bars.invalidate();
+}
+
+void StdAlgorithmView::update() {
+    frameOps.resize(opsPerFrame);
+    const std::size_t count = buffer->pop(frameOps.data(), frameOps.size());
+    for (std::size_t k = 0; k < count; ++k) {
+        const SortOp& op = frameOps[k];
+        switch (op.kind) {
+            case SortOp::Kind::Compare:
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Swap:
+                std::swap(data[op.i], data[op.j]);
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Write:
+                data[op.i] = op.value;
+                bars.touch(op.i);
+                break;
+            case SortOp::Kind::Sorted:
+                bars.setSortedRange(op.i, op.j);
+                break;
+            case SortOp::Kind::Run:
+            case SortOp::Kind::Fallback:
+            case SortOp::Kind::Window:
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void StdAlgorithmView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    SDL_RenderPresent(renderer);
+}
+
+void StdAlgorithmView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_s:
+            start(Algorithm::Sort);
+            break;
+        case SDLK_t:
+            start(Algorithm::StableSort);
+            break;
+        case SDLK_h:
+            start(Algorithm::HeapSort);
+            break;
+        case SDLK_n:
+            start(Algorithm::NthElement);
+            break;
+        case SDLK_g:
+            start(Algorithm::RangesSort);
+            break;
+        case SDLK_r:
+            ++dataSpec.seed;
+            start(algorithm);
+            break;
+        case SDLK_d: {
+            const auto next = std::find(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end(), dataSpec.distribution) + 1;
+            dataSpec.distribution = next == ALL_DISTRIBUTIONS.end() ? ALL_DISTRIBUTIONS.front() : *next;
+            start(algorithm);
+            break;
+        }
+        case SDLK_UP:
+            opsPerFrame = std::min<std::size_t>(opsPerFrame * 2, BUFFER_CAPACITY);
+            break;
+        case SDLK_DOWN:
+            opsPerFrame = std::max<std::size_t>(opsPerFrame / 2, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void StdAlgorithmView::setScreenDimensions(int width, int height) {
+    bars.setScreenDimensions(width, height);
+}
@@ -0,0 +1,58 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_STDALGORITHMVIEW_H
+#define ALGOVISUALIZER_STDALGORITHMVIEW_H
+#include "BarRenderer.h"
+#include "DataGenerator.h"
+#include "IRenderable.hpp"
+#include "SortInstrumentation.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs a standard library algorithm over counted elements on a worker thread and plays its operations back
+ * as they stream in.
+ *
+ * The worker pushes every compare, write and swap into a SortOpBuffer and stalls while it is full, so the algorithm
+ * runs exactly as fast as it is shown. Keys: s std::sort, t std::stable_sort, h std::make_heap + std::sort_heap,
+ * n std::nth_element of the median, g std::ranges::sort through instrumented iterators; r restarts on new data, d
+ * switches to the next input distribution and up/down double or halve the speed.
+ */
+class StdAlgorithmView : public IRenderable {
+public:
+    enum class Algorithm { Sort, StableSort, HeapSort, NthElement, RangesSort };
+
+    explicit StdAlgorithmView(const DataSpec& spec);
+    StdAlgorithmView(const StdAlgorithmView&) = delete;
+    StdAlgorithmView& operator=(const StdAlgorithmView&) = delete;
+    ~StdAlgorithmView() override;
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Cancels the running algorithm, generates the input of the current spec and starts algorithm on it.
+     */
+    void start(Algorithm algorithm);
+
+private:
+    void stop();
+
+    Algorithm algorithm;
+    std::vector<int> data;
+    std::unique_ptr<SortOpBuffer> buffer;
+    /**
+     * @brief Declared after buffer so it is joined before the buffer it pushes into is freed.
+     */
+    std::jthread worker;
+    std::vector<SortOp> frameOps;
+    std::size_t opsPerFrame;
+    BarRenderer bars;
+    DataSpec dataSpec;
+};
+
+
+#endif //ALGOVISUALIZER_STDALGORITHMVIEW_H
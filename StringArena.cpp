@@ -0,0 +1,158 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "StringArena.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fmt/core.h>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    std::runtime_error systemError(std::string_view what, const std::string& path) {
+        return std::runtime_error(fmt::format("Failed to {} {}: {}", what, path, std::system_category().message(errno)));
+    }
+}
+#endif
+
+StringArena::StringArena() :
+    data_(nullptr),
+    size_(0),
+    mapped_(false),
+    owned_(),
+    strings_() {
+}
+
+StringArena::StringArena(StringArena&& other) noexcept :
+    data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0)),
+    mapped_(std::exchange(other.mapped_, false)),
+    owned_(std::move(other.owned_)),
+    strings_(std::move(other.strings_)) {
+}
+
+StringArena& StringArena::operator=(StringArena&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        owned_ = std::move(other.owned_);
+        strings_ = std::move(other.strings_);
+    }
+    return *this;
+}
+
+StringArena::~StringArena() {
+    release();
+}
+
+void StringArena::release() noexcept {
+#ifdef __linux__
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+StringArena StringArena::mapFile(const std::string& path) {
+    StringArena arena;
+#ifdef __linux__
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw systemError("open", path);
+    struct stat status{};
+    if (fstat(fd, &status) != 0) {
+        const auto error = systemError("stat", path);
+        close(fd);
+        throw error;
+    }
+    arena.size_ = static_cast<std::size_t>(status.st_size);
+    if (arena.size_ > 0) {
+        void* mapping = mmap(nullptr, arena.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            const auto error = systemError("map", path);
+            close(fd);
+            throw error;
+        }
+        arena.data_ = static_cast<const char*>(mapping);
+        arena.mapped_ = true;
+        // Read ahead while the lines are split, which touches every page once in order.
+        madvise(mapping, arena.size_, MADV_SEQUENTIAL);
+    }
+    // The mapping keeps the file open on its own.
+    close(fd);
+    arena.splitLines();
+    if (arena.mapped_) {
+        // Sorting reads the strings in no particular order; stop reading ahead, but keep what is cached.
+        madvise(const_cast<char*>(arena.data_), arena.size_, MADV_RANDOM);
+    }
+#else
+    // Without mmap the whole file is read into the arena's own bytes instead.
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error(fmt::format("Failed to open {}", path));
+    }
+    arena.owned_.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(arena.owned_.data(), static_cast<std::streamsize>(arena.owned_.size()))) {
+        throw std::runtime_error(fmt::format("Failed to read {}", path));
+    }
+    arena.data_ = arena.owned_.data();
+    arena.size_ = arena.owned_.size();
+    arena.splitLines();
+#endif
+    return arena;
+}
+
+StringArena StringArena::generate(std::size_t count, std::uint64_t seed) {
+    constexpr std::array<std::string_view, 4> PREFIXES = {"", "http://www.", "user_", "2019-10-26T"};
+    constexpr std::uint64_t MIN_LENGTH = 1;
+    constexpr std::uint64_t MAX_LENGTH = 16;
+    StringArena arena;
+    std::mt19937_64 random(seed);
+    arena.owned_.reserve(count * 16);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string_view prefix = PREFIXES[random() % PREFIXES.size()];
+        arena.owned_.insert(arena.owned_.end(), prefix.begin(), prefix.end());
+        const std::uint64_t length = MIN_LENGTH + random() % (MAX_LENGTH - MIN_LENGTH + 1);
+        for (std::uint64_t j = 0; j < length; ++j) {
+            arena.owned_.push_back(static_cast<char>('a' + random() % 26));
+        }
+        arena.owned_.push_back('\n');
+    }
+    arena.data_ = arena.owned_.data();
+    arena.size_ = arena.owned_.size();
+    arena.splitLines();
+    return arena;
+}
+
+void StringArena::splitLines() {
+    strings_.clear();
+    std::size_t begin = 0;
+    while (begin < size_) {
+        const void* newline = std::memchr(data_ + begin, '\n', size_ - begin);
+        const std::size_t end = newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - data_) : size_;
+        std::size_t length = end - begin;
+        if (length > 0 && data_[begin + length - 1] == '\r') --length;
+        if (length > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error(fmt::format("Line at byte {} is {} bytes long, more than a string may hold",
+                                                 begin, length));
+        }
+        strings_.push_back({begin, static_cast<std::uint32_t>(length)});
+        begin = end + 1;
+    }
+}
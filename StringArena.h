@@ -0,0 +1,74 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_STRINGARENA_H
+#define ALGOVISUALIZER_STRINGARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One string of a StringArena: where its bytes start in the arena and how many there are.
+ */
+struct StringRef {
+    std::uint64_t offset;
+    std::uint32_t length;
+};
+
+/**
+ * @brief Many strings in one block of bytes, each referred to by a StringRef instead of owning a std::string.
+ *
+ * The block is either a file mapped read-only (read into memory where there is no mmap), whose lines are the
+ * strings, or bytes the arena generated itself. Sorting then moves 16-byte StringRefs around and reads the bytes in
+ * place; there is no allocation per string.
+ */
+class StringArena {
+public:
+    /**
+     * @brief Maps the file at path, or reads it on platforms without mmap, and makes every line a string, without
+     * its "\n" or "\r\n".
+     */
+    static StringArena mapFile(const std::string& path);
+    /**
+     * @brief count words made of lowercase letters, a quarter of them behind each of a few shared prefixes such as
+     * "http://www.", so that sorting them has to look past the first few bytes. The same seed gives the same words.
+     */
+    static StringArena generate(std::size_t count, std::uint64_t seed);
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&& other) noexcept;
+    StringArena& operator=(StringArena&& other) noexcept;
+    ~StringArena();
+
+    [[nodiscard]] const char* bytes() const { return data_; }
+    [[nodiscard]] std::size_t byteCount() const { return size_; }
+    [[nodiscard]] std::string_view view(const StringRef& string) const {
+        return {data_ + string.offset, string.length};
+    }
+    /**
+     * @brief The strings in file or generation order until someone sorts them.
+     */
+    [[nodiscard]] std::vector<StringRef>& strings() { return strings_; }
+    [[nodiscard]] const std::vector<StringRef>& strings() const { return strings_; }
+
+private:
+    StringArena();
+    void release() noexcept;
+    void splitLines();
+
+    const char* data_;
+    std::size_t size_;
+    /**
+     * @brief Whether data_ is a mapping to unmap, rather than owned_.data().
+     */
+    bool mapped_;
+    std::vector<char> owned_;
+    std::vector<StringRef> strings_;
+};
+
+
+#endif //ALGOVISUALIZER_STRINGARENA_H
@@ -0,0 +1,293 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_STRINGSORT_H
+#define ALGOVISUALIZER_STRINGSORT_H
+#include "StringArena.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Observer that records nothing; calls to it compile away.
+ *
+ * The string sorts report every exchange of two strings as swapped(a, b) and every string they store as
+ * wrote(position, string), with positions as indices into the array being sorted.
+ */
+struct NullStringSortObserver {
+    void swapped(std::size_t, std::size_t) {}
+    void wrote(std::size_t, const StringRef&) {}
+};
+
+namespace string_sort_detail {
+    /**
+     * @brief Ranges this small are finished by insertion sort.
+     */
+    constexpr std::size_t INSERTION_CUTOFF = 16;
+    /**
+     * @brief Below this many strings a radix pass costs more than multikey quicksort on the range.
+     */
+    constexpr std::size_t RADIX_CUTOFF = 64;
+    /**
+     * @brief A burstsort bucket over this many strings is burst into a trie node.
+     */
+    constexpr std::size_t BURST_LIMIT = 8192;
+    /**
+     * @brief One symbol per byte value, plus 0 for "the string has ended", which sorts first.
+     */
+    constexpr std::size_t SYMBOLS = 257;
+
+    inline unsigned symbolAt(const char* base, const StringRef& string, std::size_t depth) {
+        return depth < string.length ? static_cast<unsigned>(static_cast<unsigned char>(base[string.offset + depth])) + 1
+                                     : 0;
+    }
+
+    /**
+     * @brief Whether a sorts before b, given that they agree on their first depth bytes.
+     */
+    inline bool lessFrom(const char* base, const StringRef& a, const StringRef& b, std::size_t depth) {
+        const std::string_view x(base + a.offset + depth, a.length - depth);
+        const std::string_view y(base + b.offset + depth, b.length - depth);
+        return x < y;
+    }
+
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t depth;
+    };
+
+    template<typename Observer>
+    void insertionSort(const char* base, std::span<StringRef> strings, const Range& range, Observer& observer) {
+        for (std::size_t i = range.begin + 1; i < range.end; ++i) {
+            for (std::size_t j = i; j > range.begin && lessFrom(base, strings[j], strings[j - 1], range.depth); --j) {
+                std::swap(strings[j], strings[j - 1]);
+                observer.swapped(j - 1, j);
+            }
+        }
+    }
+
+    /**
+     * @brief Bentley and Sedgewick's multikey quicksort of a range whose strings agree on their first depth bytes.
+     *
+     * Partitions three ways by the byte at depth around the median of three; the strings equal in it move on to the
+     * next byte, the others stay at this one. Ranges wait on an explicit stack, so shared prefixes of any length
+     * cost no recursion.
+     */
+    template<typename Observer>
+    void multikeySort(const char* base, std::span<StringRef> strings, const Range& whole, Observer& observer) {
+        auto exchange = [&](std::size_t a, std::size_t b) {
+            if (a == b) return;
+            std::swap(strings[a], strings[b]);
+            observer.swapped(a, b);
+        };
+        std::vector<Range> pending{whole};
+        while (!pending.empty()) {
+            Range range = pending.back();
+            pending.pop_back();
+            while (range.end - range.begin > 1) {
+                if (range.end - range.begin <= INSERTION_CUTOFF) {
+                    insertionSort(base, strings, range, observer);
+                    break;
+                }
+                const unsigned first = symbolAt(base, strings[range.begin], range.depth);
+                const unsigned middle = symbolAt(base, strings[range.begin + (range.end - range.begin) / 2], range.depth);
+                const unsigned last = symbolAt(base, strings[range.end - 1], range.depth);
+                const unsigned pivot = std::max(std::min(first, middle), std::min(std::max(first, middle), last));
+                std::size_t less = range.begin;
+                std::size_t i = range.begin;
+                std::size_t greater = range.end;
+                while (i < greater) {
+                    const unsigned symbol = symbolAt(base, strings[i], range.depth);
+                    if (symbol < pivot) {
+                        exchange(less++, i++);
+                    } else if (symbol > pivot) {
+                        exchange(i, --greater);
+                    } else {
+                        ++i;
+                    }
+                }
+                if (less - range.begin > 1) pending.push_back({range.begin, less, range.depth});
+                if (range.end - greater > 1) pending.push_back({greater, range.end, range.depth});
+                // Strings that ended at depth are equal.
+                if (pivot == 0) break;
+                range = {less, greater, range.depth + 1};
+            }
+        }
+    }
+
+    /**
+     * @brief A node of burstsort's trie: per symbol either a child node or a bucket of strings that continue with
+     * that symbol, unsorted.
+     */
+    struct BurstNode {
+        std::array<std::unique_ptr<BurstNode>, SYMBOLS> children{};
+        std::array<std::vector<StringRef>, SYMBOLS> buckets{};
+        /**
+         * @brief Per bucket, its size when its strings were last found all equal; it is not looked at again before
+         * it has doubled.
+         */
+        std::array<std::size_t, SYMBOLS> settled{};
+    };
+
+    /**
+     * @brief Whether every string of bucket equals the first, given that they agree on their first depth bytes.
+     */
+    inline bool allEqual(const char* base, const std::vector<StringRef>& bucket, std::size_t depth) {
+        const StringRef& first = bucket.front();
+        const std::string_view rest(base + first.offset + depth, first.length - depth);
+        return std::all_of(bucket.begin(), bucket.end(), [&](const StringRef& string) {
+            return (string.offset == first.offset && string.length == first.length) ||
+                   std::string_view(base + string.offset + depth, string.length - depth) == rest;
+        });
+    }
+
+    /**
+     * @brief Sorts the buckets of the trie in symbol order and writes them to strings, freeing nodes as it goes.
+     *
+     * Nodes wait on an explicit stack with the next symbol to emit, so a trie as deep as its longest string costs
+     * no recursion.
+     */
+    template<typename Observer>
+    void emitBurstTrie(const char* base, std::unique_ptr<BurstNode> root, std::span<StringRef> strings,
+                       Observer& observer) {
+        struct Visit {
+            std::unique_ptr<BurstNode> node;
+            std::size_t depth;
+            std::size_t symbol;
+        };
+        NullStringSortObserver quiet;
+        std::size_t position = 0;
+        std::vector<Visit> path;
+        path.push_back({std::move(root), 0, 0});
+        while (!path.empty()) {
+            Visit& visit = path.back();
+            if (visit.symbol == SYMBOLS) {
+                path.pop_back();
+                continue;
+            }
+            const std::size_t symbol = visit.symbol++;
+            const std::size_t depth = visit.depth;
+            BurstNode& node = *visit.node;
+            std::vector<StringRef>& bucket = node.buckets[symbol];
+            // Strings that ended here are equal; the others share one more byte.
+            if (symbol != 0) multikeySort(base, std::span<StringRef>(bucket), {0, bucket.size(), depth + 1}, quiet);
+            for (const StringRef& string : bucket) {
+                strings[position] = string;
+                observer.wrote(position++, string);
+            }
+            std::vector<StringRef>().swap(bucket);
+            if (node.children[symbol]) path.push_back({std::move(node.children[symbol]), depth + 1, 0});
+        }
+    }
+}
+
+/**
+ * @brief Multikey quicksort of strings by byte value, in place.
+ *
+ * Each byte of a shared prefix is looked at about log n times instead of once per comparison of whole strings, and
+ * no string is compared past the byte where it differs from its neighbours.
+ */
+template<typename Observer = NullStringSortObserver>
+void multikeyQuicksort(const StringArena& arena, std::span<StringRef> strings, Observer&& observer = {}) {
+    string_sort_detail::multikeySort(arena.bytes(), strings, {0, strings.size(), 0}, observer);
+}
+
+/**
+ * @brief Most-significant-byte radix sort of strings by byte value.
+ *
+ * Every range is distributed by its byte at the current depth over 257 buckets, the first for strings that ended,
+ * through a buffer of StringRefs and a cache of that byte for every string, so each string's bytes are read once
+ * per pass. Buckets become the ranges of the next depth; those below 64 strings are left to multikey quicksort.
+ * Needs a buffer of n StringRefs and n two-byte symbols.
+ */
+template<typename Observer = NullStringSortObserver>
+void msdStringSort(const StringArena& arena, std::span<StringRef> strings, Observer&& observer = {}) {
+    using namespace string_sort_detail;
+    const char* base = arena.bytes();
+    std::vector<StringRef> buffer(strings.size());
+    std::vector<std::uint16_t> symbols(strings.size());
+    std::vector<Range> pending{{0, strings.size(), 0}};
+    while (!pending.empty()) {
+        const Range range = pending.back();
+        pending.pop_back();
+        if (range.end - range.begin < RADIX_CUTOFF) {
+            multikeySort(base, strings, range, observer);
+            continue;
+        }
+        std::array<std::size_t, SYMBOLS> counts{};
+        for (std::size_t i = range.begin; i < range.end; ++i) {
+            symbols[i] = static_cast<std::uint16_t>(symbolAt(base, strings[i], range.depth));
+            ++counts[symbols[i]];
+        }
+        std::array<std::size_t, SYMBOLS> next{};
+        std::size_t offset = range.begin;
+        for (std::size_t symbol = 0; symbol < SYMBOLS; ++symbol) {
+            next[symbol] = offset;
+            offset += counts[symbol];
+        }
+        for (std::size_t i = range.begin; i < range.end; ++i) {
+            buffer[next[symbols[i]]++] = strings[i];
+        }
+        for (std::size_t i = range.begin; i < range.end; ++i) {
+            strings[i] = buffer[i];
+            observer.wrote(i, strings[i]);
+        }
+        // Pushed last to first so the stack hands them back in order; strings that ended are done.
+        for (std::size_t symbol = SYMBOLS - 1; symbol > 0; --symbol) {
+            if (counts[symbol] > 1) {
+                pending.push_back({next[symbol] - counts[symbol], next[symbol], range.depth + 1});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sinha and Zobel's burstsort: strings are inserted into a trie of buckets, then the buckets are sorted.
+ *
+ * Insertion follows the trie by the string's bytes until it reaches a bucket and appends the string there. A bucket
+ * that grows past 8192 strings is burst: it becomes a trie node whose buckets split its strings by their next byte.
+ * Strings that end go to a node's bucket 0, which never bursts, and a bucket of copies of one string, which would
+ * only burst into one bucket a level deeper once per byte, is left whole until it has doubled.
+ * Buckets stay small enough to be sorted in cache by multikey quicksort, and the trie, which is small, is what every
+ * insertion walks, instead of the whole array as in a radix pass. Holds a copy of every StringRef in the buckets.
+ */
+template<typename Observer = NullStringSortObserver>
+void burstSort(const StringArena& arena, std::span<StringRef> strings, Observer&& observer = {}) {
+    using namespace string_sort_detail;
+    const char* base = arena.bytes();
+    auto root = std::make_unique<BurstNode>();
+    for (const StringRef& string : strings) {
+        BurstNode* node = root.get();
+        std::size_t depth = 0;
+        unsigned symbol = symbolAt(base, string, depth);
+        while (symbol != 0 && node->children[symbol]) {
+            node = node->children[symbol].get();
+            symbol = symbolAt(base, string, ++depth);
+        }
+        std::vector<StringRef>& bucket = node->buckets[symbol];
+        bucket.push_back(string);
+        if (symbol == 0 || bucket.size() <= std::max(BURST_LIMIT, 2 * node->settled[symbol])) continue;
+        if (allEqual(base, bucket, depth + 1)) {
+            node->settled[symbol] = bucket.size();
+        } else {
+            auto child = std::make_unique<BurstNode>();
+            for (const StringRef& moved : bucket) {
+                child->buckets[symbolAt(base, moved, depth + 1)].push_back(moved);
+            }
+            std::vector<StringRef>().swap(bucket);
+            node->children[symbol] = std::move(child);
+        }
+    }
+    emitBurstTrie(base, std::move(root), strings, observer);
+}
+
+
+#endif //ALGOVISUALIZER_STRINGSORT_H
@@ -0,0 +1,232 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "StringSortView.h"
+#include "Constants.hpp"
+#include "StringSort.h"
+#include <algorithm>
+#include <fmt/core.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+    constexpr std::size_t REPLAY_FRAMES = 600;
+    constexpr std::size_t BUFFER_CAPACITY = std::size_t{1} << 16;
+    constexpr std::size_t PREFIX_BYTES = 16;
+    constexpr int LABEL_FONT_SIZE = 14;
+
+    const char* algorithmName(StringSortView::Algorithm algorithm) {
+        switch (algorithm) {
+            case StringSortView::Algorithm::MultikeyQuicksort: return "multikey quicksort";
+            case StringSortView::Algorithm::MsdRadixSort: return "MSD radix sort";
+            case StringSortView::Algorithm::BurstSort: return "burstsort";
+            default: return "";
+        }
+    }
+
+    /**
+     * @brief Turns what a string sort reports into SortOps whose values are prefix ranks.
+     */
+    class RankTracer {
+    public:
+        RankTracer(const std::vector<StringRef>& original, const std::vector<int>& ranks, SortOpSink& sink) :
+            original_(original), ranks_(ranks), sink_(sink) {}
+
+        void swapped(std::size_t a, std::size_t b) { sink_.push(SortOp::swap(a, b)); }
+        void wrote(std::size_t position, const StringRef& string) {
+            // Arena order is offset order, so the string's index in it is found by its offset.
+            const auto it = std::lower_bound(original_.begin(), original_.end(), string.offset,
+                                             [](const StringRef& s, std::uint64_t offset) { return s.offset < offset; });
+            sink_.push(SortOp::write(position, ranks_[static_cast<std::size_t>(it - original_.begin())]));
+        }
+
+    private:
+        const std::vector<StringRef>& original_;
+        const std::vector<int>& ranks_;
+        SortOpSink& sink_;
+    };
+
+    void runTraced(StringSortView::Algorithm algorithm, const StringArena& arena, const std::vector<int>& ranks,
+                   SortOpBuffer& buffer) {
+        std::vector<StringRef> strings = arena.strings();
+        try {
+            RankTracer tracer(arena.strings(), ranks, buffer);
+            switch (algorithm) {
+                case StringSortView::Algorithm::MultikeyQuicksort:
+                    multikeyQuicksort(arena, strings, tracer);
+                    break;
+                case StringSortView::Algorithm::MsdRadixSort:
+                    msdStringSort(arena, strings, tracer);
+                    break;
+                case StringSortView::Algorithm::BurstSort:
+                default:
+                    burstSort(arena, strings, tracer);
+                    break;
+            }
+            buffer.push(SortOp::sorted(0, strings.size()));
+        } catch (const SortTraceCancelled&) {
+            // The view restarted or closed; the half-sorted strings are simply dropped.
+        }
+        buffer.finish();
+    }
+}
+
+StringSortView::StringSortView(const std::string& stringFile, std::size_t stringCount, std::uint64_t initialSeed) :
+    algorithm(Algorithm::MultikeyQuicksort),
+    path(stringFile),
+    count(stringCount),
+    seed(initialSeed),
+    arena(),
+    ranks(),
+    distinctPrefixes(1),
+    data(),
+    buffer(),
+    worker(),
+    frameOps(),
+    opsPerFrame(1),
+    bars(),
+    font(TTF_OpenFont(Constants::FONT_PATH, LABEL_FONT_SIZE)),
+    screenWidth(0) {
+    bars.setColors(SDL_Color{70, 130, 180, 255},   // Steel blue while sorting
+                   SDL_Color{0, 255, 0, 255},      // Green once sorted
+                   SDL_Color{255, 255, 255, 255}); // White for strings moved this frame
+    if (!path.empty()) {
+        try {
+            arena = std::make_unique<StringArena>(StringArena::mapFile(path));
+        } catch (const std::exception& e) {
+            std::cerr << "Sorting generated words instead: " << e.what() << '\n';
+            path.clear();
+        }
+    }
+    start(algorithm);
+}
+
+StringSortView::~StringSortView() {
+    stop();
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+void StringSortView::stop() {
+    if (buffer) {
+        buffer->cancel();
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void StringSortView::start(Algorithm newAlgorithm) {
+    stop();
+    algorithm = newAlgorithm;
+    // The worker sorts a copy of the StringRefs, so a mapped file's arena is still in line order for the next run.
+    if (path.empty()) arena = std::make_unique<StringArena>(StringArena::generate(count, seed));
+    const std::vector<StringRef>& strings = arena->strings();
+    std::vector<std::string_view> prefixes;
+    prefixes.reserve(strings.size());
+    for (const StringRef& string : strings) prefixes.push_back(arena->view(string).substr(0, PREFIX_BYTES));
+    std::vector<std::string_view> distinct = prefixes;
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    ranks.clear();
+    for (const std::string_view prefix : prefixes) {
+        ranks.push_back(static_cast<int>(std::lower_bound(distinct.begin(), distinct.end(), prefix) - distinct.begin()) + 1);
+    }
+    distinctPrefixes = std::max<int>(1, static_cast<int>(distinct.size()));
+    data = ranks;
+    bars.setMaxValue(distinctPrefixes);
+
+    std::size_t levels = 1;
+    while (std::size_t{1} << levels < data.size()) ++levels;
+    opsPerFrame = std::max<std::size_t>(1, data.size() * levels / REPLAY_FRAMES);
+    buffer = std::make_unique<SortOpBuffer>(BUFFER_CAPACITY);
+    worker = std::jthread(runTraced, algorithm, std::cref(*arena), std::cref(ranks), std::ref(*buffer));
+    bars.setSortedRange(0, 0);
+    bars.invalidate();
+}
+
+void StringSortView::update() {
+    frameOps.resize(opsPerFrame);
+    const std::size_t popped = buffer->pop(frameOps.data(), frameOps.size());
+    for (std::size_t k = 0; k < popped; ++k) {
+        const SortOp& op = frameOps[k];
+        switch (op.kind) {
+            case SortOp::Kind::Swap:
+                std::swap(data[op.i], data[op.j]);
+                bars.touch(op.i);
+                bars.touch(op.j);
+                break;
+            case SortOp::Kind::Write:
+                data[op.i] = op.value;
+                bars.touch(op.i);
+                break;
+            case SortOp::Kind::Sorted:
+                bars.setSortedRange(op.i, op.j);
+                break;
+            case SortOp::Kind::Compare:
+            case SortOp::Kind::Run:
+            case SortOp::Kind::Fallback:
+            case SortOp::Kind::Window:
+            default:
+                break;
+        }
+    }
+}
+
+void StringSortView::render(SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    bars.render(renderer, data);
+    drawLabel(renderer);
+    SDL_RenderPresent(renderer);
+}
+
+void StringSortView::drawLabel(SDL_Renderer* renderer) const {
+    if (!font) return;
+    const std::string text = fmt::format("{}  {} {}  {} distinct {}-byte prefixes", algorithmName(algorithm),
+                                         data.size(), path.empty() ? "strings" : "lines of " + path, distinctPrefixes,
+                                         PREFIX_BYTES);
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), SDL_Color{255, 255, 255, 255});
+    if (!surface) return;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    // Right-aligned, clear of the FPS counter and perf overlay in the top left.
+    const SDL_Rect rect = {screenWidth - surface->w - 6, 6, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
+}
+
+void StringSortView::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_q:
+            start(Algorithm::MultikeyQuicksort);
+            break;
+        case SDLK_m:
+            start(Algorithm::MsdRadixSort);
+            break;
+        case SDLK_b:
+            start(Algorithm::BurstSort);
+            break;
+        case SDLK_r:
+            ++seed;
+            start(algorithm);
+            break;
+        case SDLK_UP:
+            opsPerFrame = std::min<std::size_t>(opsPerFrame * 2, BUFFER_CAPACITY);
+            break;
+        case SDLK_DOWN:
+            opsPerFrame = std::max<std::size_t>(opsPerFrame / 2, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void StringSortView::setScreenDimensions(int width, int height) {
+    screenWidth = width;
+    bars.setScreenDimensions(width, height);
+}
@@ -0,0 +1,80 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_STRINGSORTVIEW_H
+#define ALGOVISUALIZER_STRINGSORTVIEW_H
+#include "BarRenderer.h"
+#include "IRenderable.hpp"
+#include "SortInstrumentation.h"
+#include "StringArena.h"
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Plays back a string sort, run on a worker thread over a StringArena of a mapped file's lines or of
+ * generated words, as bars.
+ *
+ * A string is drawn as the rank of its first 16 bytes among all distinct such prefixes, so the bars rise evenly
+ * once sorted however the words are spread over the alphabet. Multikey quicksort shows up as swaps partitioning
+ * ever smaller ranges, MSD radix sort and burstsort as ranges rewritten at once. Keys: q multikey quicksort, m MSD
+ * radix sort, b burstsort; r restarts, on new words unless the strings come from a file, and up/down double or halve
+ * the speed.
+ */
+class StringSortView : public IRenderable {
+public:
+    enum class Algorithm { MultikeyQuicksort, MsdRadixSort, BurstSort };
+
+    /**
+     * @brief Sorts the lines of stringFile, mapped through StringArena::mapFile. Without a file, or if it cannot be
+     * loaded, sorts stringCount generated words of initialSeed instead.
+     */
+    StringSortView(const std::string& stringFile, std::size_t stringCount, std::uint64_t initialSeed);
+    StringSortView(const StringSortView&) = delete;
+    StringSortView& operator=(const StringSortView&) = delete;
+    ~StringSortView() override;
+    void update() override;
+    void render(SDL_Renderer* renderer) override;
+    void handleEvent(const SDL_Event& event) override;
+    void setScreenDimensions(int width, int height);
+    /**
+     * @brief Cancels the running sort and starts algorithm on the file's lines, or on the words of the current seed.
+     */
+    void start(Algorithm algorithm);
+
+private:
+    void stop();
+    void drawLabel(SDL_Renderer* renderer) const;
+
+    Algorithm algorithm;
+    /**
+     * @brief The file whose lines are sorted, mapped once; empty when sorting generated words.
+     */
+    std::string path;
+    std::size_t count;
+    std::uint64_t seed;
+    std::unique_ptr<StringArena> arena;
+    /**
+     * @brief Prefix rank of every string of the arena, in arena order.
+     */
+    std::vector<int> ranks;
+    int distinctPrefixes;
+    std::vector<int> data;
+    std::unique_ptr<SortOpBuffer> buffer;
+    /**
+     * @brief Declared after the arena and buffer, so it is joined before what it reads and pushes into is freed.
+     */
+    std::jthread worker;
+    std::vector<SortOp> frameOps;
+    std::size_t opsPerFrame;
+    BarRenderer bars;
+    TTF_Font* font;
+    int screenWidth;
+};
+
+
+#endif //ALGOVISUALIZER_STRINGSORTVIEW_H
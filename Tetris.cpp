@@ -3,16 +3,28 @@
 //
 #include "Tetris.h"
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
 
+namespace {
+    constexpr std::array<SDL_Color, 7> PIECE_COLORS = {{
+        {0, 240, 240, 255}, {240, 240, 0, 255}, {160, 0, 240, 255}, {0, 240, 0, 255},
+        {240, 0, 0, 255}, {0, 0, 240, 255}, {240, 160, 0, 255}
+    }};
+}
+
 Tetris::Tetris() :
-    grid(gridHeight, std::vector<int>(gridWidth, 0)),
+    board(),
     gameOver(false),
     score(0),
     currentPiece(0),
     screenHeight(0),
     screenWidth(0),
-    lastDropTime(SDL_GetTicks()){
+    lastDropTime(SDL_GetTicks()),
+    upcoming(),
+    autoplay(false),
+    ai(nullptr){
     startNewGame();
 }
 void Tetris::update(){
@@ -20,6 +32,13 @@ void Tetris::update(){
         return;
     }
     Uint32 currentTime = SDL_GetTicks();
+    if (autoplay) {
+        if (currentTime - lastDropTime >= AUTOPLAY_DELAY) {
+            playBestPlacement();
+            lastDropTime = currentTime;
+        }
+        return;
+    }
     if (currentTime - lastDropTime >= 1000) {
         dropPiece();
         lastDropTime = currentTime;
@@ -35,8 +54,9 @@ void Tetris::render(SDL_Renderer* renderer) {
     for (int y = 0; y < gridHeight; y++) {
         for (int x = 0; x < gridWidth; x++) {
             SDL_Rect rect = {x * cellSize, y * cellSize, cellSize, cellSize};
-            if (grid[static_cast<size_t>(y)][static_cast<size_t>(x)] != 0) {
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            if (board.occupied(x, y)) {
+                const SDL_Color& color = PIECE_COLORS[static_cast<size_t>(board.color(x, y) - 1)];
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
             } else {
                 SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
             }
@@ -60,70 +80,35 @@ void Tetris::startNewGame() {
     gameOver = false;
     score = 0;
 
-    for(auto& row : grid){
-        std::fill(row.begin(), row.end(), 0);
+    board.reset();
+    upcoming.clear();
+    for (std::size_t i = 0; i < PREVIEW; ++i) {
+        upcoming.push_back(rand() % piece_tables::TYPES);
     }
     generateNewPiece();
 }
 void Tetris::movePieceLeft() {
-    bool canMoveLeft = true;
-    for(const auto& block : currentPiece.getBlocks()){
-        int newX = block.getX() - 1;
-        if(newX < 0 || grid[static_cast<unsigned long>(block.getY())][static_cast<unsigned long>(newX)] != 0){
-            canMoveLeft = false;
-            break;
-        }
-    }
-    if(canMoveLeft){
-        for(auto& block : currentPiece.getBlocks()){
-            block.setX(block.getX() - 1);
-        }
+    if(board.fits(currentPiece.getRows(), currentPiece.getX() - 1, currentPiece.getY())){
+        currentPiece.moveLeft();
     }
 }
 void Tetris::movePieceRight() {
-    bool canMoveRight = true;
-    for(const auto& block : currentPiece.getBlocks()){
-        int newX = block.getX() + 1;
-        if(newX >= gridWidth || grid[static_cast<unsigned long>(block.getY())][static_cast<unsigned long>(newX)] != 0){
-            canMoveRight = false;
-            break;
-        }
-    }
-    if(canMoveRight){
-        for(auto& block: currentPiece.getBlocks()){
-            block.setX(block.getX() + 1);
-        }
+    if(board.fits(currentPiece.getRows(), currentPiece.getX() + 1, currentPiece.getY())){
+        currentPiece.moveRight();
     }
 }
-void Tetris::rotatePiece() {
-    auto& pivot = currentPiece.getBlocks()[0];
-    bool canRotate = true;
-
-    std::vector<Block> rotatedPositions;
-    for(const auto& block : currentPiece.getBlocks()){
-        int rotatedX = pivot.getX() - (block.getY() - pivot.getY());
-        int rotatedY = pivot.getY() - (block.getX() - pivot.getX());
-
-        if(rotatedX < 0 || rotatedX >= gridWidth || rotatedY < 0 || rotatedY >= gridHeight || grid[static_cast<unsigned long>(rotatedY)][static_cast<unsigned long>(rotatedX)] != 0){
-            canRotate = false;
-            break;
+void Tetris::rotatePiece(bool clockwise) {
+    const Piece rotated = currentPiece.rotated(clockwise);
+    for(const auto& kick : currentPiece.kicks(clockwise)){
+        if(board.fits(rotated.getRows(), rotated.getX() + kick.x, rotated.getY() + kick.y)){
+            currentPiece = Piece(rotated.getType(), rotated.getRotation(), rotated.getX() + kick.x,
+                                 rotated.getY() + kick.y);
+            return;
         }
-        int pivotType = currentPiece.getType();
-        rotatedPositions.push_back(Block(rotatedX, rotatedY, pivotType));
-    }
-    if(canRotate){
-        currentPiece.setBlocks(rotatedPositions);
     }
 }
 void Tetris::dropPiece() {
-    bool canDrop = true;
-    for (const auto& block : currentPiece.getBlocks()) {
-        if (block.getY() + 1 >= gridHeight || grid[static_cast<unsigned long>(block.getY() + 1)][static_cast<unsigned long>(block.getX())] != 0) {
-            canDrop = false;
-            break;
-        }
-    }
-    if (canDrop) {
+    if (board.fits(currentPiece.getRows(), currentPiece.getX(), currentPiece.getY() + 1)) {
         currentPiece.dropBlocks();
     }
     else {
@@ -133,38 +118,14 @@ void Tetris::dropPiece() {
 }
 
 bool Tetris::isGameOver() const {
-    for (const auto& block : currentPiece.getBlocks()) {
-        if (grid[static_cast<unsigned long>(block.getY())][static_cast<unsigned long>(block.getX())] != 0) {
-            return true;
-        }
-    }
-    return false;
+    return !board.fits(currentPiece.getRows(), currentPiece.getX(), currentPiece.getY());
 }
 
 int Tetris::getScore() const {
     return score;
 }
 void Tetris::checkLineClear() {
-    int linesCleared = 0;
-    for (int y = 0; y < gridHeight; y++) {
-        bool lineFull = true;
-        for (int x = 0; x < gridWidth; x++) {
-            if (grid[static_cast<size_t>(y)][static_cast<size_t>(x)] == 0) {
-                lineFull = false;
-                break;
-            }
-        }
-
-        if (lineFull) {
-            linesCleared++;
-            for (int row = y; row > 0; row--) {
-                grid[static_cast<size_t>(row)] = grid[static_cast<size_t>(row - 1)];
-            }
-            grid[0] = std::vector<int>(gridWidth, 0);
-        }
-    }
-
-    score += linesCleared * 100;
+    score += board.clearLines() * 100;
 }
 
 void Tetris::generateNewPiece() {
@@ -175,40 +136,37 @@ void Tetris::generateNewPiece() {
 }
 
 void Tetris::placePiece() {
-    for (const auto& block : currentPiece.getBlocks()) {
-        grid[static_cast<size_t>(block.getY())][static_cast<size_t>(block.getX())] = currentPiece.getType();
-    }
+    // Colors start at 1, since 0 marks an empty cell.
+    board.place(currentPiece.getRows(), currentPiece.getX(), currentPiece.getY(),
+                static_cast<std::uint8_t>(currentPiece.getType() + 1));
     checkLineClear();
 }
 Piece Tetris::getRandomPiece(){
-    int type = rand() % 7;
-    std::vector<Block> blocks;
-    switch (type) {
-        case 0:
-            blocks = {Block(3, 0, type), Block(4, 0, type), Block(5, 0, type), Block(6, 0, type)};
-            break;
-        case 1:
-            blocks = {Block(4, 0, type), Block(5, 0, type), Block(4, 1, type), Block(5, 1, type)};
-            break;
-        case 2:
-            blocks = {Block(3, 0, type), Block(4, 0, type), Block(5, 0, type), Block(4, 1, type)};
-            break;
-        case 3:
-            blocks = {Block(4, 0, type), Block(5, 0, type), Block(3, 1, type), Block(4, 1, type)};
-            break;
-        case 4:
-            blocks = {Block(3, 0, type), Block(4, 0, type), Block(4, 1, type), Block(5, 1, type)};
-            break;
-        case 5:
-            blocks = {Block(3, 0, type), Block(3, 1, type), Block(4, 1, type), Block(5, 1, type)};
-            break;
-        case 6:
-            blocks = {Block(5, 0, type), Block(3, 1, type), Block(4, 1, type), Block(5, 1, type)};
-            break;
-        default:
-            break;
+    const int type = upcoming.front();
+    upcoming.pop_front();
+    upcoming.push_back(rand() % piece_tables::TYPES);
+    return Piece(type);
+}
+
+void Tetris::toggleAutoplay() {
+    autoplay = !autoplay;
+    if (autoplay && !ai) {
+        ai = std::make_unique<TetrisAI>();
     }
-    return Piece(blocks, type);
+}
+
+void Tetris::playBestPlacement() {
+    std::array<int, PREVIEW + 1> pieces{};
+    pieces[0] = currentPiece.getType();
+    std::copy(upcoming.begin(), upcoming.end(), pieces.begin() + 1);
+    const std::optional<TetrisPlacement> placement = ai->plan(board.rowMasks(), pieces);
+    if (!placement) {
+        gameOver = true;
+        return;
+    }
+    currentPiece = Piece(currentPiece.getType(), placement->rotation, placement->x, placement->y);
+    placePiece();
+    generateNewPiece();
 }
 
 void Tetris::setScreenDimensions(int width, int height) {
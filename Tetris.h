@@ -6,9 +6,13 @@
 #define ALGOVISUALIZER_TETRIS_H
 #include "IRenderable.hpp"
 #include "Piece.h"
+#include "TetrisAI.h"
+#include "TetrisBoard.h"
 #include <vector>
 #include <SDL2/SDL.h>
 #include <chrono>
+#include <deque>
+#include <memory>
 
 class Tetris : public IRenderable{
 public:
@@ -20,29 +24,43 @@ public:
     void startNewGame();
     void movePieceLeft();
     void movePieceRight();
-    void rotatePiece();
+    void rotatePiece(bool clockwise = true);
     void dropPiece();
     bool isGameOver() const;
     int getScore() const;
     void setScreenDimensions(int width, int height);
+    /**
+     * @brief Switches between playing from the keyboard and letting a TetrisAI place every piece, looking ahead
+     * through the preview.
+     */
+    void toggleAutoplay();
 
 private:
     const int NUM_PIECES_TYPES = 7;
-    static const int gridWidth = 10;
-    static const int gridHeight = 20;
+    static const int gridWidth = TetrisBoard::WIDTH;
+    static const int gridHeight = TetrisBoard::HEIGHT;
     const int cellSize = 30;
+    static const std::size_t PREVIEW = 2;
+    static const Uint32 AUTOPLAY_DELAY = 100;
 
-    std::vector<std::vector<int>> grid;
+    TetrisBoard board;
     bool gameOver;
-    bool score;
+    int score;
     void checkLineClear();
     void generateNewPiece();
     void placePiece();
     Piece currentPiece;
     Piece getRandomPiece();
+    void playBestPlacement();
     int screenHeight;
     int screenWidth;
     Uint32 lastDropTime;
+    /**
+     * @brief Types of the pieces after the current one.
+     */
+    std::deque<int> upcoming;
+    bool autoplay;
+    std::unique_ptr<TetrisAI> ai;
 };
 
 
@@ -0,0 +1,235 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "TetrisAI.h"
+#include "Piece.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+
+namespace {
+    // Box positions a piece can take: its box may hang up to three columns past the left wall and two rows above
+    // the well, as long as the cells hanging out are empty. Position x is bit x - X_MIN of a row of positions.
+    constexpr int X_MIN = -3;
+    constexpr int X_SPAN = TetrisBoard::WIDTH - X_MIN;
+    constexpr int Y_MIN = -2;
+    constexpr int Y_SPAN = TetrisBoard::HEIGHT - Y_MIN;
+    constexpr std::uint32_t ALL_POSITIONS = (1u << X_SPAN) - 1;
+
+    using PositionRows = std::array<std::uint32_t, Y_SPAN + 1>;
+
+    std::uint32_t shifted(std::uint32_t positions, int dx) {
+        return (dx >= 0 ? positions << dx : positions >> -dx) & ALL_POSITIONS;
+    }
+
+    /**
+     * @brief Rows Y_MIN to HEIGHT + 2 of the well widened by the walls, column c at bit c - X_MIN; rows outside the
+     * well are solid.
+     */
+    using WalledRows = std::array<std::uint32_t, Y_SPAN + piece_tables::CELLS>;
+
+    WalledRows walledRows(const TetrisBoard::Rows& well) {
+        constexpr std::uint32_t WALLS = ((1u << -X_MIN) - 1) | (~0u << (TetrisBoard::WIDTH - X_MIN));
+        WalledRows walled;
+        walled.fill(~0u);
+        for (std::size_t y = 0; y < TetrisBoard::HEIGHT; ++y) {
+            walled[y + static_cast<std::size_t>(-Y_MIN)] = (std::uint32_t{well[y]} << -X_MIN) | WALLS;
+        }
+        return walled;
+    }
+
+    /**
+     * @brief For every row y from Y_MIN to HEIGHT, the positions at which the piece of type turned to rotation
+     * overlaps the stack or leaves the well.
+     */
+    PositionRows collisions(const WalledRows& walled, int type, int rotation) {
+        PositionRows blocked{};
+        const auto& cells = piece_tables::CELL_TABLE[static_cast<std::size_t>(type)][static_cast<std::size_t>(rotation)];
+        for (std::size_t row = 0; row < blocked.size(); ++row) {
+            std::uint32_t positions = 0;
+            for (const PieceOffset& cell : cells) {
+                positions |= walled[row + static_cast<std::size_t>(cell.y)] >> cell.x;
+            }
+            blocked[row] = positions & ALL_POSITIONS;
+        }
+        return blocked;
+    }
+
+    /**
+     * @brief The cells a resting piece settles, packed from its top row down, ten bits a row, above the row number.
+     */
+    std::uint64_t settledCells(const Piece& piece) {
+        const auto& rows = piece.getRows();
+        std::size_t top = 0;
+        while (rows[top] == 0) ++top;
+        std::uint64_t key = static_cast<std::uint64_t>(piece.getY() + static_cast<int>(top) - Y_MIN) << 40;
+        for (std::size_t r = top; r < rows.size(); ++r) {
+            const std::uint64_t row = piece.getX() >= 0 ? std::uint64_t{rows[r]} << piece.getX()
+                                                        : std::uint64_t{rows[r]} >> -piece.getX();
+            key |= row << (TetrisBoard::WIDTH * (r - top));
+        }
+        return key;
+    }
+}
+
+void enumeratePlacements(const TetrisBoard::Rows& well, int type, std::vector<TetrisPlacement>& placements) {
+    const Piece spawn(type);
+    if (!TetrisBoard::fits(well, spawn.getRows(), spawn.getX(), spawn.getY())) return;
+    const WalledRows walled = walledRows(well);
+    std::array<PositionRows, piece_tables::ROTATIONS> blocked;
+    for (int rotation = 0; rotation < piece_tables::ROTATIONS; ++rotation) {
+        blocked[static_cast<std::size_t>(rotation)] = collisions(walled, type, rotation);
+    }
+
+    struct Turn {
+        int to;
+        std::span<const PieceOffset> kicks;
+    };
+    std::array<std::array<Turn, 2>, piece_tables::ROTATIONS> turns{};
+    for (int rotation = 0; rotation < piece_tables::ROTATIONS; ++rotation) {
+        const Piece from(type, rotation, 0, 0);
+        turns[static_cast<std::size_t>(rotation)] = {{{from.rotated(true).getRotation(), from.kicks(true)},
+                                                      {from.rotated(false).getRotation(), from.kicks(false)}}};
+    }
+
+    // Flood fill of the reachable positions, a row of them at a time: drops, shifts and kicked turns are applied
+    // to whole rows of positions until nothing new is reached.
+    std::array<PositionRows, piece_tables::ROTATIONS> reached{};
+    reached[0][static_cast<std::size_t>(spawn.getY() - Y_MIN)] = 1u << (spawn.getX() - X_MIN);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (std::size_t rotation = 0; rotation < piece_tables::ROTATIONS; ++rotation) {
+            PositionRows& positions = reached[rotation];
+            const PositionRows& solid = blocked[rotation];
+            for (std::size_t row = 0; row < Y_SPAN; ++row) {
+                std::uint32_t current = positions[row];
+                if (row > 0) current |= positions[row - 1] & ~solid[row];
+                if (current == 0) continue;
+                for (std::uint32_t previous = 0; previous != current;) {
+                    previous = current;
+                    current |= ((current << 1) | (current >> 1)) & ~solid[row] & ALL_POSITIONS;
+                }
+                changed = changed || current != positions[row];
+                positions[row] = current;
+
+                for (const Turn& turn : turns[rotation]) {
+                    const auto to = static_cast<std::size_t>(turn.to);
+                    // A turn takes the first kick that fits and no other.
+                    std::uint32_t unkicked = current;
+                    for (const PieceOffset& kick : turn.kicks) {
+                        const int target = static_cast<int>(row) + kick.y;
+                        if (unkicked == 0) break;
+                        if (target < 0 || target >= Y_SPAN) continue;
+                        const auto targetRow = static_cast<std::size_t>(target);
+                        const std::uint32_t fitting = shifted(unkicked, kick.x) & ~blocked[to][targetRow];
+                        unkicked &= ~shifted(fitting, -kick.x);
+                        if ((fitting & ~reached[to][targetRow]) != 0) {
+                            reached[to][targetRow] |= fitting;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::array<std::uint64_t, piece_tables::ROTATIONS * X_SPAN * Y_SPAN> settled;
+    std::size_t settledCount = 0;
+    for (std::size_t rotation = 0; rotation < piece_tables::ROTATIONS; ++rotation) {
+        for (std::size_t row = 0; row < Y_SPAN; ++row) {
+            for (std::uint32_t resting = reached[rotation][row] & blocked[rotation][row + 1]; resting != 0;
+                 resting &= resting - 1) {
+                const Piece piece(type, static_cast<int>(rotation), std::countr_zero(resting) + X_MIN,
+                                  static_cast<int>(row) + Y_MIN);
+                const std::uint64_t cells = settledCells(piece);
+                const auto end = settled.begin() + static_cast<std::ptrdiff_t>(settledCount);
+                if (std::find(settled.begin(), end, cells) == end) {
+                    settled[settledCount++] = cells;
+                    placements.push_back({piece.getRotation(), piece.getX(), piece.getY()});
+                }
+            }
+        }
+    }
+}
+
+double evaluateWell(const TetrisBoard::Rows& well, int lines, const TetrisWeights& weights) {
+    std::array<int, TetrisBoard::WIDTH> heights{};
+    std::uint32_t covered = 0;
+    int holes = 0;
+    int top = 0;
+    while (top < TetrisBoard::HEIGHT && well[static_cast<std::size_t>(top)] == 0) ++top;
+    for (int y = top; y < TetrisBoard::HEIGHT; ++y) {
+        const std::uint32_t row = well[static_cast<std::size_t>(y)];
+        for (std::uint32_t tops = row & ~covered; tops != 0; tops &= tops - 1) {
+            heights[static_cast<std::size_t>(std::countr_zero(tops))] = TetrisBoard::HEIGHT - y;
+        }
+        holes += std::popcount(covered & ~row);
+        covered |= row;
+    }
+    int aggregateHeight = 0;
+    int bumpiness = 0;
+    for (std::size_t x = 0; x < heights.size(); ++x) {
+        aggregateHeight += heights[x];
+        if (x > 0) bumpiness += std::abs(heights[x] - heights[x - 1]);
+    }
+    return weights.aggregateHeight * aggregateHeight + weights.completeLines * lines + weights.holes * holes +
+           weights.bumpiness * bumpiness;
+}
+
+TetrisAI::TetrisAI(TetrisAIConfig aiConfig) :
+    config_(aiConfig),
+    pool_(aiConfig.threads),
+    beam_(),
+    next_(),
+    children_(),
+    evaluated_(0) {
+}
+
+void TetrisAI::expand(const Node& node, int type, bool first, std::vector<Node>& children) const {
+    thread_local std::vector<TetrisPlacement> placements;
+    placements.clear();
+    enumeratePlacements(node.well, type, placements);
+    const auto& rotations = piece_tables::ROW_TABLE[static_cast<std::size_t>(type)];
+    for (const TetrisPlacement& placement : placements) {
+        Node child{node.well, first ? placement : node.first, node.lines, 0.0};
+        TetrisBoard::place(child.well, rotations[static_cast<std::size_t>(placement.rotation)], placement.x, placement.y);
+        child.lines += TetrisBoard::clearLines(child.well);
+        child.score = evaluateWell(child.well, child.lines, config_.weights);
+        children.push_back(child);
+    }
+}
+
+std::optional<TetrisPlacement> TetrisAI::plan(const TetrisBoard::Rows& well, std::span<const int> pieces) {
+    evaluated_ = 0;
+    if (pieces.empty()) return std::nullopt;
+    beam_.assign(1, Node{well, {}, 0, 0.0});
+    for (std::size_t level = 0; level < pieces.size(); ++level) {
+        children_.resize(beam_.size());
+        for (auto& children : children_) children.clear();
+        pool_.run([&] {
+            pool_.parallelFor(0, beam_.size(), [&](std::size_t i) {
+                expand(beam_[i], pieces[level], level == 0, children_[i]);
+            });
+        });
+        next_.clear();
+        for (std::size_t i = 0; i < beam_.size(); ++i) {
+            next_.insert(next_.end(), children_[i].begin(), children_[i].end());
+        }
+        evaluated_ += next_.size();
+        if (next_.empty()) {
+            if (level == 0) return std::nullopt;
+            // Every board of this level tops out; the last level that did not decides.
+            break;
+        }
+        const std::size_t width = std::max<std::size_t>(1, config_.beamWidth);
+        if (next_.size() > width) {
+            std::nth_element(next_.begin(), next_.begin() + static_cast<std::ptrdiff_t>(width - 1), next_.end(),
+                             [](const Node& a, const Node& b) { return a.score > b.score; });
+            next_.resize(width);
+        }
+        beam_.swap(next_);
+    }
+    return std::max_element(beam_.begin(), beam_.end(),
+                            [](const Node& a, const Node& b) { return a.score < b.score; })->first;
+}
@@ -0,0 +1,105 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_TETRISAI_H
+#define ALGOVISUALIZER_TETRISAI_H
+#include "TetrisBoard.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Where a piece comes to rest: its rotation and the top left corner of its box, as Piece keeps them.
+ */
+struct TetrisPlacement {
+    int rotation = 0;
+    int x = 0;
+    int y = 0;
+};
+
+/**
+ * @brief Weights of the board features a placement is judged by. The defaults are Yiyuan Lee's tuned weights for
+ * this simplified form of Dellacherie's evaluation.
+ */
+struct TetrisWeights {
+    double aggregateHeight = -0.510066;
+    double completeLines = 0.760666;
+    double holes = -0.35663;
+    double bumpiness = -0.184483;
+};
+
+/**
+ * @brief Appends to placements every place a piece of type can come to rest in well, reached from its spawn
+ * position by shifts, soft drops and SRS rotations with their kicks, so tucks and spins under overhangs count.
+ * Placements that settle the same cells are listed once.
+ */
+void enumeratePlacements(const TetrisBoard::Rows& well, int type, std::vector<TetrisPlacement>& placements);
+
+/**
+ * @brief Score of well with lines cleared on the way to it: the weighted sum of its aggregate column height, lines,
+ * holes (empty cells under a filled one) and bumpiness (height differences of neighbouring columns).
+ */
+double evaluateWell(const TetrisBoard::Rows& well, int lines, const TetrisWeights& weights);
+
+struct TetrisAIConfig {
+    /**
+     * @brief Boards kept at each level of the lookahead.
+     */
+    std::size_t beamWidth = 32;
+    /**
+     * @brief Worker threads; 0 uses one per hardware thread.
+     */
+    unsigned threads = 0;
+    TetrisWeights weights{};
+};
+
+/**
+ * @brief Picks where to place a piece by beam search through the pieces that follow it.
+ *
+ * Every placement of the first piece is scored by evaluateWell; the best beamWidth boards are each expanded by every
+ * placement of the next piece, and so on through the known pieces. The answer is the first placement on the way to
+ * the best board of the last level. The boards of a level are expanded in parallel on a WorkStealingPool.
+ */
+class TetrisAI {
+public:
+    explicit TetrisAI(TetrisAIConfig aiConfig = {});
+
+    /**
+     * @brief Best placement of pieces[0] in well, looking ahead through the rest of pieces.
+     * @return Nothing if pieces[0] has nowhere to go.
+     */
+    std::optional<TetrisPlacement> plan(const TetrisBoard::Rows& well, std::span<const int> pieces);
+
+    [[nodiscard]] const TetrisAIConfig& config() const { return config_; }
+    [[nodiscard]] unsigned threads() const { return pool_.size(); }
+    /**
+     * @brief Placements scored by the last plan().
+     */
+    [[nodiscard]] std::uint64_t evaluated() const { return evaluated_; }
+
+private:
+    struct Node {
+        TetrisBoard::Rows well{};
+        TetrisPlacement first{};
+        int lines = 0;
+        double score = 0.0;
+    };
+
+    void expand(const Node& node, int type, bool first, std::vector<Node>& children) const;
+
+    TetrisAIConfig config_;
+    WorkStealingPool pool_;
+    std::vector<Node> beam_;
+    std::vector<Node> next_;
+    /**
+     * @brief Children of every node of the beam, kept between levels and plans for their capacity.
+     */
+    std::vector<std::vector<Node>> children_;
+    std::uint64_t evaluated_;
+};
+
+
+#endif //ALGOVISUALIZER_TETRISAI_H
@@ -0,0 +1,135 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "TetrisBatch.h"
+#include "Piece.h"
+#include <algorithm>
+#include <array>
+#include <fmt/core.h>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Games stepped by one task of the pool.
+     */
+    constexpr std::size_t CHUNK = 1024;
+
+    /**
+     * @brief Topmost and lowest box row, leftmost and rightmost box column holding a cell, per type and rotation.
+     */
+    struct Extent {
+        int top;
+        int bottom;
+        int left;
+        int right;
+    };
+
+    constexpr auto EXTENTS = [] {
+        std::array<std::array<Extent, piece_tables::ROTATIONS>, piece_tables::TYPES> table{};
+        for (std::size_t type = 0; type < piece_tables::TYPES; ++type) {
+            for (std::size_t rotation = 0; rotation < piece_tables::ROTATIONS; ++rotation) {
+                Extent extent{piece_tables::CELLS, 0, piece_tables::CELLS, 0};
+                for (const PieceOffset& cell : piece_tables::CELL_TABLE[type][rotation]) {
+                    extent.top = std::min(extent.top, cell.y);
+                    extent.bottom = std::max(extent.bottom, cell.y);
+                    extent.left = std::min(extent.left, cell.x);
+                    extent.right = std::max(extent.right, cell.x);
+                }
+                table[type][rotation] = extent;
+            }
+        }
+        return table;
+    }();
+
+    std::uint64_t splitMix(std::uint64_t& state) {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+TetrisBatch::TetrisBatch(TetrisBatchConfig batchConfig) :
+    config_(batchConfig),
+    pool_(batchConfig.threads),
+    wells_(batchConfig.games),
+    current_(batchConfig.games),
+    next_(batchConfig.games),
+    lines_(batchConfig.games),
+    pieces_(batchConfig.games),
+    random_(batchConfig.games) {
+    std::uint64_t seeder = config_.seed;
+    for (auto& state : random_) state = splitMix(seeder);
+    reset();
+}
+
+int TetrisBatch::randomPiece(std::size_t game) {
+    // The high 32 bits scaled to [0, TYPES) by a multiply, which is as fair as % 7 on them and cheaper.
+    return static_cast<int>(((splitMix(random_[game]) >> 32) * piece_tables::TYPES) >> 32);
+}
+
+void TetrisBatch::reset() {
+    for (std::size_t game = 0; game < games(); ++game) reset(game);
+}
+
+void TetrisBatch::reset(std::size_t game) {
+    wells_[game] = {};
+    current_[game] = static_cast<std::uint8_t>(randomPiece(game));
+    next_[game] = static_cast<std::uint8_t>(randomPiece(game));
+    lines_[game] = 0;
+    pieces_[game] = 0;
+}
+
+void TetrisBatch::step(std::span<const std::uint8_t> actions, std::span<float> rewards, std::span<std::uint8_t> done) {
+    if (actions.size() != games() || rewards.size() != games() || done.size() != games()) {
+        throw std::invalid_argument(fmt::format("TetrisBatch::step needs one action, reward and done flag for each of "
+                                                "{} games, got {}, {} and {}",
+                                                games(), actions.size(), rewards.size(), done.size()));
+    }
+    auto stepChunk = [&](std::size_t chunk) {
+        const std::size_t end = std::min(games(), (chunk + 1) * CHUNK);
+        for (std::size_t game = chunk * CHUNK; game < end; ++game) {
+            stepGame(game, actions[game], rewards[game], done[game]);
+        }
+    };
+    const std::size_t chunks = (games() + CHUNK - 1) / CHUNK;
+    if (chunks <= 1) {
+        if (chunks == 1) stepChunk(0);
+        return;
+    }
+    pool_.run([&] { pool_.parallelFor(0, chunks, stepChunk); });
+}
+
+void TetrisBatch::stepGame(std::size_t game, std::uint8_t action, float& reward, std::uint8_t& done) {
+    TetrisBoard::Rows& well = wells_[game];
+    const auto type = static_cast<std::size_t>(current_[game]);
+    const auto rotation = static_cast<std::size_t>(action / TetrisBoard::WIDTH % piece_tables::ROTATIONS);
+    const Extent& extent = EXTENTS[type][rotation];
+    const auto& rows = piece_tables::ROW_TABLE[type][rotation];
+    const int column = std::min(action % TetrisBoard::WIDTH, TetrisBoard::WIDTH - 1 - (extent.right - extent.left));
+    const int x = column - extent.left;
+
+    // Enters with its top cell in the top row, then falls straight through the empty rows above the stack.
+    int surface = 0;
+    while (surface < TetrisBoard::HEIGHT && well[static_cast<std::size_t>(surface)] == 0) ++surface;
+    int y = -extent.top;
+    if (!TetrisBoard::fits(well, rows, x, y)) {
+        reward = 0.0f;
+        done = 1;
+        reset(game);
+        return;
+    }
+    y = std::max(y, surface - 1 - extent.bottom);
+    while (TetrisBoard::fits(well, rows, x, y + 1)) ++y;
+    TetrisBoard::place(well, rows, x, y);
+    const int cleared = TetrisBoard::clearLines(well);
+    lines_[game] += static_cast<std::uint32_t>(cleared);
+    ++pieces_[game];
+    reward = static_cast<float>(cleared);
+
+    current_[game] = next_[game];
+    next_[game] = static_cast<std::uint8_t>(randomPiece(game));
+    const Piece spawned(current_[game]);
+    done = !TetrisBoard::fits(well, spawned.getRows(), spawned.getX(), spawned.getY());
+    if (done) reset(game);
+}
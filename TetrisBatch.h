@@ -0,0 +1,89 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_TETRISBATCH_H
+#define ALGOVISUALIZER_TETRISBATCH_H
+#include "TetrisBoard.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct TetrisBatchConfig {
+    std::size_t games = 1024;
+    std::uint64_t seed = 1;
+    /**
+     * @brief Worker threads; 0 uses one per hardware thread.
+     */
+    unsigned threads = 0;
+};
+
+/**
+ * @brief Many independent headless Tetris games stepped together, for training agents.
+ *
+ * The state is kept as a structure of arrays: one array per field (well, current and next piece, lines, pieces,
+ * random state), indexed by game, with every well its 20 row masks back to back. A step places one piece in every
+ * game: the action picks a rotation and the leftmost column of the piece, and the piece is hard dropped there
+ * without checking that it could have been steered into place, as is usual for placement-level agents. A game is
+ * over once its next piece no longer fits at the top, or the action's column is stacked up too high for the piece
+ * to enter; it reports done for that step and starts again. Games are stepped in chunks on a WorkStealingPool.
+ * Nothing here uses SDL, and step() does not allocate: the pool forks without allocating, into task deques it
+ * reserves when it is built.
+ */
+class TetrisBatch {
+public:
+    /**
+     * @brief Actions are rotation * TetrisBoard::WIDTH + column. A column too far right for the piece in that rotation
+     * is moved left until the piece fits between the walls.
+     */
+    static constexpr int ACTIONS = 4 * TetrisBoard::WIDTH;
+
+    explicit TetrisBatch(TetrisBatchConfig batchConfig = {});
+
+    /**
+     * @brief Starts every game again from an empty well, continuing their random piece sequences.
+     */
+    void reset();
+    /**
+     * @brief Starts game again from an empty well.
+     */
+    void reset(std::size_t game);
+    /**
+     * @brief Plays actions[game] in every game.
+     * @param rewards Lines each game cleared.
+     * @param done Set to 1 for games that topped out and were reset, 0 for the others.
+     * @throws std::invalid_argument if a span does not hold one entry per game.
+     */
+    void step(std::span<const std::uint8_t> actions, std::span<float> rewards, std::span<std::uint8_t> done);
+
+    [[nodiscard]] std::size_t games() const { return pieces_.size(); }
+    [[nodiscard]] unsigned threads() const { return pool_.size(); }
+    [[nodiscard]] const TetrisBoard::Rows& well(std::size_t game) const { return wells_[game]; }
+    /**
+     * @brief Type of the piece the next action places, as Piece numbers them.
+     */
+    [[nodiscard]] int piece(std::size_t game) const { return current_[game]; }
+    [[nodiscard]] int nextPiece(std::size_t game) const { return next_[game]; }
+    /**
+     * @brief Lines cleared and pieces placed since game last started.
+     */
+    [[nodiscard]] std::uint32_t lines(std::size_t game) const { return lines_[game]; }
+    [[nodiscard]] std::uint32_t pieces(std::size_t game) const { return pieces_[game]; }
+
+private:
+    int randomPiece(std::size_t game);
+    void stepGame(std::size_t game, std::uint8_t action, float& reward, std::uint8_t& done);
+
+    TetrisBatchConfig config_;
+    WorkStealingPool pool_;
+    std::vector<TetrisBoard::Rows> wells_;
+    std::vector<std::uint8_t> current_;
+    std::vector<std::uint8_t> next_;
+    std::vector<std::uint32_t> lines_;
+    std::vector<std::uint32_t> pieces_;
+    std::vector<std::uint64_t> random_;
+};
+
+
+#endif //ALGOVISUALIZER_TETRISBATCH_H
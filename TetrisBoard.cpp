@@ -0,0 +1,43 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "TetrisBoard.h"
+#include <cstring>
+
+int TetrisBoard::clearLines() {
+    int cleared = 0;
+    // Walks up from the bottom; each full row found shifts everything above it down by one.
+    for (int y = HEIGHT - 1; y >= 0;) {
+        const auto row = static_cast<std::size_t>(y);
+        if (rows[row] != FULL_ROW) {
+            --y;
+            continue;
+        }
+        std::memmove(&rows[1], &rows[0], row * sizeof(rows[0]));
+        std::memmove(&colors[1], &colors[0], row * sizeof(colors[0]));
+        rows[0] = 0;
+        colors[0] = {};
+        ++cleared;
+    }
+    return cleared;
+}
+
+int TetrisBoard::clearLines(Rows& well) {
+    int cleared = 0;
+    for (int y = HEIGHT - 1; y >= 0;) {
+        const auto row = static_cast<std::size_t>(y);
+        if (well[row] != FULL_ROW) {
+            --y;
+            continue;
+        }
+        std::memmove(&well[1], &well[0], row * sizeof(well[0]));
+        well[0] = 0;
+        ++cleared;
+    }
+    return cleared;
+}
+
+void TetrisBoard::reset() {
+    rows = {};
+    colors = {};
+}
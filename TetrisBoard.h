@@ -0,0 +1,113 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_TETRISBOARD_H
+#define ALGOVISUALIZER_TETRISBOARD_H
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief The settled cells of a Tetris well, one 16-bit occupancy mask per row plus a plane of cell colors.
+ *
+ * Bit x of a row is column x, rows count down from the top. A piece is given as the masks of the rows it covers,
+ * with bit b meaning column x + b, so testing whether it fits is one AND per piece row, a full row is one compare
+ * with FULL_ROW and clearing rows moves masks and colors in blocks. Nothing here allocates or depends on SDL.
+ */
+class TetrisBoard {
+public:
+    static constexpr int WIDTH = 10;
+    static constexpr int HEIGHT = 20;
+    static constexpr std::uint16_t FULL_ROW = (1u << WIDTH) - 1;
+
+    /**
+     * @brief The occupancy masks of a well, top row first.
+     */
+    using Rows = std::array<std::uint16_t, HEIGHT>;
+
+    /**
+     * @brief Whether a piece whose rows are pieceRows, placed with its left edge at column x and its top at row y,
+     * stays inside the well and overlaps no cell of well. Empty piece rows may lie outside it.
+     */
+    [[nodiscard]] static bool fits(const Rows& well, std::span<const std::uint16_t> pieceRows, int x, int y) {
+        for (std::size_t r = 0; r < pieceRows.size(); ++r) {
+            const std::uint32_t mask = pieceRows[r];
+            if (mask == 0) continue;
+            const int row = y + static_cast<int>(r);
+            if (row < 0 || row >= HEIGHT) return false;
+            std::uint32_t shifted;
+            if (x >= 0) {
+                shifted = mask << x;
+            } else {
+                // Cells shifted out past the left wall.
+                if ((mask & ((1u << -x) - 1)) != 0) return false;
+                shifted = mask >> -x;
+            }
+            if ((shifted & ~std::uint32_t{FULL_ROW}) != 0 || (shifted & well[static_cast<std::size_t>(row)]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief Sets the cells of a piece that fits(well, pieceRows, x, y).
+     */
+    static void place(Rows& well, std::span<const std::uint16_t> pieceRows, int x, int y) {
+        for (std::size_t r = 0; r < pieceRows.size(); ++r) {
+            if (pieceRows[r] == 0) continue;
+            auto& row = well[static_cast<std::size_t>(y + static_cast<int>(r))];
+            row = static_cast<std::uint16_t>(row | (x >= 0 ? pieceRows[r] << x : pieceRows[r] >> -x));
+        }
+    }
+    /**
+     * @brief Removes every full row of well, moving the rows above it down, with no colors to keep.
+     * @return The number of rows removed.
+     */
+    static int clearLines(Rows& well);
+
+    [[nodiscard]] bool fits(std::span<const std::uint16_t> pieceRows, int x, int y) const {
+        return fits(rows, pieceRows, x, y);
+    }
+    /**
+     * @brief Settles a piece that fits(pieceRows, x, y), coloring its cells with color, which must not be 0.
+     */
+    void place(std::span<const std::uint16_t> pieceRows, int x, int y, std::uint8_t color) {
+        const Rows before = rows;
+        place(rows, pieceRows, x, y);
+        for (std::size_t row = 0; row < HEIGHT; ++row) {
+            for (std::uint32_t added = rows[row] & ~before[row]; added != 0; added &= added - 1) {
+                colors[row][static_cast<std::size_t>(std::countr_zero(added))] = color;
+            }
+        }
+    }
+
+    /**
+     * @brief Removes every full row, moving the rows above it down.
+     * @return The number of rows removed.
+     */
+    int clearLines();
+    /**
+     * @brief Empties the well.
+     */
+    void reset();
+
+    [[nodiscard]] const Rows& rowMasks() const { return rows; }
+    [[nodiscard]] std::uint16_t row(int y) const { return rows[static_cast<std::size_t>(y)]; }
+    [[nodiscard]] bool occupied(int x, int y) const { return (row(y) >> x) & 1u; }
+    /**
+     * @brief Color a cell was settled with, or 0 if it is empty.
+     */
+    [[nodiscard]] std::uint8_t color(int x, int y) const {
+        return colors[static_cast<std::size_t>(y)][static_cast<std::size_t>(x)];
+    }
+
+private:
+    Rows rows{};
+    std::array<std::array<std::uint8_t, WIDTH>, HEIGHT> colors{};
+};
+
+
+#endif //ALGOVISUALIZER_TETRISBOARD_H
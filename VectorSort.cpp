@@ -0,0 +1,199 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "VectorSort.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_SORT_AVX2 1
+#include <immintrin.h>
+#else
+#define VECTOR_SORT_AVX2 0
+#endif
+
+namespace {
+    constexpr std::size_t LANES = 8;
+    constexpr std::size_t BLOCK = LANES * LANES;
+
+    /**
+     * @brief Optimal 19-comparator sorting network for eight inputs, in six parallel layers.
+     */
+    constexpr std::array<std::pair<int, int>, 19> NETWORK8 = {{
+            {0, 1}, {2, 3}, {4, 5}, {6, 7},
+            {0, 2}, {1, 3}, {4, 6}, {5, 7},
+            {1, 2}, {5, 6}, {0, 4}, {3, 7},
+            {1, 5}, {2, 6},
+            {1, 4}, {3, 6},
+            {2, 4}, {3, 5},
+            {3, 4},
+    }};
+
+    void sortBlocksScalar(int* data, std::size_t size) {
+        for (std::size_t block = 0; block < size; block += LANES) {
+            int* v = data + block;
+            for (const auto& [i, j] : NETWORK8) {
+                const int low = std::min(v[i], v[j]);
+                const int high = std::max(v[i], v[j]);
+                v[i] = low;
+                v[j] = high;
+            }
+        }
+    }
+
+    void mergeScalar(const int* a, std::size_t aSize, const int* b, std::size_t bSize, int* out) {
+        const int* aEnd = a + aSize;
+        const int* bEnd = b + bSize;
+        while (a != aEnd && b != bEnd) {
+            // Advance whichever side supplied the element without a data-dependent branch.
+            const bool takeB = *b < *a;
+            *out++ = takeB ? *b : *a;
+            b += takeB;
+            a += !takeB;
+        }
+        out = std::copy(a, aEnd, out);
+        std::copy(b, bEnd, out);
+    }
+
+#if VECTOR_SORT_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+    AVX2_TARGET inline void compareExchange(__m256i& a, __m256i& b) {
+        const __m256i low = _mm256_min_epi32(a, b);
+        b = _mm256_max_epi32(a, b);
+        a = low;
+    }
+
+    AVX2_TARGET inline void transpose8(__m256i* r) {
+        const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+        const __m256i s0 = _mm256_unpacklo_epi64(t0, t2);
+        const __m256i s1 = _mm256_unpackhi_epi64(t0, t2);
+        const __m256i s2 = _mm256_unpacklo_epi64(t1, t3);
+        const __m256i s3 = _mm256_unpackhi_epi64(t1, t3);
+        const __m256i s4 = _mm256_unpacklo_epi64(t4, t6);
+        const __m256i s5 = _mm256_unpackhi_epi64(t4, t6);
+        const __m256i s6 = _mm256_unpacklo_epi64(t5, t7);
+        const __m256i s7 = _mm256_unpackhi_epi64(t5, t7);
+        r[0] = _mm256_permute2x128_si256(s0, s4, 0x20);
+        r[1] = _mm256_permute2x128_si256(s1, s5, 0x20);
+        r[2] = _mm256_permute2x128_si256(s2, s6, 0x20);
+        r[3] = _mm256_permute2x128_si256(s3, s7, 0x20);
+        r[4] = _mm256_permute2x128_si256(s0, s4, 0x31);
+        r[5] = _mm256_permute2x128_si256(s1, s5, 0x31);
+        r[6] = _mm256_permute2x128_si256(s2, s6, 0x31);
+        r[7] = _mm256_permute2x128_si256(s3, s7, 0x31);
+    }
+
+    AVX2_TARGET void sortBlocksAvx2(int* data, std::size_t size) {
+        // A plain array: std::array would drop the vector type's alignment attributes.
+        __m256i r[LANES];
+        for (std::size_t block = 0; block < size; block += BLOCK) {
+            auto* rows = reinterpret_cast<__m256i*>(data + block);
+            for (std::size_t i = 0; i < LANES; ++i) r[i] = _mm256_loadu_si256(rows + i);
+            for (const auto& [i, j] : NETWORK8) compareExchange(r[static_cast<std::size_t>(i)], r[static_cast<std::size_t>(j)]);
+            transpose8(r);
+            for (std::size_t i = 0; i < LANES; ++i) _mm256_storeu_si256(rows + i, r[i]);
+        }
+    }
+
+    /**
+     * @brief Sorts a bitonic vector ascending: compare-exchange at distance 4, 2 and 1.
+     */
+    AVX2_TARGET inline __m256i bitonicSort8(__m256i v) {
+        __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+        v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+        p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+        p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+    }
+
+    /**
+     * @brief Merges two sorted vectors: afterwards low holds the eight smallest and high the eight largest, both
+     * sorted.
+     */
+    AVX2_TARGET inline void bitonicMerge16(__m256i& low, __m256i& high) {
+        const __m256i reversed = _mm256_permutevar8x32_epi32(high, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        const __m256i minimum = _mm256_min_epi32(low, reversed);
+        const __m256i maximum = _mm256_max_epi32(low, reversed);
+        low = bitonicSort8(minimum);
+        high = bitonicSort8(maximum);
+    }
+
+    /**
+     * @brief Merges two sorted runs whose lengths are multiples of eight.
+     */
+    AVX2_TARGET void mergeAvx2(const int* a, std::size_t aSize, const int* b, std::size_t bSize, int* out) {
+        if (aSize == 0 || bSize == 0) {
+            std::copy(aSize ? a : b, (aSize ? a : b) + aSize + bSize, out);
+            return;
+        }
+        const int* aEnd = a + aSize;
+        const int* bEnd = b + bSize;
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        a += LANES;
+        b += LANES;
+        bitonicMerge16(low, high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), low);
+        out += LANES;
+        // high carries the eight largest elements seen so far; the next block comes from whichever run has the
+        // smaller head, so everything still unread is at least as large as what gets written out.
+        while (a != aEnd || b != bEnd) {
+            const int*& source = (b == bEnd || (a != aEnd && *a <= *b)) ? a : b;
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+            source += LANES;
+            bitonicMerge16(low, high);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), low);
+            out += LANES;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), high);
+    }
+#endif
+}
+
+bool vectorSortHasAvx2() {
+#if VECTOR_SORT_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void vectorSort(std::vector<int>& data, VectorSortKernel kernel) {
+    if (data.size() < 2) return;
+    const bool avx2 = kernel != VectorSortKernel::Scalar && vectorSortHasAvx2();
+
+    const std::size_t padded = (data.size() + BLOCK - 1) / BLOCK * BLOCK;
+    std::vector<int> source(padded, INT_MAX);
+    std::vector<int> target(padded);
+    std::copy(data.begin(), data.end(), source.begin());
+
+#if VECTOR_SORT_AVX2
+    auto sortBlocks = avx2 ? &sortBlocksAvx2 : &sortBlocksScalar;
+    auto merge = avx2 ? &mergeAvx2 : &mergeScalar;
+#else
+    auto sortBlocks = &sortBlocksScalar;
+    auto merge = &mergeScalar;
+    static_cast<void>(avx2);
+#endif
+    sortBlocks(source.data(), padded);
+    for (std::size_t width = LANES; width < padded; width *= 2) {
+        for (std::size_t begin = 0; begin < padded; begin += 2 * width) {
+            const std::size_t aSize = std::min(width, padded - begin);
+            const std::size_t bSize = std::min(width, padded - begin - aSize);
+            merge(source.data() + begin, aSize, source.data() + begin + aSize, bSize, target.data() + begin);
+        }
+        source.swap(target);
+    }
+    std::copy(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(data.size()), data.begin());
+}
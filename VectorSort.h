@@ -0,0 +1,31 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_VECTORSORT_H
+#define ALGOVISUALIZER_VECTORSORT_H
+#include <cstddef>
+#include <vector>
+
+enum class VectorSortKernel { Auto, Scalar, Avx2 };
+
+/**
+ * @brief Sorts ints with sorting networks and bitonic merges, eight lanes at a time.
+ *
+ * The input is padded to a multiple of 64. Each block of 64 is loaded into eight AVX2 registers, every column is
+ * sorted by a 19-comparator network, and a transpose turns the columns into sorted runs of eight. Runs are then
+ * merged pairwise: each step merges the next eight elements with the eight largest seen so far through an
+ * in-register bitonic merge and writes out the smaller half. The scalar kernel follows the same structure with
+ * branch-free min/max, and is used when the CPU (or compiler) has no AVX2.
+ *
+ * Needs two buffers of the padded size.
+ * @param kernel Auto picks AVX2 when the CPU supports it; Avx2 falls back to Scalar if it is unavailable.
+ */
+void vectorSort(std::vector<int>& data, VectorSortKernel kernel = VectorSortKernel::Auto);
+/**
+ * @brief Whether vectorSort can use the AVX2 kernel on this machine.
+ */
+bool vectorSortHasAvx2();
+
+
+#endif //ALGOVISUALIZER_VECTORSORT_H
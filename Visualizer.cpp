@@ -160,6 +160,9 @@ void Visualizer::handleEvents() {
         }
         if(!isFocused || event.window.windowID != windowID_) continue;
 
+        for(auto& renderable : renderables_){
+            renderable->handleEvent(event);
+        }
         switch(event.type){
             case SDL_QUIT:
 #ifndef ENABLE_LOGGING
@@ -168,6 +171,7 @@ void Visualizer::handleEvents() {
                 running_ = false;
                 break;
             case SDL_KEYDOWN:
+                if(!tetrisGame_) break;
                 switch(event.key.keysym.sym) {
                     case SDLK_LEFT:
                         tetrisGame_->movePieceLeft();
@@ -178,6 +182,12 @@ void Visualizer::handleEvents() {
                     case SDLK_UP:
                         tetrisGame_->rotatePiece();
                         break;
+                    case SDLK_z:
+                        tetrisGame_->rotatePiece(false);
+                        break;
+                    case SDLK_a:
+                        tetrisGame_->toggleAutoplay();
+                        break;
                     case SDLK_DOWN:
                         break;
                     default:
@@ -228,17 +238,38 @@ void Visualizer::render() {
     }
     fpsCounter_.update();
     fpsCounter_.render();
+    renderPerfOverlay();
 
     SDL_RenderPresent(sdlRenderer_);
 #ifndef ENABLE_LOGGING
     BOOST_LOG_TRIVIAL(debug) << "Frame rendered.";
 #endif
 }
+void Visualizer::renderPerfOverlay() {
+    if(!fpsFont_) return;
+    const SDL_Color textColor = {255, 255, 255, 255};
+    int y = 34;
+    for(const auto& renderable : renderables_){
+        const PerfRun* run = renderable->lastRun();
+        if(!run) continue;
+        const std::string text = fmt::format("{}: {}", run->label, run->sample.summary());
+        SDL_Surface* textSurface = TTF_RenderText_Solid(fpsFont_, text.c_str(), textColor);
+        if(!textSurface) continue;
+        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(sdlRenderer_, textSurface);
+        SDL_Rect textRect = {10, y, textSurface->w, textSurface->h};
+        SDL_RenderCopy(sdlRenderer_, textTexture, nullptr, &textRect);
+        y += textSurface->h + 2;
+        SDL_FreeSurface(textSurface);
+        SDL_DestroyTexture(textTexture);
+    }
+}
 /**
  * @brief Cleans up all SDL-related resources.
- * This includes closing the font, destroying the renderer, and destroying the window.
+ * This includes releasing the renderables, closing the font, destroying the renderer, and destroying the window.
  */
 void Visualizer::clean() {
+    // Views may own textures of the renderer, which have to go before it does.
+    renderables_.clear();
     if(fpsFont_){
         TTF_CloseFont(fpsFont_);
     }
@@ -133,6 +133,12 @@ private:
      * @brief Initializes all SDL components used by the Visualizer.
      */
     void initializeSDLComponents();
+    /**
+     * @brief Draws the last measured run of every renderable below the FPS counter.
+     *
+     * Shows the wall time and, where hardware counters are available, cycles, instructions, IPC and misses.
+     */
+    void renderPerfOverlay();
 
     /**
      * @brief Shared pointer to the maze being visualized.
@@ -0,0 +1,128 @@
+//
+// Created by daily on 19-10-26.
+//
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Forks a worker's deque holds before it first grows; a parallelFor over n indices forks about log2(n) deep.
+     */
+    constexpr std::size_t INITIAL_DEPTH = 64;
+}
+
+thread_local const WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+thread_local int WorkStealingPool::currentIndex = -1;
+
+WorkStealingPool::WorkStealingPool(unsigned threads) :
+    workers_(),
+    stop_(false),
+    queued_(0),
+    sleepers_(0),
+    finishedRoots_(0),
+    sleepMutex_(),
+    wake_(),
+    threads_() {
+    const unsigned count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->tasks.reserve(INITIAL_DEPTH);
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        stop_.store(true);
+    }
+    wake_.notify_all();
+    threads_.clear();
+}
+
+void WorkStealingPool::runRoot(Task& root) {
+    push(0, &root);
+    // done is set before the counter moves, so a waiter that missed the one sees the other change.
+    std::uint64_t finished = finishedRoots_.load(std::memory_order_acquire);
+    while (!root.done.load(std::memory_order_acquire)) {
+        finishedRoots_.wait(finished, std::memory_order_acquire);
+        finished = finishedRoots_.load(std::memory_order_acquire);
+    }
+}
+
+void WorkStealingPool::push(unsigned worker, Task* task) {
+    {
+        std::lock_guard lock(workers_[worker]->mutex);
+        workers_[worker]->tasks.push_back(task);
+    }
+    queued_.fetch_add(1);
+    // Pairs with the sleeper registering itself before checking queued_: one of the two always sees the other.
+    if (sleepers_.load() > 0) {
+        std::lock_guard lock(sleepMutex_);
+        wake_.notify_one();
+    }
+}
+
+bool WorkStealingPool::reclaim(unsigned worker, Task* task) {
+    std::lock_guard lock(workers_[worker]->mutex);
+    auto& tasks = workers_[worker]->tasks;
+    if (tasks.empty() || tasks.back() != task) {
+        return false;
+    }
+    tasks.pop_back();
+    queued_.fetch_sub(1);
+    return true;
+}
+
+WorkStealingPool::Task* WorkStealingPool::steal(unsigned thief) {
+    const auto count = static_cast<unsigned>(workers_.size());
+    for (unsigned offset = 0; offset < count; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % count];
+        std::lock_guard lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        Task* task;
+        if (offset == 0) {
+            // Our own deque: newest first, it is the one whose data is still in cache.
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+        } else {
+            task = victim.tasks.front();
+            victim.tasks.erase(victim.tasks.begin());
+        }
+        queued_.fetch_sub(1);
+        return task;
+    }
+    return nullptr;
+}
+
+bool WorkStealingPool::runOne(unsigned worker) {
+    Task* task = steal(worker);
+    if (!task) {
+        return false;
+    }
+    // Read before done is set: from then on the task may already be gone.
+    const bool waiterSleeps = task->waiterSleeps;
+    task->call(task->function);
+    task->done.store(true, std::memory_order_release);
+    if (waiterSleeps) {
+        finishedRoots_.fetch_add(1, std::memory_order_release);
+        finishedRoots_.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    currentPool = this;
+    currentIndex = static_cast<int>(index);
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock lock(sleepMutex_);
+        sleepers_.fetch_add(1);
+        wake_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+        sleepers_.fetch_sub(1);
+    }
+}
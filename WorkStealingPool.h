@@ -0,0 +1,147 @@
+//
+// Created by daily on 19-10-26.
+//
+
+#ifndef ALGOVISUALIZER_WORKSTEALINGPOOL_H
+#define ALGOVISUALIZER_WORKSTEALINGPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Fork-join thread pool where idle workers steal from the busy ones.
+ *
+ * Every worker owns a deque: forked tasks are pushed and popped at the back by the owner, while thieves take the
+ * oldest (and usually largest) task from the front. A worker waiting for a stolen task keeps running other tasks
+ * instead of blocking, so nested invoke() calls never deadlock. Idle workers sleep until work is pushed.
+ * Tasks must not throw.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @param threads Number of workers; 0 uses one per hardware thread.
+     */
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    [[nodiscard]] unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+    /**
+     * @brief Runs task on a worker and blocks until it, and everything it forked, has finished.
+     */
+    template<typename Function>
+    void run(const Function& task) {
+        if (currentPool == this) {
+            task();
+            return;
+        }
+        Task root(task, true);
+        runRoot(root);
+    }
+    /**
+     * @brief Runs a on the calling worker while b is offered to thieves; returns once both have finished.
+     *
+     * Outside the pool both simply run one after the other.
+     */
+    template<typename A, typename B>
+    void invoke(A&& a, B&& b) {
+        if (currentPool != this) {
+            a();
+            b();
+            return;
+        }
+        Task task(b);
+        push(static_cast<unsigned>(currentIndex), &task);
+        a();
+        // Take b back unless it was stolen; then help with other work until the thief is done with it.
+        if (reclaim(static_cast<unsigned>(currentIndex), &task)) {
+            b();
+            return;
+        }
+        while (!task.done.load(std::memory_order_acquire)) {
+            if (!runOne(static_cast<unsigned>(currentIndex))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    /**
+     * @brief Calls function(i) for every i in [begin, end), splitting the range recursively through invoke().
+     */
+    template<typename Function>
+    void parallelFor(std::size_t begin, std::size_t end, const Function& function) {
+        if (end - begin <= 1) {
+            if (begin < end) function(begin);
+            return;
+        }
+        const std::size_t middle = begin + (end - begin) / 2;
+        invoke([&] { parallelFor(begin, middle, function); }, [&] { parallelFor(middle, end, function); });
+    }
+    /**
+     * @brief Index of the calling worker in [0, size()), or -1 when called from outside any pool.
+     */
+    static int currentWorker() { return currentIndex; }
+
+private:
+    /**
+     * @brief A forked call. It only points at the callable, which lives in the frame that forked it and waits for
+     * it, so forking never allocates. That frame may return as soon as it sees done, so whoever ran the task must
+     * not touch it after setting done.
+     */
+    struct Task {
+        template<typename Function>
+        explicit Task(Function& f, bool sleeper = false) :
+            call([](void* target) { (*static_cast<Function*>(target))(); }),
+            function(const_cast<void*>(static_cast<const void*>(&f))),
+            done(false),
+            waiterSleeps(sleeper) {}
+
+        void (*call)(void*);
+        void* function;
+        std::atomic<bool> done;
+        /**
+         * @brief Whether the forking thread sleeps on finishedRoots_ instead of polling done.
+         */
+        bool waiterSleeps;
+    };
+    struct Worker {
+        std::mutex mutex{};
+        /**
+         * @brief Used as a deque. A vector keeps its capacity, so pushing stops allocating once it has grown, and
+         * taking the front is cheap because a worker is only ever a few forks deep.
+         */
+        std::vector<Task*> tasks{};
+    };
+
+    void runRoot(Task& root);
+    void push(unsigned worker, Task* task);
+    bool reclaim(unsigned worker, Task* task);
+    Task* steal(unsigned thief);
+    bool runOne(unsigned worker);
+    void workerLoop(unsigned index);
+
+    static thread_local const WorkStealingPool* currentPool;
+    static thread_local int currentIndex;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stop_;
+    std::atomic<std::size_t> queued_;
+    std::atomic<unsigned> sleepers_;
+    /**
+     * @brief Bumped whenever a task run() waits for finishes. Waiters sleep on this pool-owned counter rather than
+     * on the task, which dies with their frame.
+     */
+    std::atomic<std::uint64_t> finishedRoots_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::vector<std::jthread> threads_;
+};
+
+
+#endif //ALGOVISUALIZER_WORKSTEALINGPOOL_H
@@ -2,11 +2,205 @@
 #include "Visualizer.hpp"
 #include "Maze.hpp"
 #include "CustomCursor.h"
+#include "DataGenerator.h"
+#include "ExternalSortView.h"
 #include "Tetris.h"
+#include "AdaptiveSortView.h"
 #include "BubbleSort.h"
+#include "CacheView.h"
 #include "InsertionSort.h"
+#include "MazeExporter.hpp"
+#include "MazePipeline.hpp"
+#include "ParallelSortView.h"
+#include "RaceView.h"
+#include "RadixSortView.h"
+#include "SelectionView.h"
+#include "StringSortView.h"
+#include "StdAlgorithmView.h"
+#include "SortReplay.h"
+#include "SortRoutines.h"
+#include "SortVisualizer.h"
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <fmt/core.h>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 
-int main() {
+namespace {
+    /**
+     * @brief Element of the record sort window: too large to sort in place, so it is sorted through indices.
+     */
+    struct OrderRecord {
+        double price;
+        std::uint64_t orderId;
+        std::array<char, 48> client;
+    };
+
+    /**
+     * @brief Generates a maze and writes it to a PNG or SVG file without creating any window.
+     *
+     * usage: AlgoVisualizer --export <rows> <cols> <file.png|file.svg> [cellSize] [threads]
+     */
+    int runExport(int argc, char* argv[]) {
+        if (argc < 5) {
+            std::cerr << "usage: " << argv[0] << " --export <rows> <cols> <file.png|file.svg> [cellSize] [threads]\n";
+            return 1;
+        }
+        try {
+            const int rows = std::stoi(argv[2]);
+            const int cols = std::stoi(argv[3]);
+            const std::string path = argv[4];
+            const int cellSize = argc > 5 ? std::stoi(argv[5]) : 8;
+            const unsigned threads = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6]))
+                                              : std::max(1u, std::thread::hardware_concurrency());
+
+            const auto begin = std::chrono::steady_clock::now();
+            Maze maze(rows, cols);
+            MazeExporter exporter(maze, cellSize, std::max(1, cellSize / 4));
+            if (path.ends_with(".svg")) {
+                exporter.exportSvg(path);
+            } else {
+                exporter.exportPng(path, threads);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            std::cout << "Exported " << rows << "x" << cols << " maze to " << path << " in " << elapsed.count() << "s\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Export failed: " << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+    /**
+     * @brief Runs the generate, solve, analyze and serialize pipeline without creating any window.
+     *
+     * usage: AlgoVisualizer --batch <count> <rows> <cols> <seed> <output> [generators] [solvers] [analyzers] [queue]
+     */
+    int runBatch(int argc, char* argv[]) {
+        if (argc < 7) {
+            std::cerr << "usage: " << argv[0]
+                      << " --batch <count> <rows> <cols> <seed> <output> [generators] [solvers] [analyzers] [queue]\n";
+            return 1;
+        }
+        boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+        try {
+            MazeBatchConfig config;
+            config.count = std::stoul(argv[2]);
+            config.rows = std::stoi(argv[3]);
+            config.cols = std::stoi(argv[4]);
+            config.seed = std::stoull(argv[5]);
+            config.outputPath = argv[6];
+            if (argc > 7) config.generators = static_cast<unsigned>(std::stoul(argv[7]));
+            if (argc > 8) config.solvers = static_cast<unsigned>(std::stoul(argv[8]));
+            if (argc > 9) config.analyzers = static_cast<unsigned>(std::stoul(argv[9]));
+            if (argc > 10) config.queueCapacity = std::stoul(argv[10]);
+
+            MazePipeline pipeline(config);
+            pipeline.run();
+            pipeline.printReport(std::cout);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Batch failed: " << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+    /**
+     * @brief Sorts a binary file of native-endian ints that may be larger than memory in a window showing the runs.
+     *
+     * usage: AlgoVisualizer --external-sort <input> <output> [memoryMiB] [threads] [tempDirectory]
+     */
+    int runExternalSort(int argc, char* argv[]) {
+        if (argc < 4) {
+            std::cerr << "usage: " << argv[0]
+                      << " --external-sort <input> <output> [memoryMiB] [threads] [tempDirectory]\n";
+            return 1;
+        }
+        ExternalSortConfig config;
+        std::shared_ptr<ExternalSortView> view;
+        try {
+            config.inputPath = argv[2];
+            config.outputPath = argv[3];
+            if (argc > 4) {
+                const unsigned long long mebibytes = std::stoull(argv[4]);
+                if (mebibytes > std::numeric_limits<std::size_t>::max() >> 20) {
+                    throw std::out_of_range(fmt::format("{} MiB is more memory than can be addressed", argv[4]));
+                }
+                config.memoryBytes = static_cast<std::size_t>(mebibytes) << 20;
+            }
+            if (argc > 5) config.threads = static_cast<unsigned>(std::stoul(argv[5]));
+            if (argc > 6) config.tempDirectory = argv[6];
+            view = std::make_shared<ExternalSortView>(config);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "External sort failed: " << e.what() << '\n';
+            return 1;
+        }
+        if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+            std::cerr << "SDL could not initialize: " << SDL_GetError() << std::endl;
+            return -1;
+        }
+        auto visualizer = std::make_unique<Visualizer>("External Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+        view->setScreenDimensions(800, 600);
+        visualizer->addRenderable(view);
+        std::cout << "Created External Sort Window with ID:" << SDL_GetWindowID(visualizer->getWindow()) << '\n';
+
+        bool reported = false;
+        while (visualizer->running()) {
+            visualizer->handleEvents();
+            visualizer->update();
+            visualizer->render();
+            if (!reported && view->getSorter().phase() == ExternalSorter::Phase::Done) {
+                view->getSorter().printReport(std::cout);
+                reported = true;
+            }
+        }
+        visualizer->clean();
+        SDL_Quit();
+        return view->getSorter().phase() == ExternalSorter::Phase::Failed ? 1 : 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string_view(argv[1]) == "--export") {
+        return runExport(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--external-sort") {
+        return runExternalSort(argc, argv);
+    }
+    // usage: AlgoVisualizer [--seed <n>] [--distribution uniform|sorted|reversed|nearly-sorted|...] [--strings <file>]
+    DataSpec sortData{.distribution = Distribution::Uniform, .size = 0, .seed = randomSeed(), .maxValue = 1000};
+    std::string stringFile;
+    try {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string_view option = argv[i];
+            if (option == "--seed") {
+                sortData.seed = std::stoull(argv[i + 1]);
+            } else if (option == "--distribution") {
+                sortData.distribution = parseDistribution(argv[i + 1]);
+            } else if (option == "--strings") {
+                stringFile = argv[i + 1];
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    auto sortDataOfSize = [&](std::size_t size) {
+        DataSpec spec = sortData;
+        spec.size = size;
+        return spec;
+    };
     if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
         std::cerr << "SDL could not initialize: " << SDL_GetError() << std::endl;
         return -1;
@@ -77,8 +271,9 @@ int main() {
 
     std::cout << "Created Square Window with ID:"<< SDL_GetWindowID(squareVisualizer->getWindow()) << '\n';
 
+    std::cout << "Sort windows use " << distributionName(sortData.distribution) << " data with --seed " << sortData.seed << '\n';
     auto bubbleSortVisualizer = std::make_unique<Visualizer>("Bubble Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
-    auto bubbleSort = std::make_shared<BubbleSort>(200);
+    auto bubbleSort = std::make_shared<BubbleSort>(sortDataOfSize(200));
     bubbleSort->setScreenDimensions(800, 600);
     bubbleSort->startSort();
     bubbleSortVisualizer->addRenderable(bubbleSort);
@@ -86,37 +281,145 @@ int main() {
 
 
     auto insertionSortVisualizer = std::make_unique<Visualizer>("Insertion Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
-    auto insertionSort = std::make_shared<InsertionSort>(200);
+    auto insertionSort = std::make_shared<InsertionSort>(sortDataOfSize(200));
     insertionSort->setScreenDimensions(800, 600);
     insertionSort->startSort();
     insertionSortVisualizer->addRenderable(insertionSort);
     std::cout << "Created Insertion Sort Window with ID:" << SDL_GetWindowID(insertionSortVisualizer->getWindow()) << '\n';
 
+    auto recordSortVisualizer = std::make_unique<Visualizer>("Record Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    std::vector<OrderRecord> orders;
+    for (const int cents : generateData(sortDataOfSize(200))) {
+        orders.push_back(OrderRecord{cents / 100.0, orders.size(), {}});
+    }
+    using RecordSort = SortVisualizer<OrderRecord, std::ranges::less, double OrderRecord::*>;
+    auto recordSort = std::make_shared<RecordSort>(std::move(orders), RecordSort::Algorithm::Insertion, std::ranges::less{}, &OrderRecord::price);
+    recordSort->setScreenDimensions(800, 600);
+    recordSort->startSort();
+    recordSortVisualizer->addRenderable(recordSort);
+    std::cout << "Created Record Sort Window with ID:" << SDL_GetWindowID(recordSortVisualizer->getWindow()) << '\n';
+
+    auto sortReplayVisualizer = std::make_unique<Visualizer>("Sort Replay Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto sortReplay = std::make_shared<SortReplay>(sortDataOfSize(200), &bitonicSortRoutine);
+    sortReplay->setScreenDimensions(800, 600);
+    sortReplay->setOpsPerFrame(16);
+    sortReplayVisualizer->addRenderable(sortReplay);
+    std::cout << "Created Sort Replay Window with ID:" << SDL_GetWindowID(sortReplayVisualizer->getWindow()) << '\n';
+
+    auto parallelSortVisualizer = std::make_unique<Visualizer>("Parallel Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto parallelSort = std::make_shared<ParallelSortView>(sortDataOfSize(4000), 4);
+    parallelSort->setScreenDimensions(800, 600);
+    parallelSortVisualizer->addRenderable(parallelSort);
+    std::cout << "Created Parallel Sort Window with ID:" << SDL_GetWindowID(parallelSortVisualizer->getWindow()) << '\n';
+
+    auto radixSortVisualizer = std::make_unique<Visualizer>("Radix Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto radixSort = std::make_shared<RadixSortView>(sortDataOfSize(2000));
+    radixSort->setScreenDimensions(800, 600);
+    radixSortVisualizer->addRenderable(radixSort);
+    std::cout << "Created Radix Sort Window with ID:" << SDL_GetWindowID(radixSortVisualizer->getWindow()) << '\n';
+
+    auto stdAlgorithmVisualizer = std::make_unique<Visualizer>("Std Algorithm Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto stdAlgorithm = std::make_shared<StdAlgorithmView>(sortDataOfSize(500));
+    stdAlgorithm->setScreenDimensions(800, 600);
+    stdAlgorithmVisualizer->addRenderable(stdAlgorithm);
+    std::cout << "Created Std Algorithm Window with ID:" << SDL_GetWindowID(stdAlgorithmVisualizer->getWindow()) << '\n';
+
+    auto raceVisualizer = std::make_unique<Visualizer>("Sort Race Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto race = std::make_shared<RaceView>(sortDataOfSize(300));
+    race->setScreenDimensions(800, 600);
+    raceVisualizer->addRenderable(race);
+    std::cout << "Created Sort Race Window with ID:" << SDL_GetWindowID(raceVisualizer->getWindow()) << '\n';
+
+    // Scaled down from a real L1 and L2 so a few thousand elements already spill out of both.
+    auto cacheVisualizer = std::make_unique<Visualizer>("Cache Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto cacheView = std::make_shared<CacheView>(sortDataOfSize(4096), std::vector<CacheLevelConfig>{{2 * 1024, 64, 4}, {8 * 1024, 64, 8}});
+    cacheView->setScreenDimensions(800, 600);
+    cacheVisualizer->addRenderable(cacheView);
+    std::cout << "Created Cache Window with ID:" << SDL_GetWindowID(cacheVisualizer->getWindow()) << '\n';
+
+    auto adaptiveSortVisualizer = std::make_unique<Visualizer>("Adaptive Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto adaptiveSort = std::make_shared<AdaptiveSortView>(sortDataOfSize(2000));
+    adaptiveSort->setScreenDimensions(800, 600);
+    adaptiveSortVisualizer->addRenderable(adaptiveSort);
+    std::cout << "Created Adaptive Sort Window with ID:" << SDL_GetWindowID(adaptiveSortVisualizer->getWindow()) << '\n';
+
+    auto selectionVisualizer = std::make_unique<Visualizer>("Selection Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto selectionView = std::make_shared<SelectionView>(sortDataOfSize(4000));
+    selectionView->setScreenDimensions(800, 600);
+    selectionVisualizer->addRenderable(selectionView);
+    std::cout << "Created Selection Window with ID:" << SDL_GetWindowID(selectionVisualizer->getWindow()) << '\n';
+
+    auto stringSortVisualizer = std::make_unique<Visualizer>("String Sort Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false);
+    auto stringSortView = std::make_shared<StringSortView>(stringFile, 4000, 1);
+    stringSortView->setScreenDimensions(800, 600);
+    stringSortVisualizer->addRenderable(stringSortView);
+    std::cout << "Created String Sort Window with ID:" << SDL_GetWindowID(stringSortVisualizer->getWindow()) << '\n';
+
 
 
-    while (mazeVisualizer->running() && squareVisualizer->running() && tetrisVisualizer->running() && bubbleSortVisualizer->running() && insertionSortVisualizer->running() ) {
+    while (mazeVisualizer->running() && squareVisualizer->running() && tetrisVisualizer->running() && bubbleSortVisualizer->running() && insertionSortVisualizer->running() && recordSortVisualizer->running() && sortReplayVisualizer->running() && parallelSortVisualizer->running() && radixSortVisualizer->running() && stdAlgorithmVisualizer->running() && raceVisualizer->running() && cacheVisualizer->running() && adaptiveSortVisualizer->running() && selectionVisualizer->running() && stringSortVisualizer->running()) {
         mazeVisualizer->handleEvents();
         squareVisualizer->handleEvents();
         tetrisVisualizer->handleEvents();
         bubbleSortVisualizer->handleEvents();
         insertionSortVisualizer->handleEvents();
+        recordSortVisualizer->handleEvents();
+        sortReplayVisualizer->handleEvents();
+        parallelSortVisualizer->handleEvents();
+        radixSortVisualizer->handleEvents();
+        stdAlgorithmVisualizer->handleEvents();
+        raceVisualizer->handleEvents();
+        cacheVisualizer->handleEvents();
+        adaptiveSortVisualizer->handleEvents();
+        selectionVisualizer->handleEvents();
+        stringSortVisualizer->handleEvents();
 
         mazeVisualizer->update();
         squareVisualizer->update();
         tetrisVisualizer->update();
         bubbleSortVisualizer->update();
         insertionSortVisualizer->update();
+        recordSortVisualizer->update();
+        sortReplayVisualizer->update();
+        parallelSortVisualizer->update();
+        radixSortVisualizer->update();
+        stdAlgorithmVisualizer->update();
+        raceVisualizer->update();
+        cacheVisualizer->update();
+        adaptiveSortVisualizer->update();
+        selectionVisualizer->update();
+        stringSortVisualizer->update();
 
         mazeVisualizer->render();
         tetrisVisualizer->render();
         squareVisualizer->render();
         bubbleSortVisualizer->render();
         insertionSortVisualizer->render();
+        recordSortVisualizer->render();
+        sortReplayVisualizer->render();
+        parallelSortVisualizer->render();
+        radixSortVisualizer->render();
+        stdAlgorithmVisualizer->render();
+        raceVisualizer->render();
+        cacheVisualizer->render();
+        adaptiveSortVisualizer->render();
+        selectionVisualizer->render();
+        stringSortVisualizer->render();
     }
     mazeVisualizer->clean();
     squareVisualizer->clean();
     tetrisVisualizer->clean();
     bubbleSortVisualizer->clean();
     insertionSortVisualizer->clean();
+    recordSortVisualizer->clean();
+    sortReplayVisualizer->clean();
+    parallelSortVisualizer->clean();
+    radixSortVisualizer->clean();
+    stdAlgorithmVisualizer->clean();
+    raceVisualizer->clean();
+    cacheVisualizer->clean();
+    adaptiveSortVisualizer->clean();
+    selectionVisualizer->clean();
+    stringSortVisualizer->clean();
     SDL_Quit();
 }
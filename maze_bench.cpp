@@ -0,0 +1,56 @@
+//
+// Created by daily on 19-10-26.
+//
+// Compares the breadth-first Maze::findShortestPath against dead-end filling on large perfect mazes, with the
+// hardware counters of each run where the kernel allows reading them.
+// usage: maze_bench [size] [threads] [repeats]
+//
+#include "Maze.hpp"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <fmt/core.h>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+    const int size = argc > 1 ? std::stoi(argv[1]) : 512;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2]))
+                                      : std::max(1u, std::thread::hardware_concurrency());
+    const int repeats = argc > 3 ? std::stoi(argv[3]) : 3;
+
+    const PerfCounters& counters = PerfCounters::forThisThread();
+    if (!counters.available()) {
+        fmt::print("hardware counters unavailable ({}), timing only\n", counters.unavailableReason());
+    }
+    Maze maze(size, size);
+    fmt::print("generate      {}\n", maze.lastRun()->sample.summary());
+    const double cells = static_cast<double>(size) * static_cast<double>(size);
+    const Maze::Point start(0, 0);
+    fmt::print("maze {}x{}, {} thread(s), {} repeat(s)\n", size, size, threads, repeats);
+
+    for (int repeat = 0; repeat < repeats; ++repeat) {
+        const PerfSample bfs = measurePerf([&] { maze.findShortestPath(start, start); });
+        const double bfsSeconds = bfs.seconds;
+        const std::size_t bfsLength = maze.path_.size();
+        const Maze::Point end(maze.farthestPoint_.first, maze.farthestPoint_.second);
+
+        std::size_t passes = 0;
+        const PerfSample fill = measurePerf([&] { passes = maze.solveByDeadEndFilling(start, end, 1); });
+        const double fillSeconds = fill.seconds;
+        const double parallelSeconds = measurePerf([&] { maze.solveByDeadEndFilling(start, end, threads); }).seconds;
+        const std::size_t fillLength = maze.path_.size();
+
+        fmt::print("bfs {:8.2f} Mcell/s | dead-end fill {:8.2f} Mcell/s, {:6.2f} Mcell/s on {} thread(s) "
+                   "| {} passes | path {} vs {}{}\n",
+                   cells / bfsSeconds / 1e6, cells / fillSeconds / 1e6, cells / parallelSeconds / 1e6, threads,
+                   passes, bfsLength, fillLength, bfsLength == fillLength ? "" : " MISMATCH");
+        if (bfs.hasCounters()) {
+            fmt::print("  bfs           {}\n  dead-end fill {}\n", bfs.summary(), fill.summary());
+        }
+    }
+}
@@ -0,0 +1,715 @@
+//
+// Created by daily on 19-10-26.
+//
+// Runs every sort in the project natively over a grid of sizes and input distributions and compares them with the
+// standard library sorts. Each case is timed on plain ints, then sorted once more on an instrumented element type
+// to count comparisons, swaps and moves, so the counting never shows up in the timings. Allocations and the peak of
+// auxiliary heap memory are counted by replacing the global operator new during the timed runs, and where the kernel
+// allows it, hardware counters (cycles, instructions, branch and cache misses) are read around them on the calling
+// thread. Finally, for every sort that does not compare (radix, vector and parallel kernels), it reports the size
+// from which it stays ahead of the fastest comparison sort, for the adaptive sorts (timsort, pdqsort) their speedup
+// over std::sort on every distribution, and for the in-place merge sort its speed against std::stable_sort, which
+// allocates an O(n) buffer.
+//
+// With --select SIZE it instead pits selection against a full sort on one SIZE-element input per distribution:
+// finding the median with std::nth_element, introselect and Floyd-Rivest, and the smallest --top-k values with
+// std::partial_sort and the streaming TopK, once over the array in memory and once over chunks generated on the fly
+// that are never held all at once. Each is timed once; at 100M elements the input and its working copy take 800 MB.
+//
+// With --strings SOURCE it sorts strings instead: the lines of a file mapped into a StringArena, or with gen:N, N
+// generated words. Multikey quicksort, MSD radix sort and burstsort over the arena are timed against std::sort on
+// the same StringRefs and on a std::vector<std::string> holding a copy of every line.
+//
+// usage: sort_bench [--sizes 1000,100000] [--distributions uniform,sorted,...] [--algorithms std::sort,...]
+//                   [--repeats 5] [--seed 1] [--quadratic-limit 50000] [--csv file] [--json file]
+//        sort_bench --select 100000000 [--top-k 1000] [--distributions uniform,...] [--seed 1]
+//        sort_bench --strings words.txt|gen:10000000 [--seed 1]
+//
+#include "DataGenerator.h"
+#include "MemoryTracker.h"
+#include "ParallelSort.h"
+#include "PerfCounters.h"
+#include "RadixSort.h"
+#include "Selection.h"
+#include "SortInstrumentation.h"
+#include "SortAlgorithms.h"
+#include "StringSort.h"
+#include "VectorSort.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Blocks are counted at their usable size, which malloc_usable_size reports again when they are freed. Over-aligned
+// types go through the std::align_val_t overloads, so those are replaced as well and counted the same way.
+void* operator new(std::size_t size) {
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        MemoryTracker::recordAllocation(malloc_usable_size(pointer));
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+void operator delete(void* pointer) noexcept {
+    if (pointer) MemoryTracker::recordRelease(malloc_usable_size(pointer));
+    std::free(pointer);
+}
+void operator delete[](void* pointer) noexcept {
+    ::operator delete(pointer);
+}
+void operator delete(void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+void operator delete[](void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc takes only sizes that are a multiple of the alignment.
+    if (void* pointer = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align)) {
+        MemoryTracker::recordAllocation(malloc_usable_size(pointer));
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+
+namespace {
+    struct OpCounts {
+        unsigned long long comparisons = 0;
+        unsigned long long swaps = 0;
+        unsigned long long moves = 0;
+    };
+    OpCounts opCounts;
+
+    /**
+     * @brief int that counts every swap and every move or copy made of it; comparisons go through CountingLess.
+     */
+    struct Tracked {
+        int value;
+
+        explicit Tracked(int v) noexcept : value(v) {}
+        Tracked(const Tracked& other) : value(other.value) { ++opCounts.moves; }
+        Tracked(Tracked&& other) noexcept : value(other.value) { ++opCounts.moves; }
+        Tracked& operator=(const Tracked& other) {
+            value = other.value;
+            ++opCounts.moves;
+            return *this;
+        }
+        Tracked& operator=(Tracked&& other) noexcept {
+            value = other.value;
+            ++opCounts.moves;
+            return *this;
+        }
+        ~Tracked() = default;
+        friend void swap(Tracked& a, Tracked& b) noexcept {
+            ++opCounts.swaps;
+            std::swap(a.value, b.value);
+        }
+    };
+
+    struct CountingLess {
+        bool operator()(const Tracked& a, const Tracked& b) const noexcept {
+            ++opCounts.comparisons;
+            return a.value < b.value;
+        }
+    };
+
+    struct Algorithm {
+        std::string_view name;
+        /**
+         * @brief Quadratic sorts are skipped above --quadratic-limit elements.
+         */
+        bool quadratic;
+        void (*plain)(std::vector<int>&);
+        /**
+         * @brief Null for int-only kernels, which are timed but not counted.
+         */
+        void (*counted)(std::vector<Tracked>&);
+    };
+
+    template<typename Sorter>
+    Algorithm makeAlgorithm(std::string_view name, bool quadratic) {
+        return {name, quadratic,
+                [](std::vector<int>& data) { Sorter{}(data.begin(), data.end(), std::less<>{}); },
+                [](std::vector<Tracked>& data) { Sorter{}(data.begin(), data.end(), CountingLess{}); }};
+    }
+
+    struct BubbleSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { bubbleSort(first, last, compare); }
+    };
+    struct InsertionSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { insertionSort(first, last, compare); }
+    };
+    struct StdSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { std::sort(first, last, compare); }
+    };
+    struct StdStableSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { std::stable_sort(first, last, compare); }
+    };
+    struct RangesSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { std::ranges::sort(first, last, compare); }
+    };
+    struct TimSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { timSort(first, last, compare); }
+    };
+    struct PdqSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { pdqSort(first, last, compare); }
+    };
+    struct InPlaceMergeSorter {
+        template<typename Iterator, typename Compare>
+        void operator()(Iterator first, Iterator last, Compare compare) const { inPlaceMergeSort(first, last, compare); }
+    };
+
+    constexpr std::array<std::string_view, 2> ADAPTIVE_SORTS = {"timsort", "pdqsort"};
+    constexpr std::array<std::string_view, 1> IN_PLACE_STABLE_SORTS = {"inplace-merge"};
+
+    /**
+     * @brief std::sort over untraced counted elements, which should time like std::sort itself: tracing that is
+     * switched off has to compile away. The copy in and out costs about a nanosecond per element; the operation
+     * counts are those of std::sort.
+     */
+    void untracedCountedSort(std::vector<int>& data) {
+        std::vector<counted<int, false>> values(data.begin(), data.end());
+        const auto [first, last] = instrumented(values);
+        std::sort(first, last);
+        std::transform(values.begin(), values.end(), data.begin(), [](const auto& value) { return value.value(); });
+    }
+
+    /**
+     * @brief One worker per hardware thread, shared by all parallel runs and started before any timing.
+     */
+    WorkStealingPool& benchPool() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    std::vector<Algorithm> allAlgorithms() {
+        return {
+                makeAlgorithm<BubbleSorter>("bubble", true),
+                makeAlgorithm<InsertionSorter>("insertion", true),
+                makeAlgorithm<StdSorter>("std::sort", false),
+                makeAlgorithm<StdStableSorter>("std::stable_sort", false),
+                makeAlgorithm<RangesSorter>("std::ranges::sort", false),
+                makeAlgorithm<TimSorter>(ADAPTIVE_SORTS[0], false),
+                makeAlgorithm<PdqSorter>(ADAPTIVE_SORTS[1], false),
+                makeAlgorithm<InPlaceMergeSorter>(IN_PLACE_STABLE_SORTS[0], false),
+                {"std::sort[counted]", false, untracedCountedSort, makeAlgorithm<StdSorter>("", false).counted},
+                {"vector", false, [](std::vector<int>& data) { vectorSort(data); }, nullptr},
+                {"vector-scalar", false, [](std::vector<int>& data) { vectorSort(data, VectorSortKernel::Scalar); }, nullptr},
+                {"parallel-merge", false, [](std::vector<int>& data) { parallelMergeSort(benchPool(), data); }, nullptr},
+                {"sample-sort", false, [](std::vector<int>& data) { sampleSort(benchPool(), data); }, nullptr},
+                {"lsd-radix", false, [](std::vector<int>& data) { lsdRadixSort(data); }, nullptr},
+                {"msd-radix", false, [](std::vector<int>& data) { msdRadixSort(data); }, nullptr},
+        };
+    }
+
+    struct Result {
+        std::string_view algorithm;
+        std::string_view distribution;
+        std::size_t size;
+        double nsPerElement;
+        std::optional<OpCounts> counts;
+        std::uint64_t allocations;
+        std::uint64_t allocatedBytes;
+        /**
+         * @brief Most heap bytes the sort held at once, besides the data itself.
+         */
+        std::size_t peakBytes;
+        bool sorted;
+        /**
+         * @brief Time and counters summed over all timed repeats.
+         */
+        PerfSample perf;
+        int repeats;
+    };
+
+    Result measure(const Algorithm& algorithm, std::string_view distribution, const std::vector<int>& input, int repeats) {
+        Result result{algorithm.name, distribution, input.size(), 0.0, {}, 0, 0, 0, true, {}, repeats};
+        std::vector<double> timings;
+        std::vector<int> data;
+        for (int repeat = 0; repeat < repeats; ++repeat) {
+            data = input;
+            const MemoryTracker memory;
+            const PerfSample sample = measurePerf([&] { algorithm.plain(data); });
+            result.allocations = memory.allocations();
+            result.allocatedBytes = memory.allocatedBytes();
+            result.peakBytes = memory.peakBytes();
+            timings.push_back(sample.seconds * 1e9);
+            if (repeat == 0) {
+                result.perf = sample;
+            } else {
+                result.perf += sample;
+            }
+            result.sorted = result.sorted && std::is_sorted(data.begin(), data.end());
+        }
+        std::sort(timings.begin(), timings.end());
+        result.nsPerElement = timings[timings.size() / 2] / static_cast<double>(std::max<std::size_t>(input.size(), 1));
+
+        if (!algorithm.counted) {
+            return result;
+        }
+        std::vector<Tracked> tracked;
+        tracked.reserve(input.size());
+        for (const int value : input) tracked.emplace_back(value);
+        opCounts = {};
+        algorithm.counted(tracked);
+        result.counts = opCounts;
+        return result;
+    }
+
+    std::string formatBytes(std::size_t bytes) {
+        if (bytes >= std::size_t{1} << 20) return fmt::format("{:.1f}M", static_cast<double>(bytes) / (1 << 20));
+        if (bytes >= std::size_t{1} << 10) return fmt::format("{:.1f}K", static_cast<double>(bytes) / (1 << 10));
+        return std::to_string(bytes);
+    }
+
+    std::string formatCount(const std::optional<OpCounts>& counts, unsigned long long OpCounts::*field,
+                            std::string_view missing) {
+        return counts ? std::to_string((*counts).*field) : std::string(missing);
+    }
+
+    /**
+     * @brief Count of event per element and repeat, or the IPC without an event; missing if it was not counted.
+     */
+    std::string formatPerElement(const Result& r, std::optional<PerfEvent> event, std::string_view missing) {
+        const double runs = static_cast<double>(r.repeats) * static_cast<double>(std::max<std::size_t>(r.size, 1));
+        const std::optional<double> value = event ? r.perf.per(*event, runs) : r.perf.ipc();
+        return value ? fmt::format("{:.3f}", *value) : std::string(missing);
+    }
+
+    std::vector<std::string> splitList(std::string_view list) {
+        std::vector<std::string> items;
+        while (!list.empty()) {
+            const auto comma = list.find(',');
+            items.emplace_back(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+        }
+        return items;
+    }
+
+    void writeCsv(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+        out << "algorithm,distribution,size,ns_per_element,comparisons,swaps,moves,allocations,allocated_bytes,peak_bytes,sorted,"
+               "cycles_per_element,ipc,branch_misses_per_element,l1d_misses_per_element,llc_misses_per_element\n";
+        for (const auto& r : results) {
+            out << fmt::format("{},{},{},{:.4f},{},{},{},{},{},{},{},{},{},{},{},{}\n", r.algorithm, r.distribution, r.size,
+                               r.nsPerElement, formatCount(r.counts, &OpCounts::comparisons, ""),
+                               formatCount(r.counts, &OpCounts::swaps, ""), formatCount(r.counts, &OpCounts::moves, ""),
+                               r.allocations, r.allocatedBytes, r.peakBytes, r.sorted, formatPerElement(r, PerfEvent::Cycles, ""),
+                               formatPerElement(r, std::nullopt, ""), formatPerElement(r, PerfEvent::BranchMisses, ""),
+                               formatPerElement(r, PerfEvent::L1Misses, ""), formatPerElement(r, PerfEvent::LlcMisses, ""));
+        }
+    }
+
+    void writeJson(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+        out << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << fmt::format("  {{\"algorithm\": \"{}\", \"distribution\": \"{}\", \"size\": {}, \"ns_per_element\": {:.4f}, "
+                               "\"comparisons\": {}, \"swaps\": {}, \"moves\": {}, \"allocations\": {}, "
+                               "\"allocated_bytes\": {}, \"peak_bytes\": {}, \"sorted\": {}, \"cycles_per_element\": {}, \"ipc\": {}, "
+                               "\"branch_misses_per_element\": {}, \"l1d_misses_per_element\": {}, "
+                               "\"llc_misses_per_element\": {}}}{}\n",
+                               r.algorithm, r.distribution, r.size, r.nsPerElement,
+                               formatCount(r.counts, &OpCounts::comparisons, "null"),
+                               formatCount(r.counts, &OpCounts::swaps, "null"), formatCount(r.counts, &OpCounts::moves, "null"),
+                               r.allocations, r.allocatedBytes, r.peakBytes, r.sorted,
+                               formatPerElement(r, PerfEvent::Cycles, "null"),
+                               formatPerElement(r, std::nullopt, "null"), formatPerElement(r, PerfEvent::BranchMisses, "null"),
+                               formatPerElement(r, PerfEvent::L1Misses, "null"),
+                               formatPerElement(r, PerfEvent::LlcMisses, "null"),
+                               i + 1 < results.size() ? "," : "");
+        }
+        out << "]\n";
+    }
+
+    /**
+     * @brief For every algorithm without a comparator and every distribution, prints the smallest measured size
+     * from which it beats the fastest comparison sort at that size and at every larger measured size.
+     */
+    void printCrossovers(const std::vector<Algorithm>& algorithms, const std::vector<Result>& results) {
+        auto isComparison = [&](std::string_view name) {
+            return std::any_of(algorithms.begin(), algorithms.end(),
+                               [&](const Algorithm& algorithm) { return algorithm.name == name && algorithm.counted; });
+        };
+        if (std::none_of(results.begin(), results.end(), [&](const Result& r) { return isComparison(r.algorithm); })) {
+            return;
+        }
+        fmt::print("\n{:<18} {:<14} {:>14}  {}\n", "crossover", "distribution", "faster from", "fastest comparison sort there");
+        for (const auto& algorithm : algorithms) {
+            if (algorithm.counted) continue;
+            std::vector<std::string_view> distributions;
+            for (const auto& r : results) {
+                if (r.algorithm == algorithm.name &&
+                    std::find(distributions.begin(), distributions.end(), r.distribution) == distributions.end()) {
+                    distributions.push_back(r.distribution);
+                }
+            }
+            for (const auto distribution : distributions) {
+                // Results are in ascending size order, so walking backwards finds where the lead starts.
+                std::optional<std::size_t> from;
+                std::string_view rival = "-";
+                for (auto r = results.rbegin(); r != results.rend(); ++r) {
+                    if (r->algorithm != algorithm.name || r->distribution != distribution) continue;
+                    const Result* best = nullptr;
+                    for (const auto& other : results) {
+                        if (other.distribution == distribution && other.size == r->size &&
+                            isComparison(other.algorithm) && (!best || other.nsPerElement < best->nsPerElement)) {
+                            best = &other;
+                        }
+                    }
+                    if (!best) continue;
+                    if (r->nsPerElement >= best->nsPerElement) break;
+                    from = r->size;
+                    rival = best->algorithm;
+                }
+                fmt::print("{:<18} {:<14} {:>14}  {}\n", algorithm.name, distribution,
+                           from ? std::to_string(*from) : std::string("never"), rival);
+            }
+        }
+    }
+
+    /**
+     * @brief For every one of algorithms and every distribution, prints how many times faster than baseline it ran
+     * at each measured size, e.g. the adaptive sorts against std::sort, which should pull ahead on sorted, reversed
+     * and nearly sorted inputs, or the in-place merge sort against std::stable_sort, which shows what saving the
+     * buffer costs.
+     */
+    void printSpeedups(const std::vector<Result>& results, std::string_view baseline,
+                       std::span<const std::string_view> algorithms) {
+        auto find = [&](std::string_view algorithm, std::string_view distribution, std::size_t size) -> const Result* {
+            const auto it = std::find_if(results.begin(), results.end(), [&](const Result& r) {
+                return r.algorithm == algorithm && r.distribution == distribution && r.size == size;
+            });
+            return it == results.end() ? nullptr : &*it;
+        };
+        std::vector<std::size_t> sizes;
+        std::vector<std::string_view> distributions;
+        for (const auto& r : results) {
+            if (r.algorithm != baseline) continue;
+            if (std::find(sizes.begin(), sizes.end(), r.size) == sizes.end()) sizes.push_back(r.size);
+            if (std::find(distributions.begin(), distributions.end(), r.distribution) == distributions.end()) {
+                distributions.push_back(r.distribution);
+            }
+        }
+        const bool anyCompared = std::any_of(results.begin(), results.end(), [&](const Result& r) {
+            return std::find(algorithms.begin(), algorithms.end(), r.algorithm) != algorithms.end();
+        });
+        if (sizes.empty() || !anyCompared) return;
+
+        fmt::print("\n{:<20} {:<14}", fmt::format("vs {}", baseline), "distribution");
+        for (const auto size : sizes) fmt::print(" {:>9}", size);
+        fmt::print("\n");
+        for (const auto algorithm : algorithms) {
+            for (const auto distribution : distributions) {
+                fmt::print("{:<20} {:<14}", algorithm, distribution);
+                for (const auto size : sizes) {
+                    const Result* compared = find(algorithm, distribution, size);
+                    const Result* reference = find(baseline, distribution, size);
+                    fmt::print(" {:>9}", compared && reference && compared->nsPerElement > 0.0
+                                                 ? fmt::format("{:.2f}x", reference->nsPerElement / compared->nsPerElement)
+                                                 : std::string("-"));
+                }
+                fmt::print("\n");
+            }
+        }
+    }
+
+    /**
+     * @brief Times one selection run over a fresh copy of input, prints it against the full sort of size elements and
+     * returns whether its answer matched.
+     */
+    template<typename Run>
+    bool timeSelection(std::string_view name, std::string_view distribution, std::size_t size,
+                       const std::vector<int>& input, std::vector<int>& scratch, double fullSortSeconds, Run&& run) {
+        scratch = input;
+        bool correct = false;
+        const MemoryTracker memory;
+        const PerfSample sample = measurePerf([&] { correct = run(scratch); });
+        fmt::print("{:<26} {:<14} {:>11} {:>10.1f} {:>10} {:>12}{}\n", name, distribution, size, sample.seconds * 1e3,
+                   sample.seconds > 0.0 ? fmt::format("{:.1f}x", fullSortSeconds / sample.seconds) : std::string("-"),
+                   formatBytes(memory.peakBytes()), correct ? "" : "  WRONG");
+        return correct;
+    }
+
+    /**
+     * @brief Finds the median and the k smallest values of a size-element input per distribution, every way we have,
+     * and compares each with sorting the whole input.
+     */
+    bool runSelection(std::size_t size, std::size_t k, const std::vector<Distribution>& distributions,
+                      std::uint64_t seed) {
+        // Chunks of the streamed input; TopK holds at most 2k values besides the chunk being generated.
+        constexpr std::size_t STREAM_CHUNK = std::size_t{1} << 20;
+        k = std::min(k, size);
+        bool allCorrect = true;
+        fmt::print("{:<26} {:<14} {:>11} {:>10} {:>10} {:>12}\n", "selection", "distribution", "size", "ms",
+                   "vs sort", "peak aux");
+        for (const auto distribution : distributions) {
+            const DataSpec spec{.distribution = distribution, .size = size, .seed = seed};
+            const std::vector<int> input = generateData(spec);
+            const std::string_view name = distributionName(distribution);
+            std::vector<int> scratch;
+            const auto nth = static_cast<std::ptrdiff_t>(size / 2);
+
+            scratch = input;
+            const PerfSample full = measurePerf([&] { std::sort(scratch.begin(), scratch.end()); });
+            const int expectedMedian = size == 0 ? 0 : scratch[size / 2];
+            const std::vector<int> smallest(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(k));
+            fmt::print("{:<26} {:<14} {:>11} {:>10.1f} {:>10} {:>12}\n", "std::sort", name, size, full.seconds * 1e3,
+                       "1.0x", "-");
+
+            auto findsMedian = [&](auto select) {
+                return [&, select](std::vector<int>& data) {
+                    if (size == 0) return true;
+                    select(data.begin(), data.begin() + nth, data.end());
+                    return data[size / 2] == expectedMedian;
+                };
+            };
+            allCorrect &= timeSelection("std::nth_element", name, size, input, scratch, full.seconds,
+                                        findsMedian([](auto first, auto nthIt, auto last) { std::nth_element(first, nthIt, last); }));
+            allCorrect &= timeSelection("introselect", name, size, input, scratch, full.seconds,
+                                        findsMedian([](auto first, auto nthIt, auto last) { introSelect(first, nthIt, last); }));
+            allCorrect &= timeSelection("floyd-rivest", name, size, input, scratch, full.seconds,
+                                        findsMedian([](auto first, auto nthIt, auto last) { floydRivestSelect(first, nthIt, last); }));
+
+            const std::string partialName = fmt::format("std::partial_sort k={}", k);
+            allCorrect &= timeSelection(partialName, name, size, input, scratch, full.seconds, [&](std::vector<int>& data) {
+                std::partial_sort(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(k), data.end());
+                return std::equal(smallest.begin(), smallest.end(), data.begin());
+            });
+            const std::string topKName = fmt::format("top-k k={}", k);
+            allCorrect &= timeSelection(topKName, name, size, input, scratch, full.seconds, [&](std::vector<int>& data) {
+                TopK<int> top(k);
+                for (std::size_t offset = 0; offset < size; offset += STREAM_CHUNK) {
+                    top.push(std::span<const int>(data).subspan(offset, std::min(STREAM_CHUNK, size - offset)));
+                }
+                return top.sorted() == smallest;
+            });
+            // Each chunk is generated from its own seed, so this stream is a different input of the same size and
+            // distribution: it is timed for its memory, and checked only for returning k ascending values.
+            allCorrect &= timeSelection("top-k streamed", name, size, {}, scratch, full.seconds, [&](std::vector<int>&) {
+                TopK<int> top(k);
+                for (std::size_t offset = 0; offset < size; offset += STREAM_CHUNK) {
+                    DataSpec chunk = spec;
+                    chunk.size = std::min(STREAM_CHUNK, size - offset);
+                    chunk.seed = seed + offset / STREAM_CHUNK;
+                    top.push(generateData(chunk));
+                }
+                const std::vector<int> values = top.sorted();
+                return values.size() == k && std::is_sorted(values.begin(), values.end());
+            });
+        }
+        return allCorrect;
+    }
+
+    /**
+     * @brief Sorts the strings of source, a file or gen:N, every way we have, and checks each order against std::sort.
+     */
+    bool runStrings(const std::string& source, std::uint64_t seed) {
+        constexpr std::string_view GENERATED = "gen:";
+        std::optional<StringArena> loaded;
+        const MemoryTracker loadMemory;
+        const PerfSample load = measurePerf([&] {
+            loaded.emplace(source.starts_with(GENERATED)
+                                   ? StringArena::generate(std::stoul(source.substr(GENERATED.size())), seed)
+                                   : StringArena::mapFile(source));
+        });
+        const StringArena& arena = *loaded;
+        const std::size_t count = arena.strings().size();
+        fmt::print("{} strings in {} bytes, loaded in {:.1f} ms holding {} on the heap\n", count, arena.byteCount(),
+                   load.seconds * 1e3, formatBytes(loadMemory.peakBytes()));
+
+        std::vector<std::string> copies;
+        const MemoryTracker copyMemory;
+        copies.reserve(count);
+        for (const StringRef& string : arena.strings()) copies.emplace_back(arena.view(string));
+        fmt::print("a std::vector<std::string> of them takes {}\n\n", formatBytes(copyMemory.peakBytes()));
+
+        fmt::print("{:<26} {:>11} {:>10} {:>12} {:>10}\n", "string sort", "strings", "ms", "vs std::sort", "peak aux");
+        const PerfSample baseline = measurePerf([&] { std::sort(copies.begin(), copies.end()); });
+        fmt::print("{:<26} {:>11} {:>10.1f} {:>12} {:>10}\n", "std::sort std::string", count, baseline.seconds * 1e3,
+                   "1.00x", "-");
+        bool allCorrect = true;
+        auto run = [&](std::string_view name, auto sort) {
+            std::vector<StringRef> strings = arena.strings();
+            const MemoryTracker memory;
+            const PerfSample sample = measurePerf([&] { sort(std::span<StringRef>(strings)); });
+            bool correct = true;
+            for (std::size_t i = 0; i < count && correct; ++i) correct = arena.view(strings[i]) == copies[i];
+            fmt::print("{:<26} {:>11} {:>10.1f} {:>12} {:>10}{}\n", name, count, sample.seconds * 1e3,
+                       sample.seconds > 0.0 ? fmt::format("{:.2f}x", baseline.seconds / sample.seconds) : std::string("-"),
+                       formatBytes(memory.peakBytes()), correct ? "" : "  WRONG");
+            allCorrect = allCorrect && correct;
+        };
+        run("std::sort StringRef", [&](std::span<StringRef> strings) {
+            std::sort(strings.begin(), strings.end(),
+                      [&arena](const StringRef& a, const StringRef& b) { return arena.view(a) < arena.view(b); });
+        });
+        run("multikey quicksort", [&](std::span<StringRef> strings) { multikeyQuicksort(arena, strings); });
+        run("msd radix", [&](std::span<StringRef> strings) { msdStringSort(arena, strings); });
+        run("burstsort", [&](std::span<StringRef> strings) { burstSort(arena, strings); });
+        return allCorrect;
+    }
+
+    int usage(const char* program) {
+        std::cerr << "usage: " << program << " [--sizes 1000,100000] [--distributions uniform,sorted,...]"
+                  << " [--algorithms std::sort,...] [--repeats 5] [--seed 1] [--quadratic-limit 50000]"
+                  << " [--csv file] [--json file]\n"
+                  << "       " << program << " --select 100000000 [--top-k 1000] [--distributions uniform,...]"
+                  << " [--seed 1]\n"
+                  << "       " << program << " --strings words.txt|gen:10000000 [--seed 1]\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> sizes = {100, 1000, 10000, 100000, 1000000};
+    std::vector<Distribution> distributions(ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end());
+    std::vector<std::string> algorithmNames;
+    int repeats = 5;
+    std::uint64_t seed = 1;
+    std::size_t quadraticLimit = 50000;
+    std::string csvPath;
+    std::string jsonPath;
+    std::size_t selectSize = 0;
+    std::size_t topK = 1000;
+    std::string stringSource;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view option = argv[i];
+            if (i + 1 >= argc) return usage(argv[0]);
+            const std::string value = argv[++i];
+            if (option == "--sizes") {
+                sizes.clear();
+                for (const auto& item : splitList(value)) sizes.push_back(std::stoul(item));
+            } else if (option == "--distributions") {
+                distributions.clear();
+                for (const auto& item : splitList(value)) distributions.push_back(parseDistribution(item));
+            } else if (option == "--algorithms") {
+                algorithmNames = splitList(value);
+            } else if (option == "--repeats") {
+                repeats = std::max(1, std::stoi(value));
+            } else if (option == "--seed") {
+                seed = std::stoull(value);
+            } else if (option == "--quadratic-limit") {
+                quadraticLimit = std::stoul(value);
+            } else if (option == "--csv") {
+                csvPath = value;
+            } else if (option == "--json") {
+                jsonPath = value;
+            } else if (option == "--select") {
+                selectSize = std::stoul(value);
+            } else if (option == "--top-k") {
+                topK = std::stoul(value);
+            } else if (option == "--strings") {
+                stringSource = value;
+            } else {
+                return usage(argv[0]);
+            }
+        }
+
+        if (selectSize > 0) {
+            return runSelection(selectSize, topK, distributions, seed) ? 0 : 2;
+        }
+        if (!stringSource.empty()) {
+            return runStrings(stringSource, seed) ? 0 : 2;
+        }
+
+        std::vector<Algorithm> algorithms = allAlgorithms();
+        fmt::print("{} worker thread(s) for the parallel sorts\n", benchPool().size());
+        if (!algorithmNames.empty()) {
+            std::erase_if(algorithms, [&](const Algorithm& algorithm) {
+                return std::find(algorithmNames.begin(), algorithmNames.end(), algorithm.name) == algorithmNames.end();
+            });
+        }
+
+        // Opened before anything is timed, so the first run neither pays for nor allocates the counters.
+        const PerfCounters& counters = PerfCounters::forThisThread();
+        const bool counted = counters.available();
+        if (counted) {
+            fmt::print("hardware counters on the calling thread{}\n",
+                       counters.unavailableReason().empty() ? "" : fmt::format(", except {}", counters.unavailableReason()));
+        } else {
+            fmt::print("hardware counters unavailable ({}), timing only\n", counters.unavailableReason());
+        }
+
+        fmt::print("{:<18} {:<14} {:>9} {:>10} {:>14} {:>12} {:>12} {:>7} {:>9}", "algorithm", "distribution", "size",
+                   "ns/elem", "comparisons", "swaps", "moves", "allocs", "peak aux");
+        if (counted) {
+            fmt::print(" {:>10} {:>6} {:>10} {:>10} {:>10}", "cyc/elem", "IPC", "brmiss/el", "L1miss/el", "LLCmiss/el");
+        }
+        fmt::print("\n");
+        std::vector<Result> results;
+        for (const auto size : sizes) {
+            for (const auto distribution : distributions) {
+                const std::vector<int> input = generateData(DataSpec{.distribution = distribution, .size = size, .seed = seed});
+                for (const auto& algorithm : algorithms) {
+                    if (algorithm.quadratic && size > quadraticLimit) continue;
+                    const Result& r = results.emplace_back(measure(algorithm, distributionName(distribution), input, repeats));
+                    fmt::print("{:<18} {:<14} {:>9} {:>10.2f} {:>14} {:>12} {:>12} {:>7} {:>9}", r.algorithm,
+                               r.distribution, r.size, r.nsPerElement, formatCount(r.counts, &OpCounts::comparisons, "-"),
+                               formatCount(r.counts, &OpCounts::swaps, "-"), formatCount(r.counts, &OpCounts::moves, "-"),
+                               r.allocations, formatBytes(r.peakBytes));
+                    if (counted) {
+                        fmt::print(" {:>10} {:>6} {:>10} {:>10} {:>10}", formatPerElement(r, PerfEvent::Cycles, "-"),
+                                   formatPerElement(r, std::nullopt, "-"), formatPerElement(r, PerfEvent::BranchMisses, "-"),
+                                   formatPerElement(r, PerfEvent::L1Misses, "-"),
+                                   formatPerElement(r, PerfEvent::LlcMisses, "-"));
+                    }
+                    fmt::print("{}\n", r.sorted ? "" : "  NOT SORTED");
+                }
+            }
+        }
+
+        printCrossovers(algorithms, results);
+        printSpeedups(results, "std::sort", ADAPTIVE_SORTS);
+        printSpeedups(results, "std::stable_sort", IN_PLACE_STABLE_SORTS);
+
+        if (!csvPath.empty()) writeCsv(csvPath, results);
+        if (!jsonPath.empty()) writeJson(jsonPath, results);
+        const bool allSorted = std::all_of(results.begin(), results.end(), [](const Result& r) { return r.sorted; });
+        return allSorted ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
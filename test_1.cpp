@@ -5,9 +5,56 @@
 #define CATCH_CONFIG_MAIN
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/container/stable_vector.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <tuple>
 #include <vector>
 #include <catch2/catch.hpp>
+#include <fmt/core.h>
+#include <zlib.h>
+#include "BoundedQueue.h"
+#include "BarRenderer.h"
+#include "CacheSimulator.h"
+#include "DataGenerator.h"
+#include "DeadEndFiller.hpp"
+#include "Maze.hpp"
+#include "MazeExporter.hpp"
+#include "MazePipeline.hpp"
+#include "ExternalSort.h"
+#include "MemoryTracker.h"
+#include "Piece.h"
+#include "PerfCounters.h"
+#include "ParallelSort.h"
+#include "RaceView.h"
+#include "RadixSort.h"
+#include "SnapshotBuffer.h"
+#include "SortAlgorithms.h"
+#include "SortEngine.h"
+#include "Selection.h"
+#include "SortInstrumentation.h"
+#include "SortReplay.h"
+#include "SortRoutines.h"
+#include "SortTrace.h"
+#include "SortVisualizer.h"
+#include "StdAlgorithmView.h"
+#include "StringSort.h"
+#include "TetrisAI.h"
+#include "TetrisBatch.h"
+#include "TetrisBoard.h"
+#include "VectorSort.h"
 
 TEST_CASE("Boost Graph Test", "[boost_graph]") {
     typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> Graph;
@@ -42,4 +89,1084 @@ TEST_CASE("Boost Stable Vector Basic Operations", "[stable_vector]") {
     vec.push_back(5); // This should not invalidate 'it'
     REQUIRE(*it == 0);
 }
-#endif
\ No newline at end of file
+
+TEST_CASE("Dead-end filling leaves only the corridor", "[dead_end_filler]") {
+    // 2x3 maze: corridor 0 -> 1 -> 2 -> 5, with a dead-end branch 1 -> 4 -> 3.
+    const std::vector<std::uint8_t> walls = {13, 1, 3,
+                                             13, 6, 14};
+    for (unsigned threads : {1u, 2u}) {
+        DeadEndFiller filler(walls, 2, 3);
+        REQUIRE(filler.fill(0, 5, threads) >= 2);
+        REQUIRE(filler.corridor(0, 5) == std::vector<std::size_t>{0, 1, 2, 5});
+        REQUIRE(filler.getOpenings()[3] == 0);
+        REQUIRE(filler.getOpenings()[4] == 0);
+    }
+}
+
+TEST_CASE("Maze export draws exactly the maze's walls, as PNG pixels and as SVG path runs", "[maze_exporter]") {
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string png = (directory / "algovisualizer-maze.png").string();
+    const std::string svg = (directory / "algovisualizer-maze.svg").string();
+    auto bigEndian = [](const std::string& bytes, std::size_t offset) {
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < 4; ++i) value = value << 8 | static_cast<std::uint8_t>(bytes[offset + i]);
+        return value;
+    };
+    // Any perfect maze this small has a fixed wall layout: a 1x5 corridor keeps only its outline (4 runs) and a
+    // 2x2 maze keeps one inner wall besides the outline (5 runs). The 23x17 maze is left to the wall checks.
+    for (const auto& [rows, cols, runs] : {std::tuple{1, 5, 4}, std::tuple{2, 2, 5}, std::tuple{23, 17, 0}}) {
+        const Maze maze(rows, cols, 11);
+        const MazeExporter exporter(maze, 8, 2);
+        const auto height = static_cast<std::size_t>(rows);
+        const auto width = static_cast<std::size_t>(cols);
+        const std::vector<std::uint8_t>& cells = maze.getCells();
+        auto hasWall = [&](std::size_t r, std::size_t c, std::uint8_t wall) {
+            return (cells[r * width + c] & wall) != 0;
+        };
+
+        std::string first;
+        for (unsigned threads : {1u, 3u}) {
+            exporter.exportPng(png, threads, 64);
+            std::ifstream in(png, std::ios::binary);
+            const std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            REQUIRE(bytes.size() > 33);
+            REQUIRE(bytes.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0);
+            REQUIRE(bytes.compare(12, 4, "IHDR") == 0);
+            REQUIRE(bigEndian(bytes, 16) == static_cast<std::uint32_t>(cols * 8));
+            REQUIRE(bigEndian(bytes, 20) == static_cast<std::uint32_t>(rows * 8));
+            if (first.empty()) first = bytes;
+            REQUIRE(bytes == first);
+        }
+
+        // Inflate the IDAT chunks back into scanlines: a filter byte, always 0, then one palette index per pixel.
+        std::string deflated;
+        for (std::size_t offset = 8; offset + 12 <= first.size(); offset += 12 + bigEndian(first, offset)) {
+            if (first.compare(offset + 4, 4, "IDAT") == 0) deflated.append(first, offset + 8, bigEndian(first, offset));
+        }
+        const std::size_t stride = width * 8 + 1;
+        std::vector<std::uint8_t> scanlines(height * 8 * stride);
+        uLongf inflated = scanlines.size();
+        REQUIRE(uncompress(scanlines.data(), &inflated, reinterpret_cast<const Bytef*>(deflated.data()),
+                           deflated.size()) == Z_OK);
+        REQUIRE(inflated == scanlines.size());
+        auto isWall = [&](std::size_t x, std::size_t y) {
+            REQUIRE(scanlines[y * stride] == 0);
+            return scanlines[y * stride + 1 + x] == MazeExporter::WALL;
+        };
+        // The middle of each edge of a cell is black exactly when the cell has that wall, and its centre never is.
+        for (std::size_t r = 0; r < height; ++r) {
+            for (std::size_t c = 0; c < width; ++c) {
+                const std::size_t x = c * 8;
+                const std::size_t y = r * 8;
+                REQUIRE(isWall(x + 4, y) == hasWall(r, c, Maze::TOP_WALL));
+                REQUIRE(isWall(x + 7, y + 4) == hasWall(r, c, Maze::RIGHT_WALL));
+                REQUIRE(isWall(x + 4, y + 7) == hasWall(r, c, Maze::BOTTOM_WALL));
+                REQUIRE(isWall(x, y + 4) == hasWall(r, c, Maze::LEFT_WALL));
+                REQUIRE_FALSE(isWall(x + 4, y + 4));
+            }
+        }
+
+        exporter.exportSvg(svg);
+        std::ifstream in(svg);
+        const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        REQUIRE(text.find(fmt::format("width=\"{}\" height=\"{}\"", cols * 8, rows * 8)) != std::string::npos);
+        const std::size_t begin = text.find(" d=\"");
+        REQUIRE(begin != std::string::npos);
+        const std::string path = text.substr(begin + 4, text.find('"', begin + 4) - begin - 4);
+        if (runs > 0) REQUIRE(std::count(path.begin(), path.end(), 'M') == runs);
+
+        // Split every run into cell edges: (boundary row, column) across, (row, boundary column) down.
+        std::set<std::pair<std::size_t, std::size_t>> across;
+        std::set<std::pair<std::size_t, std::size_t>> down;
+        std::istringstream commands(path);
+        char move = 0;
+        char axis = 0;
+        std::size_t x = 0;
+        std::size_t y = 0;
+        std::size_t to = 0;
+        while (commands >> move >> x >> y >> axis >> to) {
+            REQUIRE(move == 'M');
+            REQUIRE((axis == 'H' ? x : y) < to);
+            for (std::size_t at = axis == 'H' ? x : y; at < to; at += 8) {
+                // No edge is drawn twice.
+                const bool fresh = axis == 'H' ? across.insert({y / 8, at / 8}).second
+                                               : down.insert({at / 8, x / 8}).second;
+                REQUIRE(fresh);
+            }
+        }
+        REQUIRE(commands.eof());
+        for (std::size_t boundary = 0; boundary <= height; ++boundary) {
+            for (std::size_t c = 0; c < width; ++c) {
+                const bool wall = (boundary < height && hasWall(boundary, c, Maze::TOP_WALL)) ||
+                                  (boundary > 0 && hasWall(boundary - 1, c, Maze::BOTTOM_WALL));
+                REQUIRE(across.count({boundary, c}) == (wall ? 1u : 0u));
+            }
+        }
+        for (std::size_t r = 0; r < height; ++r) {
+            for (std::size_t boundary = 0; boundary <= width; ++boundary) {
+                const bool wall = (boundary < width && hasWall(r, boundary, Maze::LEFT_WALL)) ||
+                                  (boundary > 0 && hasWall(r, boundary - 1, Maze::RIGHT_WALL));
+                REQUIRE(down.count({r, boundary}) == (wall ? 1u : 0u));
+            }
+        }
+    }
+    std::filesystem::remove(png);
+    std::filesystem::remove(svg);
+}
+
+TEST_CASE("Bounded queue refuses when full, hands back in order and loses nothing across threads", "[bounded_queue]") {
+    BoundedQueue<int> queue(5);
+    REQUIRE(queue.capacity() == 8);
+    int value = 0;
+    REQUIRE_FALSE(queue.tryPop(value));
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 8; ++i) {
+            value = i;
+            REQUIRE(queue.tryPush(value));
+        }
+        value = 42;
+        REQUIRE_FALSE(queue.tryPush(value));
+        REQUIRE(value == 42);
+        REQUIRE(queue.size() == 8);
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE_FALSE(queue.tryPop(value));
+    }
+
+    // Producers close the queue once all of them are done; consumers then drain whatever is left, as the pipeline does.
+    constexpr int PER_PRODUCER = 20000;
+    constexpr int PRODUCERS = 3;
+    BoundedQueue<int> shared(16);
+    std::atomic<int> producing{PRODUCERS};
+    std::atomic<bool> closed{false};
+    std::vector<std::vector<int>> received(2);
+    {
+        std::vector<std::jthread> threads;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < PER_PRODUCER; ++i) {
+                    int item = p * PER_PRODUCER + i;
+                    while (!shared.tryPush(item)) std::this_thread::yield();
+                }
+                if (producing.fetch_sub(1) == 1) closed.store(true);
+            });
+        }
+        for (auto& items : received) {
+            threads.emplace_back([&shared, &closed, &items] {
+                int item = 0;
+                while (true) {
+                    if (shared.tryPop(item)) {
+                        items.push_back(item);
+                    } else if (closed.load()) {
+                        if (!shared.tryPop(item)) break;
+                        items.push_back(item);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+    }
+    std::vector<int> all;
+    for (const auto& items : received) {
+        // Each producer's items reach any one consumer in the order they were pushed.
+        for (int p = 0; p < PRODUCERS; ++p) {
+            std::vector<int> fromProducer;
+            std::copy_if(items.begin(), items.end(), std::back_inserter(fromProducer),
+                         [p](int item) { return item / PER_PRODUCER == p; });
+            REQUIRE(std::is_sorted(fromProducer.begin(), fromProducer.end()));
+        }
+        all.insert(all.end(), items.begin(), items.end());
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<int> expected(PRODUCERS * PER_PRODUCER);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(all == expected);
+}
+
+TEST_CASE("Maze pipeline writes every maze once, in id order, whatever the worker counts", "[maze_pipeline]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "algovisualizer-mazes.bin").string();
+    auto readFile = [&path] {
+        std::ifstream in(path, std::ios::binary);
+        return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    };
+    auto littleEndian = [](const std::string& bytes, std::size_t offset, std::size_t size) {
+        std::uint64_t value = 0;
+        for (std::size_t i = size; i-- > 0;) value = value << 8 | static_cast<std::uint8_t>(bytes[offset + i]);
+        return value;
+    };
+    constexpr std::size_t COUNT = 60;
+    constexpr int ROWS = 7;
+    constexpr int COLS = 9;
+    constexpr std::size_t RECORD = 40 + (ROWS * COLS + 1) / 2;
+
+    std::string reference;
+    for (const auto& [generators, solvers, analyzers, capacity] :
+         {std::tuple{1u, 1u, 1u, std::size_t{64}}, std::tuple{3u, 2u, 3u, std::size_t{2}}}) {
+        MazePipeline pipeline(MazeBatchConfig{.count = COUNT, .rows = ROWS, .cols = COLS, .seed = 5,
+                                              .outputPath = path, .generators = generators, .solvers = solvers,
+                                              .analyzers = analyzers, .queueCapacity = capacity});
+        pipeline.run();
+        const std::string bytes = readFile();
+        REQUIRE(bytes.size() == 16 + COUNT * RECORD);
+        REQUIRE(bytes.compare(0, 4, "AMZB") == 0);
+        REQUIRE(littleEndian(bytes, 8, 8) == COUNT);
+        for (std::size_t id = 0; id < COUNT; ++id) {
+            const std::size_t record = 16 + id * RECORD;
+            REQUIRE(littleEndian(bytes, record, 8) == id);
+            REQUIRE(littleEndian(bytes, record + 8, 8) == 5 + id);
+            REQUIRE(littleEndian(bytes, record + 16, 4) == ROWS);
+            REQUIRE(littleEndian(bytes, record + 20, 4) == COLS);
+            REQUIRE(littleEndian(bytes, record + 24, 4) > 0);
+        }
+        if (reference.empty()) reference = bytes;
+        REQUIRE(bytes == reference);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Vector sort matches std::sort on both kernels", "[vector_sort]") {
+    // Sizes around the 8-lane and 64-element block boundaries, with extreme values that collide with the padding.
+    for (std::size_t size : {0u, 1u, 7u, 8u, 63u, 64u, 65u, 1000u}) {
+        std::vector<int> data(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = i % 3 == 0 ? INT_MAX : i % 3 == 1 ? INT_MIN : static_cast<int>((i * 7919) % 101);
+        }
+        std::vector<int> expected = data;
+        std::sort(expected.begin(), expected.end());
+        for (auto kernel : {VectorSortKernel::Scalar, VectorSortKernel::Avx2}) {
+            std::vector<int> sorted = data;
+            vectorSort(sorted, kernel);
+            REQUIRE(sorted == expected);
+        }
+    }
+}
+
+TEST_CASE("Generated data depends only on the spec, not the thread count", "[data_generator]") {
+    for (const auto distribution : ALL_DISTRIBUTIONS) {
+        const DataSpec spec{.distribution = distribution, .size = std::size_t{3} << 20, .seed = 42, .maxValue = 5000};
+        const std::vector<int> single = generateData(spec, 1);
+        REQUIRE(generateData(spec, 4) == single);
+        REQUIRE(std::all_of(single.begin(), single.end(), [](int value) { return value >= 1 && value <= 5000; }));
+        REQUIRE(parseDistribution(distributionName(distribution)) == distribution);
+    }
+    const std::vector<int> reversed = generateData(DataSpec{.distribution = Distribution::Reversed, .size = 1000});
+    REQUIRE(std::is_sorted(reversed.rbegin(), reversed.rend()));
+    REQUIRE(generateData(DataSpec{.size = 1000, .seed = 1}) != generateData(DataSpec{.size = 1000, .seed = 2}));
+}
+
+TEST_CASE("Sort engine stops at the frame budget and finishes over repeated runs", "[sort_engine]") {
+    std::vector<int> data = generateData(DataSpec{.size = 300, .seed = 3});
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end());
+    SortEngine engine;
+    engine.start(bubbleSortRoutine(data));
+    // An unbounded op limit with a budget that is over at once: only the first step runs before the clock is read.
+    REQUIRE(engine.run(std::numeric_limits<std::size_t>::max(), std::chrono::nanoseconds(1)) == 1);
+    REQUIRE(engine.running());
+    std::size_t runs = 1;
+    while (engine.running()) {
+        engine.run(std::numeric_limits<std::size_t>::max(), std::chrono::nanoseconds(1));
+        ++runs;
+    }
+    REQUIRE(runs > 1);
+    REQUIRE(data == expected);
+}
+
+TEST_CASE("Sort traces round-trip through their encoding and seek to any op", "[sort_trace]") {
+    for (auto routine : {&insertionSortRoutine, &bitonicSortRoutine}) {
+        const std::vector<int> initial = generateData(DataSpec{.size = 100, .seed = 21});
+        std::vector<int> data = initial;
+        std::vector<SortOp> ops;
+        // A short keyframe interval so seeks restore keyframes both before and after the player's position.
+        SortTrace trace(initial, 97);
+        SortRoutine sort = routine(data);
+        while (sort.next()) {
+            ops.push_back(sort.op());
+            trace.append(sort.op());
+        }
+        REQUIRE(trace.size() == ops.size());
+        REQUIRE(trace.current() == data);
+        REQUIRE(std::is_sorted(data.begin(), data.end()));
+
+        // The array after the first position ops, replayed from the ops themselves.
+        auto replayed = [&](std::size_t position) {
+            std::vector<int> values = initial;
+            for (std::size_t k = 0; k < position; ++k) {
+                const SortOp& op = ops[k];
+                if (op.kind == SortOp::Kind::Swap) std::swap(values[op.i], values[op.j]);
+                if (op.kind == SortOp::Kind::Write) values[op.i] = op.value;
+            }
+            return values;
+        };
+        SortTracePlayer player(trace);
+        const std::size_t size = ops.size();
+        for (const std::size_t position : {size / 2, std::size_t{1}, std::size_t{96}, std::size_t{97}, std::size_t{98},
+                                           size, std::size_t{0}, size - 1, size / 3, size / 3 + 5, std::size_t{500}}) {
+            player.seek(position);
+            REQUIRE(player.position() == position);
+            REQUIRE(player.values() == replayed(position));
+            if (position > 0) {
+                REQUIRE(player.lastOp().kind == ops[position - 1].kind);
+                REQUIRE(player.lastOp().i == ops[position - 1].i);
+            }
+        }
+        player.rewind(250);
+        REQUIRE(player.values() == replayed(250));
+        REQUIRE(player.advance(size) == size - 250);
+        REQUIRE(player.values() == data);
+        player.seek(size + 10);
+        REQUIRE(player.position() == size);
+    }
+}
+
+TEST_CASE("Sort traces record and replay empty and single-element inputs", "[sort_trace]") {
+    for (auto routine : {&bubbleSortRoutine, &insertionSortRoutine, &bitonicSortRoutine}) {
+        for (const std::size_t size : {0u, 1u}) {
+            const std::vector<int> initial = generateData(DataSpec{.size = size, .seed = 2});
+            const SortTrace trace = SortTrace::record(initial, routine);
+            REQUIRE(trace.current() == initial);
+            SortTracePlayer player(trace);
+            REQUIRE(player.advance(10) == trace.size());
+            REQUIRE(player.values() == initial);
+            player.rewind(10);
+            REQUIRE(player.position() == 0);
+        }
+        SortReplay replay(DataSpec{.size = 0}, routine);
+        replay.update();
+    }
+
+    SortTrace trace(std::vector<int>{}, 4);
+    trace.append(SortOp::sorted(0, 0));
+    REQUIRE_THROWS_AS(trace.append(SortOp::sorted(0, 1)), std::out_of_range);
+    REQUIRE_THROWS_AS(trace.append(SortOp::write(0, 5)), std::out_of_range);
+    SortTrace pair(std::vector<int>{2, 1}, 4);
+    pair.append(SortOp::sorted(1, 2));
+    REQUIRE_THROWS_AS(pair.append(SortOp::sorted(2, 1)), std::out_of_range);
+    REQUIRE_THROWS_AS(pair.append(SortOp::swap(0, 2)), std::out_of_range);
+}
+
+TEST_CASE("Parallel sorts match std::sort on any worker count and their write logs replay", "[parallel_sort]") {
+    // A small grain makes both sorts fork, merge and scatter across many tasks even on this little input.
+    constexpr std::size_t GRAIN = 64;
+    std::vector<std::vector<int>> inputs;
+    inputs.push_back(generateData(DataSpec{.size = 20000, .seed = 5}));
+    inputs.push_back(generateData(DataSpec{.distribution = Distribution::FewUnique, .size = 20000, .seed = 5}));
+    inputs.push_back(generateData(DataSpec{.distribution = Distribution::Sorted, .size = 20000, .seed = 5}));
+    // Every splitter of the sample sort equal: all elements fall into one bucket.
+    inputs.emplace_back(20000, 7);
+    inputs.push_back({3, 1, 2});
+
+    for (const unsigned threads : {1u, 2u, 3u}) {
+        WorkStealingPool pool(threads);
+        REQUIRE(pool.size() == threads);
+        std::vector<std::atomic<int>> visits(1000);
+        pool.run([&] { pool.parallelFor(0, visits.size(), [&](std::size_t i) { visits[i].fetch_add(1); }); });
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& count) { return count == 1; }));
+
+        for (const auto& input : inputs) {
+            std::vector<int> expected = input;
+            std::sort(expected.begin(), expected.end());
+
+            std::vector<int> merged = input;
+            SortWriteLog mergeLog(threads);
+            parallelMergeSort(pool, merged, mergeLog, GRAIN);
+            REQUIRE(merged == expected);
+            std::vector<int> sampled = input;
+            SortWriteLog sampleLog(threads);
+            sampleSort(pool, sampled, sampleLog, GRAIN);
+            REQUIRE(sampled == expected);
+
+            for (const SortWriteLog* log : {&mergeLog, &sampleLog}) {
+                std::vector<int> replayed = input;
+                for (const auto& event : log->events()) {
+                    std::copy(log->values(event), log->values(event) + event.count,
+                              replayed.begin() + static_cast<std::ptrdiff_t>(event.position));
+                }
+                REQUIRE(replayed == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Radix sorts match std::sort and their logs replay to the result", "[radix_sort]") {
+    // The largest size goes through the write-combining scatter; negative values exercise the sign flip.
+    for (std::size_t size : {0u, 1u, 31u, 33u, 1000u, 300000u}) {
+        std::vector<int> data = generateData(DataSpec{.size = size, .seed = 9});
+        for (std::size_t i = 0; i < data.size(); i += 3) data[i] = -data[i];
+        std::vector<int> expected = data;
+        std::sort(expected.begin(), expected.end());
+
+        RadixSortLog lsdLog;
+        std::vector<int> lsd = data;
+        lsdRadixSort(lsd, lsdLog);
+        REQUIRE(lsd == expected);
+        std::vector<int> msd = data;
+        msdRadixSort(msd);
+        REQUIRE(msd == expected);
+
+        std::vector<int> replayed = data;
+        for (const auto& event : lsdLog.events()) {
+            if (event.kind != RadixSortLog::Event::Kind::Write) continue;
+            std::copy(lsdLog.values(event), lsdLog.values(event) + event.count,
+                      replayed.begin() + static_cast<std::ptrdiff_t>(event.position));
+        }
+        REQUIRE(replayed == expected);
+    }
+}
+
+TEST_CASE("Traced standard algorithms replay to their result and untraced counted is plain", "[sort_instrumentation]") {
+    static_assert(std::is_trivially_copyable_v<counted<int, false>>);
+    static_assert(sizeof(counted<int, false>) == sizeof(int));
+
+    const std::vector<int> data = generateData(DataSpec{.size = 2000, .seed = 5, .maxValue = 300});
+    const auto runs = {
+            +[](std::vector<counted<int>>& values) { std::sort(values.begin(), values.end()); },
+            +[](std::vector<counted<int>>& values) { std::stable_sort(values.begin(), values.end()); },
+            +[](std::vector<counted<int>>& values) {
+                std::make_heap(values.begin(), values.end());
+                std::sort_heap(values.begin(), values.end());
+            },
+            +[](std::vector<counted<int>>& values) {
+                std::nth_element(values.begin(), values.begin() + 700, values.end());
+            },
+            +[](std::vector<counted<int>>& values) {
+                const auto [first, last] = instrumented(values);
+                std::ranges::sort(first, last);
+            },
+    };
+    for (const auto run : runs) {
+        std::vector<counted<int>> values(data.begin(), data.end());
+        SortOpBuffer buffer(std::size_t{1} << 10);
+        std::vector<int> replayed = data;
+        std::size_t compares = 0;
+        // A buffer far smaller than the trace, so the algorithm really waits on the consumer.
+        std::jthread producer([&] {
+            SortTracer tracer(values.data(), values.size(), sizeof(counted<int>), buffer);
+            run(values);
+            buffer.finish();
+        });
+        std::vector<SortOp> ops(256);
+        while (!buffer.drained()) {
+            const std::size_t count = buffer.pop(ops.data(), ops.size());
+            for (std::size_t k = 0; k < count; ++k) {
+                const SortOp& op = ops[k];
+                if (op.kind == SortOp::Kind::Write) replayed[op.i] = op.value;
+                if (op.kind == SortOp::Kind::Swap) std::swap(replayed[op.i], replayed[op.j]);
+                if (op.kind == SortOp::Kind::Compare) ++compares;
+            }
+        }
+        producer.join();
+        REQUIRE(compares > 0);
+        REQUIRE(std::equal(replayed.begin(), replayed.end(), values.begin(), values.end(),
+                           [](int value, const counted<int, true>& element) { return value == element.value(); }));
+    }
+}
+
+TEST_CASE("Cancelling a traced algorithm partway unwinds it rather than terminating", "[sort_instrumentation]") {
+    const std::vector<int> data = generateData(DataSpec{.size = 20000, .seed = 9});
+    const auto runs = {
+            +[](std::vector<counted<int>>& values) { std::sort(values.begin(), values.end()); },
+            +[](std::vector<counted<int>>& values) { std::stable_sort(values.begin(), values.end()); },
+            +[](std::vector<counted<int>>& values) {
+                std::make_heap(values.begin(), values.end());
+                std::sort_heap(values.begin(), values.end());
+            },
+            +[](std::vector<counted<int>>& values) {
+                const auto [first, last] = instrumented(values);
+                std::ranges::sort(first, last);
+            },
+    };
+    for (const auto run : runs) {
+        std::vector<counted<int>> values(data.begin(), data.end());
+        SortOpBuffer buffer(std::size_t{1} << 8);
+        bool cancelled = false;
+        std::jthread producer([&] {
+            try {
+                SortTracer tracer(values.data(), values.size(), sizeof(counted<int>), buffer);
+                run(values);
+            } catch (const SortTraceCancelled&) {
+                cancelled = true;
+            }
+            buffer.finish();
+        });
+        // Moves, move assignments and swaps all record, so the cancel lands in whichever one is blocked on the ring.
+        std::vector<SortOp> ops(64);
+        for (std::size_t popped = 0; popped < 1000;) popped += buffer.pop(ops.data(), ops.size());
+        buffer.cancel();
+        while (!buffer.drained()) buffer.pop(ops.data(), ops.size());
+        producer.join();
+        REQUIRE(cancelled);
+    }
+
+    // The view cancels its worker on every restart and when it is destroyed.
+    StdAlgorithmView view(DataSpec{.size = 20000, .seed = 9});
+    for (const auto algorithm : {StdAlgorithmView::Algorithm::Sort, StdAlgorithmView::Algorithm::StableSort,
+                                 StdAlgorithmView::Algorithm::HeapSort, StdAlgorithmView::Algorithm::NthElement,
+                                 StdAlgorithmView::Algorithm::RangesSort}) {
+        view.start(algorithm);
+        for (int frame = 0; frame < 3; ++frame) view.update();
+    }
+}
+
+TEST_CASE("Restarting or closing a race stops lanes that are partway through their sorts", "[race_view]") {
+    // At 16 operations per element per second every lane is still being paced when the race is restarted.
+    RaceView race(DataSpec{.size = 2000, .seed = 4});
+    for (int restart = 0; restart < 2; ++restart) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        race.update();
+        race.start();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    race.update();
+    // Destroying the view stops the lanes of the third race the same way.
+}
+
+TEST_CASE("TimSort is stable, pdqsort matches std::sort, and both report the structure they find", "[adaptive_sort]") {
+    struct Events {
+        std::vector<std::pair<std::size_t, std::size_t>> runs{};
+        std::size_t fallbacks = 0;
+        void run(std::size_t begin, std::size_t end) { runs.emplace_back(begin, end); }
+        void fallback(std::size_t, std::size_t) { ++fallbacks; }
+    };
+    for (const auto distribution : ALL_DISTRIBUTIONS) {
+        for (const std::size_t size : {0u, 1u, 23u, 200u, 5000u}) {
+            const std::vector<int> data = generateData(DataSpec{.distribution = distribution, .size = size, .seed = 9});
+            // Few distinct keys, so stability shows.
+            std::vector<std::pair<int, std::size_t>> keyed;
+            for (std::size_t i = 0; i < size; ++i) keyed.emplace_back(data[i] % 7, i);
+            auto byKey = [](const auto& a, const auto& b) { return a.first < b.first; };
+            auto expected = keyed;
+            std::stable_sort(expected.begin(), expected.end(), byKey);
+            Events events;
+            timSort(keyed.begin(), keyed.end(), byKey, events);
+            REQUIRE(keyed == expected);
+            if (size > 1) {
+                REQUIRE(events.runs.back() == std::pair<std::size_t, std::size_t>{0, size});
+            }
+
+            std::vector<int> sorted = data;
+            std::sort(sorted.begin(), sorted.end());
+            std::vector<int> values = data;
+            pdqSort(values.begin(), values.end());
+            REQUIRE(values == sorted);
+        }
+    }
+
+    // Reversed input is one descending run, reversed in place.
+    Events reversed;
+    std::vector<int> data = generateData(DataSpec{.distribution = Distribution::Reversed, .size = 1000});
+    timSort(data.begin(), data.end(), std::less<>{}, reversed);
+    REQUIRE(std::is_sorted(data.begin(), data.end()));
+    REQUIRE(reversed.runs.size() == 1);
+
+    // McIlroy's adversary keeps defeating the pivot choice until pdqsort falls back to heapsort.
+    std::vector<int> adversary = quicksortAdversary(2000, [](auto first, auto last, auto compare) {
+        pdqSort(first, last, compare);
+    });
+    Events attacked;
+    pdqSort(adversary.begin(), adversary.end(), std::less<>{}, attacked);
+    REQUIRE(attacked.fallbacks > 0);
+    std::vector<int> permutation(adversary.size());
+    std::iota(permutation.begin(), permutation.end(), 1);
+    REQUIRE(adversary == permutation);
+}
+
+TEST_CASE("In-place merge sort is stable without a buffer, and the memory tracker reports the peak", "[in_place_merge_sort]") {
+    for (const auto distribution : ALL_DISTRIBUTIONS) {
+        for (const std::size_t size : {0u, 1u, 31u, 700u, 20000u}) {
+            const std::vector<int> data = generateData(DataSpec{.distribution = distribution, .size = size, .seed = 6});
+            // Few distinct keys and merges far longer than the cache, so the rotations have to keep ties in order.
+            std::vector<std::pair<int, std::size_t>> keyed;
+            for (std::size_t i = 0; i < size; ++i) keyed.emplace_back(data[i] % 5, i);
+            auto byKey = [](const auto& a, const auto& b) { return a.first < b.first; };
+            auto expected = keyed;
+            std::stable_sort(expected.begin(), expected.end(), byKey);
+            inPlaceMergeSort(keyed.begin(), keyed.end(), byKey);
+            REQUIRE(keyed == expected);
+        }
+    }
+
+    // Without a default constructor there is no cache, and every merge is done by rotations alone.
+    struct Key {
+        explicit Key(int v) noexcept : value(v) {}
+        int value;
+    };
+    std::vector<Key> keys;
+    for (const int value : generateData(DataSpec{.distribution = Distribution::Uniform, .size = 3000})) keys.emplace_back(value);
+    inPlaceMergeSort(keys.begin(), keys.end(), [](const Key& a, const Key& b) { return a.value < b.value; });
+    REQUIRE(std::is_sorted(keys.begin(), keys.end(), [](const Key& a, const Key& b) { return a.value < b.value; }));
+
+    MemoryTracker::recordAllocation(100);
+    const MemoryTracker memory;
+    MemoryTracker::recordAllocation(300);
+    MemoryTracker::recordRelease(300);
+    MemoryTracker::recordAllocation(200);
+    REQUIRE(memory.peakBytes() == 300);
+    REQUIRE(memory.allocations() == 2);
+    REQUIRE(memory.allocatedBytes() == 500);
+    MemoryTracker::recordRelease(200);
+    MemoryTracker::recordRelease(100);
+}
+
+TEST_CASE("Selections place the nth element like nth_element, narrowing their window, and top-k streams", "[selection]") {
+    struct Events {
+        std::vector<std::pair<std::size_t, std::size_t>> windows{};
+        void run(std::size_t, std::size_t) {}
+        void fallback(std::size_t, std::size_t) {}
+        void window(std::size_t begin, std::size_t end) { windows.emplace_back(begin, end); }
+    };
+    auto placed = [](const std::vector<int>& values, std::size_t nth, const std::vector<int>& sorted) {
+        return values[nth] == sorted[nth] &&
+               std::all_of(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(nth),
+                           [&](int v) { return v <= sorted[nth]; }) &&
+               std::all_of(values.begin() + static_cast<std::ptrdiff_t>(nth), values.end(),
+                           [&](int v) { return v >= sorted[nth]; });
+    };
+    auto nested = [](const Events& events) {
+        for (std::size_t i = 1; i < events.windows.size(); ++i) {
+            const auto [outerBegin, outerEnd] = events.windows[i - 1];
+            const auto [begin, end] = events.windows[i];
+            if (begin < outerBegin || end > outerEnd || begin >= end) return false;
+        }
+        return true;
+    };
+    for (const auto distribution : ALL_DISTRIBUTIONS) {
+        for (const std::size_t size : {1u, 17u, 600u, 5000u}) {
+            const std::vector<int> data = generateData(DataSpec{.distribution = distribution, .size = size, .seed = 4});
+            std::vector<int> sorted = data;
+            std::sort(sorted.begin(), sorted.end());
+            for (const std::size_t nth : {std::size_t{0}, size / 3, size - 1}) {
+                std::vector<int> values = data;
+                Events intro;
+                introSelect(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(nth), values.end(),
+                            std::less<>{}, intro);
+                REQUIRE(placed(values, nth, sorted));
+                REQUIRE(nested(intro));
+                REQUIRE(intro.windows.back() == std::pair<std::size_t, std::size_t>{nth, nth + 1});
+
+                values = data;
+                Events floydRivest;
+                floydRivestSelect(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(nth), values.end(),
+                                  std::less<>{}, floydRivest);
+                REQUIRE(placed(values, nth, sorted));
+                REQUIRE(nested(floydRivest));
+            }
+
+            // Uneven chunks, and k both below and above the number of values.
+            for (const std::size_t k : {0u, 10u, 6000u}) {
+                TopK<int> top(k);
+                for (std::size_t offset = 0; offset < size; offset += 7 + offset % 300) {
+                    top.push(std::span<const int>(data).subspan(offset, std::min<std::size_t>(7 + offset % 300, size - offset)));
+                }
+                REQUIRE(top.seen() == size);
+                REQUIRE(top.sorted() == std::vector<int>(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(std::min(k, size))));
+            }
+        }
+    }
+
+    // The median-of-three killer for introselect exhausts its depth; median-of-medians pivots keep it linear.
+    std::vector<int> adversary = quicksortAdversary(20000, [](auto first, auto last, auto compare) {
+        introSelect(first, first + (last - first) / 2, last, compare);
+    });
+    std::size_t comparisons = 0;
+    introSelect(adversary.begin(), adversary.begin() + 10000, adversary.end(), [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+    REQUIRE(adversary[10000] == 10001);
+    REQUIRE(comparisons < 40 * adversary.size());
+}
+
+TEST_CASE("String sorts match std::sort on an arena of generated or mapped strings", "[string_sort]") {
+    // 40000 words put about 10000 behind each shared prefix, more than a burstsort bucket holds before it bursts.
+    const StringArena generated = StringArena::generate(40000, 5);
+    std::vector<std::string_view> expected;
+    for (const StringRef& string : generated.strings()) expected.push_back(generated.view(string));
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(std::adjacent_find(expected.begin(), expected.end()) != expected.end());
+
+    auto sortedViews = [&generated](auto sort) {
+        std::vector<StringRef> strings = generated.strings();
+        sort(std::span<StringRef>(strings));
+        std::vector<std::string_view> views;
+        for (const StringRef& string : strings) views.push_back(generated.view(string));
+        return views;
+    };
+    REQUIRE(sortedViews([&](std::span<StringRef> s) { multikeyQuicksort(generated, s); }) == expected);
+    REQUIRE(sortedViews([&](std::span<StringRef> s) { msdStringSort(generated, s); }) == expected);
+    REQUIRE(sortedViews([&](std::span<StringRef> s) { burstSort(generated, s); }) == expected);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "algovisualizer-strings.txt").string();
+    std::ofstream(path, std::ios::binary) << "pear\r\napple\n\nbanana\napple";
+    {
+        StringArena mapped = StringArena::mapFile(path);
+        burstSort(mapped, mapped.strings());
+        std::vector<std::string_view> lines;
+        for (const StringRef& string : mapped.strings()) lines.push_back(mapped.view(string));
+        REQUIRE(lines == std::vector<std::string_view>{"", "apple", "apple", "banana", "pear"});
+    }
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(StringArena::mapFile(path), std::runtime_error);
+}
+
+TEST_CASE("Burstsort sorts many copies of one long string without bursting them byte by byte", "[string_sort]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "algovisualizer-long-line.txt").string();
+    std::ofstream(path, std::ios::binary) << std::string(5000, 'x');
+    {
+        const StringArena mapped = StringArena::mapFile(path);
+        const StringRef line = mapped.strings().front();
+        // Three times the copies a bucket holds, and prefixes of the line ending along the way, all mixed up.
+        std::vector<StringRef> strings(3 * string_sort_detail::BURST_LIMIT, line);
+        for (std::uint32_t length = 0; length < line.length; length += 97) strings.push_back({line.offset, length});
+        std::shuffle(strings.begin(), strings.end(), std::mt19937(3));
+        const std::size_t count = strings.size();
+        burstSort(mapped, std::span<StringRef>(strings));
+        REQUIRE(strings.size() == count);
+        REQUIRE(std::is_sorted(strings.begin(), strings.end(), [](const StringRef& a, const StringRef& b) {
+            return a.length < b.length;
+        }));
+        REQUIRE(std::count_if(strings.begin(), strings.end(), [&](const StringRef& string) {
+            return string.length == line.length;
+        }) == static_cast<std::ptrdiff_t>(3 * string_sort_detail::BURST_LIMIT));
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tetris AI finds every reachable placement, tucks included, and takes the line", "[tetris_ai]") {
+    std::vector<TetrisPlacement> placements;
+    const TetrisBoard::Rows empty{};
+    for (const auto& [type, count] : {std::pair{0, 17u}, {1, 9u}, {2, 34u}, {3, 17u}, {6, 34u}}) {
+        placements.clear();
+        enumeratePlacements(empty, type, placements);
+        REQUIRE(placements.size() == count);
+    }
+
+    // A roof over the three left columns: an O only gets under it by sliding in from the right.
+    TetrisBoard::Rows roofed{};
+    roofed[17] = 0b111;
+    placements.clear();
+    enumeratePlacements(roofed, 1, placements);
+    REQUIRE(std::any_of(placements.begin(), placements.end(), [](const TetrisPlacement& placement) {
+        return placement.x == 0 && placement.y == 18;
+    }));
+    REQUIRE(std::any_of(placements.begin(), placements.end(), [](const TetrisPlacement& placement) {
+        return placement.x == 0 && placement.y == 15;
+    }));
+
+    TetrisBoard::Rows holed{};
+    holed[18] = 0b11;
+    holed[19] = 0b1110;
+    // Heights 2, 2, 1, 1 sum to 6, one hole under column 0, bumpiness 1 + 1 from column 3 down to the floor.
+    const TetrisWeights unit{1.0, 1.0, 1.0, 1.0};
+    REQUIRE(evaluateWell(holed, 3, unit) == Approx(6 + 3 + 1 + 2));
+
+    // Four cells short of a line: with the I next, the best placement lies flat in the gap and clears it.
+    TetrisBoard::Rows gap{};
+    gap[19] = 0b0000111111;
+    TetrisAI ai(TetrisAIConfig{.beamWidth = 8, .threads = 2});
+    const std::array<int, 3> pieces = {0, 1, 2};
+    const std::optional<TetrisPlacement> best = ai.plan(gap, pieces);
+    REQUIRE(best.has_value());
+    REQUIRE(ai.evaluated() > 17);
+    TetrisBoard::place(gap, piece_tables::ROW_TABLE[0][static_cast<std::size_t>(best->rotation)], best->x, best->y);
+    REQUIRE(TetrisBoard::clearLines(gap) == 1);
+}
+
+TEST_CASE("Tetris batch steps games independently, reproducibly, and resets the ones that top out", "[tetris_batch]") {
+    const std::size_t games = 3000;
+    TetrisBatch batch(TetrisBatchConfig{.games = games, .seed = 9, .threads = 2});
+    TetrisBatch replay(TetrisBatchConfig{.games = games, .seed = 9, .threads = 1});
+    std::vector<std::uint8_t> actions(games);
+    std::vector<float> rewards(games);
+    std::vector<std::uint8_t> done(games);
+    std::vector<float> replayRewards(games);
+    std::vector<std::uint8_t> replayDone(games);
+    REQUIRE_THROWS_AS(batch.step(std::span(actions).first(1), rewards, done), std::invalid_argument);
+
+    // Game 0 stacks every piece against the left wall until it tops out; the others spread theirs around.
+    std::size_t finished = 0;
+    for (std::size_t step = 0; step < 60; ++step) {
+        for (std::size_t game = 0; game < games; ++game) {
+            actions[game] = static_cast<std::uint8_t>(game == 0 ? 0 : (game * 7 + step * 13) % TetrisBatch::ACTIONS);
+        }
+        const std::uint32_t piecesBefore = batch.pieces(0);
+        batch.step(actions, rewards, done);
+        replay.step(actions, replayRewards, replayDone);
+        REQUIRE(rewards == replayRewards);
+        REQUIRE(done == replayDone);
+        if (done[0]) {
+            ++finished;
+            REQUIRE(batch.pieces(0) == 0);
+            REQUIRE(batch.well(0) == TetrisBoard::Rows{});
+        } else {
+            REQUIRE(batch.pieces(0) == piecesBefore + 1);
+            std::uint32_t columns = 0;
+            for (const std::uint16_t row : batch.well(0)) columns |= row;
+            REQUIRE((columns & 1u) == 1u);
+        }
+    }
+    REQUIRE(finished > 0);
+    bool same = true;
+    for (std::size_t game = 0; game < games; ++game) {
+        same = same && batch.well(game) == replay.well(game) && batch.piece(game) == replay.piece(game) &&
+               batch.nextPiece(game) == replay.nextPiece(game) && batch.lines(game) == replay.lines(game);
+    }
+    REQUIRE(same);
+}
+
+TEST_CASE("Piece tables turn within their box and SRS kicks move a piece off the wall", "[piece]") {
+    static_assert(piece_tables::ROW_TABLE[2][1] == std::array<std::uint16_t, 4>{0b010, 0b110, 0b010, 0});
+    for (int type = 0; type < piece_tables::TYPES; ++type) {
+        const Piece spawned(type);
+        Piece piece = spawned;
+        for (int turn = 0; turn < piece_tables::ROTATIONS; ++turn) {
+            int cells = 0;
+            for (const std::uint16_t row : piece.getRows()) cells += std::popcount(row);
+            REQUIRE(cells == 4);
+            for (const Block& block : piece.getBlocks()) {
+                const unsigned row = piece.getRows()[static_cast<std::size_t>(block.getY() - piece.getY())];
+                REQUIRE(((row >> (block.getX() - piece.getX())) & 1u) == 1u);
+            }
+            piece = piece.rotated(true);
+        }
+        REQUIRE(piece.getRows() == spawned.getRows());
+        REQUIRE(piece.rotated(false).rotated(true).getRotation() == piece.getRotation());
+        // Every piece spawns on the top row, in the middle of the well.
+        int top = TetrisBoard::HEIGHT;
+        for (const Block& block : spawned.getBlocks()) top = std::min(top, block.getY());
+        REQUIRE(top == 0);
+    }
+
+    // A T pointing right against the left wall cannot point down in place; the first SRS kick moves it right.
+    const TetrisBoard board;
+    const Piece againstWall(2, 1, -1, 5);
+    REQUIRE(board.fits(againstWall.getRows(), againstWall.getX(), againstWall.getY()));
+    const Piece turned = againstWall.rotated(true);
+    REQUIRE_FALSE(board.fits(turned.getRows(), turned.getX(), turned.getY()));
+    const PieceOffset kick = againstWall.kicks(true)[1];
+    REQUIRE((kick.x == 1 && kick.y == 0));
+    REQUIRE(board.fits(turned.getRows(), turned.getX() + kick.x, turned.getY() + kick.y));
+    REQUIRE(Piece(1, 0, 4, 0).kicks(true).size() == 1);
+    REQUIRE(Piece(0, 0, 3, -1).kicks(false).size() == 5);
+}
+
+TEST_CASE("Tetris board tests fit by row masks and clears full rows with their colors", "[tetris_board]") {
+    TetrisBoard board;
+    const std::array<std::uint16_t, 2> square = {0b11, 0b11};
+    REQUIRE(board.fits(square, 0, 0));
+    REQUIRE(board.fits(square, 8, 18));
+    REQUIRE_FALSE(board.fits(square, -1, 0));
+    REQUIRE_FALSE(board.fits(square, 9, 0));
+    REQUIRE_FALSE(board.fits(square, 0, 19));
+    // The empty column of an L's box may hang past the left wall.
+    const std::array<std::uint16_t, 3> ell = {0b010, 0b010, 0b110};
+    REQUIRE(board.fits(ell, -1, 0));
+    REQUIRE_FALSE(board.fits(ell, -2, 0));
+
+    const std::array<std::uint16_t, 1> bar = {0b1111};
+    board.place(square, 8, 18, 2);
+    board.place(bar, 0, 19, 1);
+    board.place(bar, 4, 19, 1);
+    board.place(bar, 0, 18, 3);
+    REQUIRE_FALSE(board.fits(square, 3, 17));
+    REQUIRE(board.row(19) == TetrisBoard::FULL_ROW);
+    REQUIRE(board.clearLines() == 1);
+    REQUIRE(board.row(19) == 0b1100001111);
+    REQUIRE(board.row(18) == 0);
+    REQUIRE(board.color(0, 19) == 3);
+    REQUIRE(board.color(9, 19) == 2);
+    REQUIRE(board.color(5, 19) == 0);
+
+    board.place(std::array<std::uint16_t, 1>{0b0011110000}, 0, 19, 4);
+    board.place(std::array<std::uint16_t, 2>{0b1, TetrisBoard::FULL_ROW}, 0, 17, 5);
+    REQUIRE(board.clearLines() == 2);
+    REQUIRE(board.row(19) == 0b1);
+    REQUIRE(board.color(0, 19) == 5);
+    REQUIRE(board.row(18) == 0);
+    board.reset();
+    REQUIRE(board.fits(std::array<std::uint16_t, 1>{TetrisBoard::FULL_ROW}, 0, 19));
+}
+
+TEST_CASE("External sort matches std::sort through several merge levels", "[external_sort]") {
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string input = (directory / "algovisualizer-external-in.bin").string();
+    const std::string output = (directory / "algovisualizer-external-out.bin").string();
+    for (const std::size_t size : {0u, 1000u, 200000u}) {
+        std::vector<int> data = generateData(DataSpec{.size = size, .seed = 3});
+        for (std::size_t i = 0; i < data.size(); i += 2) data[i] = -data[i];
+        std::ofstream(input, std::ios::binary).write(reinterpret_cast<const char*>(data.data()),
+                                                     static_cast<std::streamsize>(data.size() * sizeof(int)));
+
+        // 48 KiB of memory: runs of 4096 ints merged two at a time, so 200000 ints take six merge levels.
+        ExternalSortConfig config;
+        config.inputPath = input;
+        config.outputPath = output;
+        config.tempDirectory = directory.string();
+        config.memoryBytes = 48 << 10;
+        config.threads = 2;
+        ExternalSorter sorter(std::move(config));
+        sorter.sort();
+        REQUIRE(sorter.phase() == ExternalSorter::Phase::Done);
+        REQUIRE(sorter.row(sorter.rowCount() - 1).written == size);
+
+        std::vector<int> sorted(size);
+        std::ifstream(output, std::ios::binary).read(reinterpret_cast<char*>(sorted.data()),
+                                                     static_cast<std::streamsize>(size * sizeof(int)));
+        std::sort(data.begin(), data.end());
+        REQUIRE(sorted == data);
+        REQUIRE(std::filesystem::file_size(output) == size * sizeof(int));
+    }
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+}
+
+TEST_CASE("Snapshot buffer hands over whole snapshots, newest last", "[snapshot_buffer]") {
+    SnapshotBuffer<std::vector<int>> buffer;
+    constexpr int SNAPSHOTS = 20000;
+    std::jthread writer([&buffer] {
+        for (int i = 1; i <= SNAPSHOTS; ++i) {
+            buffer.back().assign(64, i);
+            buffer.publish();
+        }
+    });
+    int last = 0;
+    bool whole = true;
+    while (last < SNAPSHOTS) {
+        if (!buffer.update()) continue;
+        const auto& snapshot = buffer.front();
+        whole = whole && !snapshot.empty() &&
+                std::all_of(snapshot.begin(), snapshot.end(), [&](int value) { return value == snapshot.front(); });
+        REQUIRE(snapshot.front() > last);
+        last = snapshot.front();
+    }
+    REQUIRE(whole);
+    REQUIRE_FALSE(buffer.update());
+}
+
+TEST_CASE("Sort visualizer sorts direct and indirect element types by projection", "[sort_visualizer]") {
+    const std::vector<int> keys = generateData(DataSpec{.distribution = Distribution::FewUnique, .size = 300, .seed = 17});
+
+    SECTION("64-bit keys are sorted in place, descending") {
+        std::vector<std::int64_t> values(keys.begin(), keys.end());
+        using View = SortVisualizer<std::int64_t, std::ranges::greater>;
+        View view(values, View::Algorithm::Bubble);
+        STATIC_REQUIRE(View::DIRECT);
+        view.startSort();
+        view.finishSort();
+        std::ranges::sort(values, std::ranges::greater{});
+        REQUIRE(view.values() == values);
+        REQUIRE(std::ranges::is_sorted(view.barHeights(), std::ranges::greater{}));
+        REQUIRE(view.getEngine().swaps() > 0);
+    }
+
+    SECTION("Large records are sorted through indices, stably, by a member projection") {
+        struct Record {
+            std::int64_t key;
+            std::uint32_t id;
+            std::array<char, 52> payload;
+        };
+        std::vector<Record> records;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            records.push_back(Record{keys[i], static_cast<std::uint32_t>(i), {}});
+        }
+        using View = SortVisualizer<Record, std::ranges::less, std::int64_t Record::*>;
+        View view(records, View::Algorithm::Insertion, {}, &Record::key);
+        STATIC_REQUIRE_FALSE(View::DIRECT);
+        view.startSort();
+        while (view.running()) view.update();
+        std::ranges::stable_sort(records, {}, &Record::key);
+        REQUIRE(std::ranges::equal(view.values(), records, {}, &Record::id, &Record::id));
+        REQUIRE(std::ranges::is_sorted(view.barHeights()));
+        REQUIRE(view.barHeights().front() == 1);
+        REQUIRE(view.barHeights().back() == View::BAR_RESOLUTION);
+    }
+}
+
+TEST_CASE("Perf counters measure a run or fall back to timing only", "[perf_counters]") {
+    std::vector<int> data = generateData(DataSpec{.size = 1 << 18, .seed = 3});
+    const PerfSample sample = measurePerf([&] { std::sort(data.begin(), data.end()); });
+    REQUIRE(sample.seconds > 0.0);
+    const PerfCounters& counters = PerfCounters::forThisThread();
+    if (counters.available()) {
+        REQUIRE(sample.hasCounters());
+        if (counters.counts(PerfEvent::Instructions)) {
+            REQUIRE(*sample.count(PerfEvent::Instructions) > data.size());
+        }
+    } else {
+        REQUIRE_FALSE(sample.hasCounters());
+        REQUIRE_FALSE(counters.unavailableReason().empty());
+        REQUIRE(sample.summary().ends_with("timing only"));
+    }
+
+    PerfSample total;
+    total.counts[static_cast<std::size_t>(PerfEvent::Cycles)] = 100;
+    total.counts[static_cast<std::size_t>(PerfEvent::Instructions)] = 250;
+    REQUIRE(total.ipc() == Approx(2.5));
+    PerfSample cyclesOnly;
+    cyclesOnly.counts[static_cast<std::size_t>(PerfEvent::Cycles)] = 50;
+    total += cyclesOnly;
+    REQUIRE(total.count(PerfEvent::Cycles) == 150u);
+    REQUIRE_FALSE(total.count(PerfEvent::Instructions));
+    REQUIRE_FALSE(total.ipc());
+}
+
+TEST_CASE("Cache simulator evicts the least recently used line and counts hits per level", "[cache_simulator]") {
+    // Two sets of two 64-byte ways backed by a direct-mapped L2 of four sets.
+    CacheSimulator cache({{256, 64, 2}, {256, 64, 1}});
+    REQUIRE(cache.describe(0) == "L1 256 B 2-way");
+    // Lines 0, 2 and 4 all map to set 0 of L1.
+    REQUIRE(cache.access(0) == 2u);
+    REQUIRE(cache.access(63) == 0u);
+    REQUIRE(cache.access(2 * 64) == 2u);
+    REQUIRE(cache.access(0) == 0u);
+    // Line 2 is now the least recently used of the set, and line 4 takes its way.
+    REQUIRE(cache.access(4 * 64) == 2u);
+    REQUIRE(cache.access(0) == 0u);
+    // Line 2 left L1 but is still in L2.
+    REQUIRE(cache.access(2 * 64) == 1u);
+    // Line 1 maps to the other set of L1 and leaves set 0 alone.
+    REQUIRE(cache.access(64) == 2u);
+    REQUIRE(cache.access(0) == 0u);
+
+    REQUIRE(cache.lookups(0) == 9u);
+    REQUIRE(cache.hits(0) == 4u);
+    REQUIRE(cache.lookups(1) == 5u);
+    REQUIRE(cache.hits(1) == 1u);
+    REQUIRE(cache.hitRate(0) == Approx(4.0 / 9.0));
+
+    const std::vector<std::uint64_t> addresses = {0, 4 * 64, 2 * 64};
+    std::vector<std::uint8_t> outcomes(addresses.size());
+    cache.reset();
+    REQUIRE(cache.lookups(0) == 0u);
+    cache.access(addresses, outcomes);
+    REQUIRE(outcomes == std::vector<std::uint8_t>{2, 2, 2});
+
+    REQUIRE_THROWS_AS(CacheSimulator({}), std::invalid_argument);
+    REQUIRE_THROWS_AS(CacheSimulator({{3 * 64 * 2, 64, 2}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(CacheSimulator({{1024, 48, 2}}), std::invalid_argument);
+}
+
+TEST_CASE("Bar renderer ignores touched indices past the end of the array", "[bar_renderer]") {
+    // No SDL renderer is needed: columns are rasterized on the CPU, and without one no texture is created.
+    BarRenderer bars;
+    bars.setScreenDimensions(64, 32);
+    const std::vector<std::uint32_t> pastEnd = {16, 64, 1000, std::numeric_limits<std::uint32_t>::max()};
+    for (const std::size_t size : {16u, 64u, 1000u}) {
+        // 16 elements spread over several columns each; 64 and 1000 take the scaled path.
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        bars.setMaxValue(static_cast<int>(size));
+        bars.render(nullptr, values);
+        for (int frame = 0; frame < 3; ++frame) {
+            bars.touch({0, static_cast<std::uint32_t>(size - 1)});
+            bars.touch(pastEnd);
+            bars.touch(std::size_t{size});
+            bars.touch(std::numeric_limits<std::size_t>::max());
+            bars.render(nullptr, values);
+        }
+    }
+}
+#endif
@@ -0,0 +1,165 @@
+//
+// Created by daily on 19-10-26.
+//
+// Lets TetrisAI play one game of uniformly random pieces and reports how many placements its beam search scores
+// per second, with the lines it clears on the way. Every placement evaluated is one reachable resting place of a
+// piece put on a board, its full rows cleared and the result scored.
+//
+// With --simulate GAMES it instead steps a headless TetrisBatch of GAMES games with random placements for --steps
+// steps, once on one thread and once on --threads, and reports game steps per second and how that scales.
+//
+// usage: tetris_bench [--pieces 1000] [--beam 32] [--lookahead 2] [--threads 0] [--seed 1]
+//        tetris_bench --simulate 65536 [--steps 1000] [--threads 0] [--seed 1]
+//
+#include "TetrisAI.h"
+#include "TetrisBatch.h"
+#include "Piece.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fmt/core.h>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    struct GameOptions {
+        std::size_t pieces = 1000;
+        std::size_t lookahead = 2;
+        std::uint64_t seed = 1;
+    };
+
+    void playGame(const GameOptions& options, const TetrisAIConfig& config) {
+        TetrisAI ai(config);
+        fmt::print("{} worker thread(s)\n", ai.threads());
+        std::mt19937_64 random(options.seed);
+        std::uniform_int_distribution<int> types(0, piece_tables::TYPES - 1);
+        std::deque<int> queue;
+        for (std::size_t i = 0; i <= options.lookahead; ++i) queue.push_back(types(random));
+
+        TetrisBoard board;
+        std::size_t placed = 0;
+        int lines = 0;
+        std::uint64_t evaluated = 0;
+        bool toppedOut = false;
+        std::vector<int> pieces;
+        const PerfSample sample = measurePerf([&] {
+            while (placed < options.pieces) {
+                pieces.assign(queue.begin(), queue.end());
+                const std::optional<TetrisPlacement> placement = ai.plan(board.rowMasks(), pieces);
+                evaluated += ai.evaluated();
+                if (!placement) {
+                    toppedOut = true;
+                    break;
+                }
+                const Piece piece(queue.front(), placement->rotation, placement->x, placement->y);
+                board.place(piece.getRows(), piece.getX(), piece.getY(), static_cast<std::uint8_t>(piece.getType() + 1));
+                lines += board.clearLines();
+                ++placed;
+                queue.pop_front();
+                queue.push_back(types(random));
+            }
+        });
+        fmt::print("{} pieces placed, {} lines cleared{}\n", placed, lines, toppedOut ? ", topped out" : "");
+        fmt::print("{} placements evaluated in {:.3f} s: {:.2f} M/s, {:.0f} per piece, {:.3f} ms per piece\n", evaluated,
+                   sample.seconds, static_cast<double>(evaluated) / sample.seconds / 1e6,
+                   static_cast<double>(evaluated) / static_cast<double>(std::max<std::size_t>(placed, 1)),
+                   sample.seconds * 1e3 / static_cast<double>(std::max<std::size_t>(placed, 1)));
+        if (sample.hasCounters()) {
+            fmt::print("{}\n", sample.summary());
+        }
+    }
+
+    /**
+     * @brief Steps a batch of games with random actions.
+     * @return Game steps per second, counting only the time spent in TetrisBatch::step.
+     */
+    double simulate(std::size_t games, std::size_t steps, unsigned threads, std::uint64_t seed) {
+        TetrisBatch batch(TetrisBatchConfig{.games = games, .seed = seed, .threads = threads});
+        std::vector<std::uint8_t> actions(games);
+        std::vector<float> rewards(games);
+        std::vector<std::uint8_t> done(games);
+        std::uint64_t random = seed | 1;
+        std::uint64_t finished = 0;
+        double lines = 0.0;
+        std::chrono::steady_clock::duration stepping{};
+        for (std::size_t step = 0; step < steps; ++step) {
+            for (auto& action : actions) {
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                action = static_cast<std::uint8_t>((random >> 32) % TetrisBatch::ACTIONS);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            batch.step(actions, rewards, done);
+            stepping += std::chrono::steady_clock::now() - start;
+            for (std::size_t game = 0; game < games; ++game) {
+                finished += done[game];
+                lines += static_cast<double>(rewards[game]);
+            }
+        }
+        const double seconds = std::chrono::duration<double>(stepping).count();
+        const double rate = static_cast<double>(games * steps) / seconds;
+        fmt::print("{:>8} {:>10} {:>10} {:>12.2f} {:>12} {:>10.3f}\n", batch.threads(), games, steps, rate / 1e6,
+                   finished, lines / static_cast<double>(games * steps));
+        return rate;
+    }
+
+    int usage(const char* program) {
+        std::cerr << "usage: " << program << " [--pieces 1000] [--beam 32] [--lookahead 2] [--threads 0] [--seed 1]\n"
+                  << "       " << program << " --simulate 65536 [--steps 1000] [--threads 0] [--seed 1]\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    GameOptions options;
+    TetrisAIConfig config;
+    std::size_t simulateGames = 0;
+    std::size_t simulateSteps = 1000;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view option = argv[i];
+            if (i + 1 >= argc) return usage(argv[0]);
+            const std::string value = argv[++i];
+            if (option == "--pieces") {
+                options.pieces = std::stoul(value);
+            } else if (option == "--beam") {
+                config.beamWidth = std::stoul(value);
+            } else if (option == "--lookahead") {
+                options.lookahead = std::stoul(value);
+            } else if (option == "--threads") {
+                config.threads = static_cast<unsigned>(std::stoul(value));
+            } else if (option == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (option == "--simulate") {
+                simulateGames = std::stoul(value);
+            } else if (option == "--steps") {
+                simulateSteps = std::stoul(value);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+        if (simulateGames > 0) {
+            fmt::print("{:>8} {:>10} {:>10} {:>12} {:>12} {:>10}\n", "threads", "games", "steps", "Msteps/s",
+                       "games over", "lines/step");
+            const double single = simulate(simulateGames, simulateSteps, 1, options.seed);
+            if (config.threads != 1) {
+                const double parallel = simulate(simulateGames, simulateSteps, config.threads, options.seed);
+                fmt::print("speedup {:.2f}x\n", parallel / single);
+            }
+            return 0;
+        }
+        fmt::print("beam width {}, lookahead {} piece(s)\n", config.beamWidth, options.lookahead);
+        playGame(options, config);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    return 0;
+}